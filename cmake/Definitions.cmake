@@ -151,12 +151,17 @@ macro(configure_bin_names)
       "deskflow-legacy"
       CACHE STRING "Filename of the legacy binary")
 
+  set(TRACE_BINARY_NAME
+      "deskflow-trace"
+      CACHE STRING "Filename of the trace decoder binary")
+
   message(VERBOSE "GUI binary: ${GUI_BINARY_NAME}")
   message(VERBOSE "Server binary: ${SERVER_BINARY_NAME}")
   message(VERBOSE "Client binary: ${CLIENT_BINARY_NAME}")
   message(VERBOSE "Core binary: ${CORE_BINARY_NAME}")
   message(VERBOSE "Daemon binary: ${DAEMON_BINARY_NAME}")
   message(VERBOSE "Legacy binary: ${LEGACY_BINARY_NAME}")
+  message(VERBOSE "Trace binary: ${TRACE_BINARY_NAME}")
 
   add_definitions(-DGUI_BINARY_NAME="${GUI_BINARY_NAME}")
   add_definitions(-DSERVER_BINARY_NAME="${SERVER_BINARY_NAME}")
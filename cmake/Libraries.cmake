@@ -34,6 +34,7 @@ macro(configure_libs)
   configure_python()
   configure_qt()
   configure_openssl()
+  configure_zlib()
   configure_coverage()
 
   option(USE_TOMLPLUSPLUS "Use toml++" ON)
@@ -564,6 +565,11 @@ macro(configure_openssl)
   include_directories(${OPENSSL_INCLUDE_DIR})
 endmacro()
 
+macro(configure_zlib)
+  find_package(ZLIB REQUIRED)
+  include_directories(${ZLIB_INCLUDE_DIRS})
+endmacro()
+
 macro(configure_gtest)
 
   file(GLOB gtest_base_dir ${PROJECT_SOURCE_DIR}/subprojects/googletest-*)
@@ -70,6 +70,7 @@ install_debian_deps() {
     libx11-dev \
     libxtst-dev \
     libssl-dev \
+    zlib1g-dev \
     libglib2.0-dev \
     libgdk-pixbuf-2.0-dev \
     libnotify-dev \
@@ -116,6 +117,7 @@ install_fedora_deps() {
     gcc-c++ \
     rpm-build \
     openssl-devel \
+    zlib-devel \
     glib2-devel \
     gdk-pixbuf2-devel \
     libXtst-devel \
@@ -141,6 +143,7 @@ install_suse_deps() {
     gcc-c++ \
     rpm-build \
     libopenssl-devel \
+    zlib-devel \
     glib2-devel \
     gdk-pixbuf-devel \
     libXtst-devel \
@@ -164,6 +167,7 @@ install_arch_deps() {
     ninja \
     gcc \
     openssl \
+    zlib \
     glib2 \
     gdk-pixbuf2 \
     libxtst \
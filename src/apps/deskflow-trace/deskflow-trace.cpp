@@ -0,0 +1,74 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/Trace.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+void usage(const char *pname)
+{
+  std::cerr << "Usage: " << pname << " [--json] <trace-file>\n\n"
+            << "Decodes a trace file written by --trace to text, or to JSON with --json.\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+  bool json = false;
+  const char *filename = nullptr;
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--json") == 0) {
+      json = true;
+    } else if (filename == nullptr && argv[i][0] != '-') {
+      filename = argv[i];
+    } else {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if (filename == nullptr) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  std::ifstream file(filename, std::ios::binary);
+  if (!file.is_open()) {
+    std::cerr << "cannot open trace file: " << filename << std::endl;
+    return 1;
+  }
+
+  std::vector<TraceRecord> records;
+  if (!Trace::read(file, records)) {
+    std::cerr << "not a trace file, or unsupported version: " << filename << std::endl;
+    return 1;
+  }
+
+  if (json) {
+    Trace::writeJson(std::cout, records);
+  } else {
+    Trace::writeText(std::cout, records);
+  }
+
+  return 0;
+}
@@ -76,6 +76,17 @@ const auto kLightIconFile = ":/icons/64x64/tray-light.png";
 const auto kDarkIconFile = ":/icons/64x64/tray-dark.png";
 #endif // Q_OS_MAC
 
+// log lines are added to the view at most once per frame.
+const auto kLogFlushInterval = 16;
+
+// oldest lines are removed from the view beyond this many.
+const auto kLogMaxLines = 10000;
+
+// lines that can change the connection state, other lines are not parsed.
+const QRegularExpression kConnectionLineRegex("connect|process exited|unrecognised client name");
+
+const QRegularExpression kFingerprintRegex("server fingerprint: ([A-F0-9:]+)");
+
 //
 // Free functions
 //
@@ -107,7 +118,8 @@ MainWindow::MainWindow(Settings &configScopes, AppConfig &appConfig)
       m_ServerConnection(this, appConfig, m_ServerConfig, m_ServerConfigDialogState),
       m_ClientConnection(this, appConfig),
       m_TlsUtility(appConfig),
-      m_WindowSaveTimer(this)
+      m_WindowSaveTimer(this),
+      m_LogFlushTimer(this)
 {
 #ifdef DESKFLOW_GUI_HOOK_MAIN_WINDOW
   DESKFLOW_GUI_HOOK_MAIN_WINDOW
@@ -182,6 +194,10 @@ void MainWindow::setupControls()
 
   m_pLabelIpAddresses->setText(QString("This computer's IP addresses: %1").arg(getIPAddresses()));
 
+  m_pLogOutput->setMaximumBlockCount(kLogMaxLines);
+  m_LogFlushTimer.setSingleShot(true);
+  m_LogFlushTimer.setInterval(kLogFlushInterval);
+
   if (m_AppConfig.lastVersion() != kVersion) {
     m_AppConfig.setLastVersion(kVersion);
   }
@@ -264,6 +280,8 @@ void MainWindow::connectSlots()
 
   connect(&m_WindowSaveTimer, &QTimer::timeout, this, &MainWindow::onWindowSaveTimerTimeout);
 
+  connect(&m_LogFlushTimer, &QTimer::timeout, this, &MainWindow::onLogFlushTimerTimeout);
+
   connect(&m_TrayIcon, &TrayIcon::activated, this, &MainWindow::onTrayIconActivated);
 
   connect(
@@ -528,6 +546,11 @@ void MainWindow::onWindowSaveTimerTimeout()
   saveWindow();
 }
 
+void MainWindow::onLogFlushTimerTimeout()
+{
+  flushLogLines();
+}
+
 void MainWindow::onServerConnectionConfigureClient(const QString &clientName)
 {
   m_ServerConfigDialogState.setVisible(true);
@@ -698,6 +721,25 @@ void MainWindow::setIcon()
 
 void MainWindow::handleLogLine(const QString &line)
 {
+  // appending and scrolling per line is too slow when the core logs a lot,
+  // so lines are held back and added to the view in one go.
+  m_PendingLogLines.append(line);
+  if (!m_LogFlushTimer.isActive()) {
+    m_LogFlushTimer.start();
+  }
+}
+
+void MainWindow::flushLogLines()
+{
+  if (m_PendingLogLines.isEmpty()) {
+    return;
+  }
+
+  // take the lines first, as a dialog shown while parsing them will run the
+  // event loop and may flush again.
+  QStringList lines;
+  lines.swap(m_PendingLogLines);
+
   const int kScrollBottomThreshold = 2;
 
   QScrollBar *verticalScroll = m_pLogOutput->verticalScrollBar();
@@ -705,16 +747,28 @@ void MainWindow::handleLogLine(const QString &line)
   int maxScroll = verticalScroll->maximum();
   const auto scrollAtBottom = qAbs(currentScroll - maxScroll) <= kScrollBottomThreshold;
 
+  // lines that would be removed from the view straight away aren't added.
+  const auto first = qMax(0, static_cast<int>(lines.size()) - kLogMaxLines);
+
   // only trim end instead of the whole line to prevent tab-indented debug
   // filenames from losing their indentation.
-  m_pLogOutput->appendPlainText(trimEnd(line));
+  QString text;
+  for (auto i = first; i < lines.size(); i++) {
+    if (i > first) {
+      text.append('\n');
+    }
+    text.append(trimEnd(lines[i]));
+  }
+  m_pLogOutput->appendPlainText(text);
 
   if (scrollAtBottom) {
     verticalScroll->setValue(verticalScroll->maximum());
     m_pLogOutput->horizontalScrollBar()->setValue(0);
   }
 
-  updateFromLogLine(line);
+  for (const auto &line : std::as_const(lines)) {
+    updateFromLogLine(line);
+  }
 }
 
 void MainWindow::updateFromLogLine(const QString &line)
@@ -725,6 +779,10 @@ void MainWindow::updateFromLogLine(const QString &line)
 
 void MainWindow::checkConnected(const QString &line)
 {
+  if (!line.contains(kConnectionLineRegex)) {
+    return;
+  }
+
   if (m_pRadioGroupServer->isChecked()) {
     m_ServerConnection.handleLogLine(line);
     m_pLabelServerState->updateServerState(line);
@@ -736,8 +794,7 @@ void MainWindow::checkConnected(const QString &line)
 
 void MainWindow::checkFingerprint(const QString &line)
 {
-  QRegularExpression re(".*server fingerprint: ([A-F0-9:]+)");
-  auto match = re.match(line);
+  auto match = kFingerprintRegex.match(line);
   if (!match.hasMatch()) {
     return;
   }
@@ -118,6 +118,7 @@ private slots:
   void onVersionCheckerUpdateFound(const QString &version);
   void onTrayIconActivated(QSystemTrayIcon::ActivationReason reason);
   void onWindowSaveTimerTimeout();
+  void onLogFlushTimerTimeout();
   void onServerConnectionConfigureClient(const QString &clientName);
 
   //
@@ -177,6 +178,7 @@ private:
   void connectSlots();
   void updateWindowTitle();
   void handleLogLine(const QString &line);
+  void flushLogLines();
   void updateLocalFingerprint();
   void updateScreenName();
   void saveSettings();
@@ -219,4 +221,6 @@ private:
   deskflow::gui::ClientConnection m_ClientConnection;
   deskflow::gui::TlsUtility m_TlsUtility;
   QTimer m_WindowSaveTimer;
+  QTimer m_LogFlushTimer;
+  QStringList m_PendingLogLines;
 };
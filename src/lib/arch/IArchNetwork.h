@@ -222,6 +222,30 @@ public:
   */
   virtual size_t writeSocket(ArchSocket s, const void *buf, size_t len) = 0;
 
+  //! Read a datagram from socket
+  /*!
+  Like \c readSocket() but for a datagram socket, also returning the
+  sender's address in \c addr.  Returns 0 and sets \c addr to NULL
+  if no datagram is queued.  The caller must delete the address.
+  */
+  virtual size_t readSocketFrom(ArchSocket s, void *buf, size_t len, ArchNetAddress *addr) = 0;
+
+  //! Write a datagram to an address
+  /*!
+  Sends \c len bytes from \c buf to \c addr as a single datagram and
+  returns the number of bytes sent, which is 0 if the datagram was
+  dropped because the internal buffers are full.
+  */
+  virtual size_t writeSocketTo(ArchSocket s, const void *buf, size_t len, ArchNetAddress addr) = 0;
+
+  //! Get the local address of a socket
+  /*!
+  Returns the address \c s is bound to.  For an accepted socket this is
+  the address the peer connected to.  The caller must delete the
+  address.
+  */
+  virtual ArchNetAddress getSocketAddr(ArchSocket s) = 0;
+
   //! Check error on socket
   /*!
   If the socket \c s is in an error state then throws an appropriate
@@ -32,10 +32,15 @@
 #include <time.h>
 #endif
 #endif
+#include <atomic>
 #include <cerrno>
+#include <sched.h>
 
 #define SIGWAKEUP SIGUSR1
 
+// how many times cancelThread() broadcasts to a waiting thread
+static const int kWakeAttempts = 1000;
+
 #if !HAVE_PTHREAD_SIGNAL
 // boy, is this platform broken.  forget about pthread signal
 // handling and let signals through to every process.  deskflow
@@ -66,13 +71,20 @@ public:
   ArchThreadImpl();
 
 public:
-  int m_refCount;
+  std::atomic<int> m_refCount;
   IArchMultithread::ThreadID m_id;
   pthread_t m_thread;
   IArchMultithread::ThreadFunc m_func;
   void *m_userData;
-  bool m_cancel;
+  std::atomic<bool> m_cancel;
   bool m_cancelling;
+
+  // the condition variable the thread is waiting on, the number of waits
+  // it has finished and how many threads are trying to wake it.  these
+  // are read without the thread list lock.
+  std::atomic<ArchCondImpl *> m_waitCond;
+  std::atomic<unsigned int> m_waits;
+  std::atomic<int> m_wakers;
   bool m_exited;
   void *m_result;
   void *m_networkData;
@@ -85,6 +97,9 @@ ArchThreadImpl::ArchThreadImpl()
       m_userData(NULL),
       m_cancel(false),
       m_cancelling(false),
+      m_waitCond(NULL),
+      m_waits(0),
+      m_wakers(0),
       m_exited(false),
       m_result(NULL),
       m_networkData(NULL)
@@ -98,6 +113,9 @@ ArchThreadImpl::ArchThreadImpl()
 
 ArchMultithreadPosix *ArchMultithreadPosix::s_instance = NULL;
 
+// the calling thread, so it can be found without locking the thread list
+static thread_local ArchThreadImpl *t_currentThread = NULL;
+
 ArchMultithreadPosix::ArchMultithreadPosix() : m_newThreadCalled(false), m_nextID(0)
 {
   assert(s_instance == NULL);
@@ -118,6 +136,7 @@ ArchMultithreadPosix::ArchMultithreadPosix() : m_newThreadCalled(false), m_nextI
   m_mainThread = new ArchThreadImpl;
   m_mainThread->m_thread = pthread_self();
   insert(m_mainThread);
+  t_currentThread = m_mainThread;
 
   // install SIGWAKEUP handler.  this causes SIGWAKEUP to interrupt
   // system calls.  we use that when cancelling a thread to force it
@@ -150,14 +169,14 @@ ArchMultithreadPosix::~ArchMultithreadPosix()
   assert(s_instance != NULL);
 
   closeMutex(m_threadMutex);
+  t_currentThread = NULL;
   s_instance = NULL;
 }
 
 void ArchMultithreadPosix::setNetworkDataForCurrentThread(void *data)
 {
   lockMutex(m_threadMutex);
-  ArchThreadImpl *thread = find(pthread_self());
-  thread->m_networkData = data;
+  t_currentThread->m_networkData = data;
   unlockMutex(m_threadMutex);
 }
 
@@ -207,42 +226,52 @@ void ArchMultithreadPosix::broadcastCondVar(ArchCond cond)
 
 bool ArchMultithreadPosix::waitCondVar(ArchCond cond, ArchMutex mutex, double timeout)
 {
-  // we can't wait on a condition variable and also wake it up for
-  // cancellation since we don't use posix cancellation.  so we
-  // must wake up periodically to check for cancellation.  we
-  // can't simply go back to waiting after the check since the
-  // condition may have changed and we'll have lost the signal.
-  // so we have to return to the caller.  since the caller will
-  // always check for spurious wakeups the only drawback here is
-  // performance:  we're waking up a lot more than desired.
-  static const double maxCancellationLatency = 0.1;
-  if (timeout < 0.0 || timeout > maxCancellationLatency) {
-    timeout = maxCancellationLatency;
-  }
+  ArchThreadImpl *self = t_currentThread;
 
   // see if we should cancel this thread
-  testCancelThread();
-
-  // get final time
-  struct timeval now;
-  gettimeofday(&now, NULL);
-  struct timespec finalTime;
-  finalTime.tv_sec = now.tv_sec;
-  finalTime.tv_nsec = now.tv_usec * 1000;
-  long timeout_sec = (long)timeout;
-  long timeout_nsec = (long)(1.0e+9 * (timeout - timeout_sec));
-  finalTime.tv_sec += timeout_sec;
-  finalTime.tv_nsec += timeout_nsec;
-  if (finalTime.tv_nsec >= 1000000000) {
-    finalTime.tv_nsec -= 1000000000;
-    finalTime.tv_sec += 1;
+  testCancelThreadImpl(self);
+
+  // we don't use posix cancellation, so tell cancelThread() which
+  // condition variable to broadcast to wake us up.  it sets the cancel
+  // flag before it looks, so either we see the flag or it sees this.
+  self->m_waitCond = cond;
+
+  int status = 0;
+  if (!self->m_cancel) {
+    if (timeout < 0.0) {
+      status = pthread_cond_wait(&cond->m_cond, &mutex->m_mutex);
+    } else {
+      // get final time
+      struct timeval now;
+      gettimeofday(&now, NULL);
+      struct timespec finalTime;
+      finalTime.tv_sec = now.tv_sec;
+      finalTime.tv_nsec = now.tv_usec * 1000;
+      long timeout_sec = (long)timeout;
+      long timeout_nsec = (long)(1.0e+9 * (timeout - timeout_sec));
+      finalTime.tv_sec += timeout_sec;
+      finalTime.tv_nsec += timeout_nsec;
+      if (finalTime.tv_nsec >= 1000000000) {
+        finalTime.tv_nsec -= 1000000000;
+        finalTime.tv_sec += 1;
+      }
+
+      // wait
+      status = pthread_cond_timedwait(&cond->m_cond, &mutex->m_mutex, &finalTime);
+    }
   }
 
-  // wait
-  int status = pthread_cond_timedwait(&cond->m_cond, &mutex->m_mutex, &finalTime);
+  // a cancelling thread may still be broadcasting the condition variable,
+  // and the caller may destroy it once we return.  it stops as soon as it
+  // sees the wait is over.
+  self->m_waitCond = NULL;
+  ++self->m_waits;
+  while (self->m_wakers > 0) {
+    sched_yield();
+  }
 
   // check for cancel again
-  testCancelThread();
+  testCancelThreadImpl(self);
 
   switch (status) {
   case 0:
@@ -376,10 +405,11 @@ ArchThread ArchMultithreadPosix::newThread(ThreadFunc func, void *data)
 
 ArchThread ArchMultithreadPosix::newCurrentThread()
 {
-  lockMutex(m_threadMutex);
-  ArchThreadImpl *thread = find(pthread_self());
-  unlockMutex(m_threadMutex);
+  // the thread holds a reference to itself while it runs, so it's safe
+  // to add one without the thread list lock
+  ArchThreadImpl *thread = t_currentThread;
   assert(thread != NULL);
+  ++thread->m_refCount;
   return thread;
 }
 
@@ -424,8 +454,10 @@ void ArchMultithreadPosix::cancelThread(ArchThread thread)
   }
   unlockMutex(m_threadMutex);
 
-  // force thread to exit system calls if wakeup is true
+  // force thread to exit system calls and condition variable waits if
+  // wakeup is true
   if (wakeup) {
+    wakeThread(thread);
     pthread_kill(thread->m_thread, SIGWAKEUP);
   }
 }
@@ -439,23 +471,16 @@ void ArchMultithreadPosix::setPriorityOfThread(ArchThread thread, int /*n*/)
 
 void ArchMultithreadPosix::testCancelThread()
 {
-  // find current thread
-  lockMutex(m_threadMutex);
-  ArchThreadImpl *thread = findNoRef(pthread_self());
-  unlockMutex(m_threadMutex);
-
-  // test cancel on thread
-  testCancelThreadImpl(thread);
+  testCancelThreadImpl(t_currentThread);
 }
 
 bool ArchMultithreadPosix::wait(ArchThread target, double timeout)
 {
   assert(target != NULL);
 
-  lockMutex(m_threadMutex);
+  ArchThreadImpl *self = t_currentThread;
 
-  // find current thread
-  ArchThreadImpl *self = findNoRef(pthread_self());
+  lockMutex(m_threadMutex);
 
   // ignore wait if trying to wait on ourself
   if (target == self) {
@@ -538,14 +563,20 @@ void ArchMultithreadPosix::setSignalHandler(ESignal signal, SignalFunc func, voi
 
 void ArchMultithreadPosix::raiseSignal(ESignal signal)
 {
+  bool cancel = false;
   lockMutex(m_threadMutex);
   if (m_signalFunc[signal] != NULL) {
     m_signalFunc[signal](signal, m_signalUserData[signal]);
     pthread_kill(m_mainThread->m_thread, SIGWAKEUP);
   } else if (signal == kINTERRUPT || signal == kTERMINATE) {
-    ARCH->cancelThread(m_mainThread);
+    cancel = true;
   }
   unlockMutex(m_threadMutex);
+
+  // cancelThread() takes the thread mutex itself
+  if (cancel) {
+    ARCH->cancelThread(m_mainThread);
+  }
 }
 
 void ArchMultithreadPosix::startSignalHandler()
@@ -573,15 +604,6 @@ void ArchMultithreadPosix::startSignalHandler()
   }
 }
 
-ArchThreadImpl *ArchMultithreadPosix::find(pthread_t thread)
-{
-  ArchThreadImpl *impl = findNoRef(thread);
-  if (impl != NULL) {
-    refThread(impl);
-  }
-  return impl;
-}
-
 ArchThreadImpl *ArchMultithreadPosix::findNoRef(pthread_t thread)
 {
   // linear search
@@ -627,6 +649,28 @@ void ArchMultithreadPosix::refThread(ArchThreadImpl *thread)
   ++thread->m_refCount;
 }
 
+void ArchMultithreadPosix::wakeThread(ArchThreadImpl *thread)
+{
+  // the thread won't return from its wait while we use the condition
+  // variable
+  ++thread->m_wakers;
+  ArchCond cond = thread->m_waitCond;
+  if (cond != NULL) {
+    // we don't lock the waiter's mutex since the caller may hold it, or
+    // its holder may be waiting on the caller.  without it the thread
+    // may have missed the cancel flag but not be waiting yet, and miss a
+    // broadcast too.  it holds the mutex until it waits, so broadcast
+    // until its wait is over.  if someone else holds the mutex then the
+    // thread is already waiting and returns once it gets the mutex.
+    const unsigned int waits = thread->m_waits;
+    for (int i = 0; i < kWakeAttempts && thread->m_waits == waits; ++i) {
+      broadcastCondVar(cond);
+      sched_yield();
+    }
+  }
+  --thread->m_wakers;
+}
+
 void ArchMultithreadPosix::testCancelThreadImpl(ArchThreadImpl *thread)
 {
   assert(thread != NULL);
@@ -651,6 +695,7 @@ void *ArchMultithreadPosix::threadFunc(void *vrep)
 {
   // get the thread
   ArchThreadImpl *thread = static_cast<ArchThreadImpl *>(vrep);
+  t_currentThread = thread;
 
   // setup pthreads
   pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
@@ -92,13 +92,13 @@ public:
 private:
   void startSignalHandler();
 
-  ArchThreadImpl *find(pthread_t thread);
   ArchThreadImpl *findNoRef(pthread_t thread);
   void insert(ArchThreadImpl *thread);
   void erase(ArchThreadImpl *thread);
 
   void refThread(ArchThreadImpl *rep);
   void testCancelThreadImpl(ArchThreadImpl *rep);
+  void wakeThread(ArchThreadImpl *rep);
 
   void doThreadFunc(ArchThread thread);
   static void *threadFunc(void *vrep);
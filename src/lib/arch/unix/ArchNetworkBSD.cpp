@@ -409,6 +409,57 @@ size_t ArchNetworkBSD::writeSocket(ArchSocket s, const void *buf, size_t len)
   return n;
 }
 
+size_t ArchNetworkBSD::readSocketFrom(ArchSocket s, void *buf, size_t len, ArchNetAddress *addr)
+{
+  assert(s != NULL);
+  assert(addr != NULL);
+
+  *addr = new ArchNetAddressImpl;
+  auto addrLen = (*addr)->m_len;
+  ssize_t n = recvfrom(s->m_fd, buf, len, 0, TYPED_ADDR(struct sockaddr, (*addr)), &addrLen);
+  (*addr)->m_len = addrLen;
+  if (n == -1) {
+    int err = errno;
+    delete *addr;
+    *addr = nullptr;
+    if (err == EINTR || err == EAGAIN) {
+      return 0;
+    }
+    throwError(err);
+  }
+  return n;
+}
+
+size_t ArchNetworkBSD::writeSocketTo(ArchSocket s, const void *buf, size_t len, ArchNetAddress addr)
+{
+  assert(s != NULL);
+  assert(addr != NULL);
+
+  ssize_t n = sendto(s->m_fd, buf, len, 0, TYPED_ADDR(struct sockaddr, addr), addr->m_len);
+  if (n == -1) {
+    if (errno == EINTR || errno == EAGAIN || errno == ENOBUFS) {
+      return 0;
+    }
+    throwError(errno);
+  }
+  return n;
+}
+
+ArchNetAddress ArchNetworkBSD::getSocketAddr(ArchSocket s)
+{
+  assert(s != NULL);
+
+  auto *addr = new ArchNetAddressImpl;
+  auto len = addr->m_len;
+  if (getsockname(s->m_fd, TYPED_ADDR(struct sockaddr, addr), &len) == -1) {
+    int err = errno;
+    delete addr;
+    throwError(err);
+  }
+  addr->m_len = len;
+  return addr;
+}
+
 void ArchNetworkBSD::throwErrorOnSocket(ArchSocket s)
 {
   assert(s != NULL);
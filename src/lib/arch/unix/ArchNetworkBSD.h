@@ -114,6 +114,9 @@ public:
   void unblockPollSocket(ArchThread thread) override;
   size_t readSocket(ArchSocket s, void *buf, size_t len) override;
   size_t writeSocket(ArchSocket s, const void *buf, size_t len) override;
+  size_t readSocketFrom(ArchSocket s, void *buf, size_t len, ArchNetAddress *addr) override;
+  size_t writeSocketTo(ArchSocket s, const void *buf, size_t len, ArchNetAddress addr) override;
+  ArchNetAddress getSocketAddr(ArchSocket s) override;
   void throwErrorOnSocket(ArchSocket) override;
   bool setNoDelayOnSocket(ArchSocket, bool noDelay) override;
   bool setReuseAddrOnSocket(ArchSocket, bool reuse) override;
@@ -38,6 +38,7 @@ static int(PASCAL FAR *close_winsock)(SOCKET s);
 static int(PASCAL FAR *connect_winsock)(SOCKET s, const struct sockaddr FAR *name, int namelen);
 static int(PASCAL FAR *gethostname_winsock)(char FAR *name, int namelen);
 static int(PASCAL FAR *getsockerror_winsock)(void);
+static int(PASCAL FAR *getsockname_winsock)(SOCKET s, struct sockaddr FAR *name, int FAR *namelen);
 static int(PASCAL FAR *getsockopt_winsock)(SOCKET s, int level, int optname, void FAR *optval, int FAR *optlen);
 static u_short(PASCAL FAR *htons_winsock)(u_short v);
 static char FAR *(PASCAL FAR *inet_ntoa_winsock)(struct in_addr in);
@@ -46,10 +47,16 @@ static int(PASCAL FAR *ioctl_winsock)(SOCKET s, int cmd, void FAR *data);
 static int(PASCAL FAR *listen_winsock)(SOCKET s, int backlog);
 static u_short(PASCAL FAR *ntohs_winsock)(u_short v);
 static int(PASCAL FAR *recv_winsock)(SOCKET s, void FAR *buf, int len, int flags);
+static int(PASCAL FAR *recvfrom_winsock)(
+    SOCKET s, void FAR *buf, int len, int flags, struct sockaddr FAR *from, int FAR *fromlen
+);
 static int(PASCAL FAR *select_winsock)(
     int nfds, fd_set FAR *readfds, fd_set FAR *writefds, fd_set FAR *exceptfds, const struct timeval FAR *timeout
 );
 static int(PASCAL FAR *send_winsock)(SOCKET s, const void FAR *buf, int len, int flags);
+static int(PASCAL FAR *sendto_winsock)(
+    SOCKET s, const void FAR *buf, int len, int flags, const struct sockaddr FAR *to, int tolen
+);
 static int(PASCAL FAR *setsockopt_winsock)(SOCKET s, int level, int optname, const void FAR *optval, int optlen);
 static int(PASCAL FAR *shutdown_winsock)(SOCKET s, int how);
 static SOCKET(PASCAL FAR *socket_winsock)(int af, int type, int protocol);
@@ -167,6 +174,7 @@ void ArchNetworkWinsock::initModule(HMODULE module)
   setfunc(connect_winsock, connect, int(PASCAL FAR *)(SOCKET s, const struct sockaddr FAR *name, int namelen));
   setfunc(gethostname_winsock, gethostname, int(PASCAL FAR *)(char FAR *name, int namelen));
   setfunc(getsockerror_winsock, WSAGetLastError, int(PASCAL FAR *)(void));
+  setfunc(getsockname_winsock, getsockname, int(PASCAL FAR *)(SOCKET s, struct sockaddr FAR * name, int FAR *namelen));
   setfunc(
       getsockopt_winsock, getsockopt,
       int(PASCAL FAR *)(SOCKET s, int level, int optname, void FAR *optval, int FAR *optlen)
@@ -178,6 +186,10 @@ void ArchNetworkWinsock::initModule(HMODULE module)
   setfunc(listen_winsock, listen, int(PASCAL FAR *)(SOCKET s, int backlog));
   setfunc(ntohs_winsock, ntohs, u_short(PASCAL FAR *)(u_short v));
   setfunc(recv_winsock, recv, int(PASCAL FAR *)(SOCKET s, void FAR *buf, int len, int flags));
+  setfunc(
+      recvfrom_winsock, recvfrom,
+      int(PASCAL FAR *)(SOCKET s, void FAR *buf, int len, int flags, struct sockaddr FAR *from, int FAR *fromlen)
+  );
   setfunc(
       select_winsock, select,
       int(PASCAL FAR *)(
@@ -185,6 +197,10 @@ void ArchNetworkWinsock::initModule(HMODULE module)
       )
   );
   setfunc(send_winsock, send, int(PASCAL FAR *)(SOCKET s, const void FAR *buf, int len, int flags));
+  setfunc(
+      sendto_winsock, sendto,
+      int(PASCAL FAR *)(SOCKET s, const void FAR *buf, int len, int flags, const struct sockaddr FAR *to, int tolen)
+  );
   setfunc(
       setsockopt_winsock, setsockopt,
       int(PASCAL FAR *)(SOCKET s, int level, int optname, const void FAR *optval, int optlen)
@@ -573,6 +589,56 @@ size_t ArchNetworkWinsock::writeSocket(ArchSocket s, const void *buf, size_t len
   return static_cast<size_t>(n);
 }
 
+size_t ArchNetworkWinsock::readSocketFrom(ArchSocket s, void *buf, size_t len, ArchNetAddress *addr)
+{
+  assert(s != NULL);
+  assert(addr != NULL);
+
+  ArchNetAddress tmp = ArchNetAddressImpl::alloc(sizeof(struct sockaddr_in6));
+  int n = recvfrom_winsock(s->m_socket, buf, (int)len, 0, TYPED_ADDR(struct sockaddr, tmp), &tmp->m_len);
+  if (n == SOCKET_ERROR) {
+    int err = getsockerror_winsock();
+    free(tmp);
+    *addr = NULL;
+    if (err == WSAEINTR || err == WSAEWOULDBLOCK || err == WSAECONNRESET) {
+      // WSAECONNRESET is an icmp port unreachable for an earlier send
+      return 0;
+    }
+    throwError(err);
+  }
+  *addr = tmp;
+  return static_cast<size_t>(n);
+}
+
+size_t ArchNetworkWinsock::writeSocketTo(ArchSocket s, const void *buf, size_t len, ArchNetAddress addr)
+{
+  assert(s != NULL);
+  assert(addr != NULL);
+
+  int n = sendto_winsock(s->m_socket, buf, (int)len, 0, TYPED_ADDR(struct sockaddr, addr), addr->m_len);
+  if (n == SOCKET_ERROR) {
+    int err = getsockerror_winsock();
+    if (err == WSAEINTR || err == WSAEWOULDBLOCK) {
+      return 0;
+    }
+    throwError(err);
+  }
+  return static_cast<size_t>(n);
+}
+
+ArchNetAddress ArchNetworkWinsock::getSocketAddr(ArchSocket s)
+{
+  assert(s != NULL);
+
+  ArchNetAddress addr = ArchNetAddressImpl::alloc(sizeof(struct sockaddr_in6));
+  if (getsockname_winsock(s->m_socket, TYPED_ADDR(struct sockaddr, addr), &addr->m_len) == SOCKET_ERROR) {
+    int err = getsockerror_winsock();
+    free(addr);
+    throwError(err);
+  }
+  return addr;
+}
+
 void ArchNetworkWinsock::throwErrorOnSocket(ArchSocket s)
 {
   assert(s != NULL);
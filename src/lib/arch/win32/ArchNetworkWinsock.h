@@ -81,6 +81,9 @@ public:
   virtual void unblockPollSocket(ArchThread thread);
   virtual size_t readSocket(ArchSocket s, void *buf, size_t len);
   virtual size_t writeSocket(ArchSocket s, const void *buf, size_t len);
+  virtual size_t readSocketFrom(ArchSocket s, void *buf, size_t len, ArchNetAddress *addr);
+  virtual size_t writeSocketTo(ArchSocket s, const void *buf, size_t len, ArchNetAddress addr);
+  virtual ArchNetAddress getSocketAddr(ArchSocket s);
   virtual void throwErrorOnSocket(ArchSocket);
   virtual bool setNoDelayOnSocket(ArchSocket, bool noDelay);
   virtual bool setReuseAddrOnSocket(ArchSocket, bool reuse);
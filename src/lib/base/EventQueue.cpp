@@ -200,8 +200,9 @@ bool EventQueue::getEvent(Event &event, double timeout)
 retry:
   // if no events are waiting then handle timers and then wait
   while (m_buffer->isEmpty()) {
-    // handle timers first
-    if (hasTimerExpired(event)) {
+    // handle timers first.  both timer checks use the same time.
+    const double now = m_time.getTime();
+    if (hasTimerExpired(event, now)) {
       return true;
     }
 
@@ -214,7 +215,7 @@ retry:
     // get time until next timer expires.  if there is a timer
     // and it'll expire before the client's timeout then use
     // that duration for our timeout instead.
-    double timerTimeout = getNextTimerTimeout();
+    double timerTimeout = getNextTimerTimeout(now);
     if (timeout < 0.0 || (timerTimeout >= 0.0 && timerTimeout < timeLeft)) {
       timeLeft = timerTimeout;
     }
@@ -312,11 +313,7 @@ EventQueueTimer *EventQueue::newTimer(double duration, void *target)
     target = timer;
   }
   ArchMutexLock lock(m_mutex);
-  m_timers.insert(timer);
-  // initial duration is requested duration plus whatever's on
-  // the clock currently because the latter will be subtracted
-  // the next time we check for timers.
-  m_timerQueue.push(Timer(timer, duration, duration + m_time.getTime(), target, false));
+  m_timerQueue.push(Timer(timer, duration, m_time.getTime() + duration, target, false));
   return timer;
 }
 
@@ -329,27 +326,14 @@ EventQueueTimer *EventQueue::newOneShotTimer(double duration, void *target)
     target = timer;
   }
   ArchMutexLock lock(m_mutex);
-  m_timers.insert(timer);
-  // initial duration is requested duration plus whatever's on
-  // the clock currently because the latter will be subtracted
-  // the next time we check for timers.
-  m_timerQueue.push(Timer(timer, duration, duration + m_time.getTime(), target, true));
+  m_timerQueue.push(Timer(timer, duration, m_time.getTime() + duration, target, true));
   return timer;
 }
 
 void EventQueue::deleteTimer(EventQueueTimer *timer)
 {
   ArchMutexLock lock(m_mutex);
-  for (TimerQueue::iterator index = m_timerQueue.begin(); index != m_timerQueue.end(); ++index) {
-    if (index->getTimer() == timer) {
-      m_timerQueue.erase(index);
-      break;
-    }
-  }
-  Timers::iterator index = m_timers.find(timer);
-  if (index != m_timers.end()) {
-    m_timers.erase(index);
-  }
+  m_timerQueue.erase(timer);
   m_buffer->deleteTimer(timer);
 }
 
@@ -403,7 +387,7 @@ void EventQueue::removeHandlers(void *target)
 
 bool EventQueue::isEmpty() const
 {
-  return (m_buffer->isEmpty() && getNextTimerTimeout() != 0.0);
+  return (m_buffer->isEmpty() && getNextTimerTimeout(m_time.getTime()) != 0.0);
 }
 
 IEventJob *EventQueue::getHandler(Event::Type type, void *target) const
@@ -456,58 +440,43 @@ Event EventQueue::removeEvent(UInt32 eventID)
   return event;
 }
 
-bool EventQueue::hasTimerExpired(Event &event)
+bool EventQueue::hasTimerExpired(Event &event, double now)
 {
-  // return true if there's a timer in the timer priority queue that
-  // has expired.  if returning true then fill in event appropriately
-  // and reset and reinsert the timer.
-  if (m_timerQueue.empty()) {
-    return false;
-  }
-
-  // get time elapsed since last check
-  const double time = m_time.getTime();
-  m_time.reset();
-
-  // countdown elapsed time
-  for (TimerQueue::iterator index = m_timerQueue.begin(); index != m_timerQueue.end(); ++index) {
-    (*index) -= time;
-  }
-
-  // done if no timers are expired
-  if (m_timerQueue.top() > 0.0) {
+  // return true if there's a timer in the timer queue that has expired
+  // at time now.  if returning true then fill in event appropriately
+  // and reschedule or remove the timer.
+  if (m_timerQueue.empty() || m_timerQueue.top().getDeadline() > now) {
     return false;
   }
 
-  // remove timer from queue
+  // prepare event
   Timer timer = m_timerQueue.top();
-  m_timerQueue.pop();
-
-  // prepare event and reset the timer's clock
-  timer.fillEvent(m_timerEvent);
+  timer.fillEvent(m_timerEvent, now);
   event = Event(Event::kTimer, timer.getTarget(), &m_timerEvent);
-  timer.reset();
 
-  // reinsert timer into queue if it's not a one-shot
-  if (!timer.isOneShot()) {
-    m_timerQueue.push(timer);
+  // reschedule the timer in place if it's not a one-shot
+  if (timer.isOneShot()) {
+    m_timerQueue.pop();
+  } else {
+    timer.reset(now);
+    m_timerQueue.replaceTop(timer);
   }
 
   return true;
 }
 
-double EventQueue::getNextTimerTimeout() const
+double EventQueue::getNextTimerTimeout(double now) const
 {
   // return -1 if no timers, 0 if the top timer has expired, otherwise
-  // the time until the top timer in the timer priority queue will
-  // expire.
+  // the time until the top timer in the timer queue will expire.
   if (m_timerQueue.empty()) {
     return -1.0;
   }
-  if (m_timerQueue.top() <= 0.0) {
+  const double timeout = m_timerQueue.top().getDeadline() - now;
+  if (timeout <= 0.0) {
     return 0.0;
   }
-  return m_timerQueue.top();
+  return timeout;
 }
 
 Event::Type EventQueue::getRegisteredType(const String &name) const
@@ -541,12 +510,12 @@ void EventQueue::waitForReady() const
 // EventQueue::Timer
 //
 
-EventQueue::Timer::Timer(EventQueueTimer *timer, double timeout, double initialTime, void *target, bool oneShot)
+EventQueue::Timer::Timer(EventQueueTimer *timer, double timeout, double deadline, void *target, bool oneShot)
     : m_timer(timer),
       m_timeout(timeout),
       m_target(target),
       m_oneShot(oneShot),
-      m_time(initialTime)
+      m_deadline(deadline)
 {
   assert(m_timeout > 0.0);
 }
@@ -556,20 +525,9 @@ EventQueue::Timer::~Timer()
   // do nothing
 }
 
-void EventQueue::Timer::reset()
-{
-  m_time = m_timeout;
-}
-
-EventQueue::Timer &EventQueue::Timer::operator-=(double dt)
-{
-  m_time -= dt;
-  return *this;
-}
-
-EventQueue::Timer::operator double() const
+void EventQueue::Timer::reset(double now)
 {
-  return m_time;
+  m_deadline = now + m_timeout;
 }
 
 bool EventQueue::Timer::isOneShot() const
@@ -587,16 +545,124 @@ void *EventQueue::Timer::getTarget() const
   return m_target;
 }
 
-void EventQueue::Timer::fillEvent(TimerEvent &event) const
+double EventQueue::Timer::getDeadline() const
+{
+  return m_deadline;
+}
+
+void EventQueue::Timer::fillEvent(TimerEvent &event, double now) const
 {
   event.m_timer = m_timer;
   event.m_count = 0;
-  if (m_time <= 0.0) {
-    event.m_count = static_cast<UInt32>((m_timeout - m_time) / m_timeout);
+  if (m_deadline <= now) {
+    event.m_count = static_cast<UInt32>((m_timeout + now - m_deadline) / m_timeout);
   }
 }
 
 bool EventQueue::Timer::operator<(const Timer &t) const
 {
-  return m_time < t.m_time;
+  return m_deadline < t.m_deadline;
+}
+
+//
+// EventQueue::TimerQueue
+//
+
+bool EventQueue::TimerQueue::empty() const
+{
+  return m_heap.empty();
+}
+
+const EventQueue::Timer &EventQueue::TimerQueue::top() const
+{
+  return m_heap.front();
+}
+
+void EventQueue::TimerQueue::push(const Timer &timer)
+{
+  m_heap.push_back(timer);
+  m_index[timer.getTimer()] = m_heap.size() - 1;
+  siftUp(m_heap.size() - 1);
+}
+
+void EventQueue::TimerQueue::pop()
+{
+  remove(0);
+}
+
+void EventQueue::TimerQueue::replaceTop(const Timer &timer)
+{
+  assert(timer.getTimer() == m_heap.front().getTimer());
+  m_heap.front() = timer;
+  siftDown(0);
+}
+
+bool EventQueue::TimerQueue::erase(EventQueueTimer *timer)
+{
+  auto index = m_index.find(timer);
+  if (index == m_index.end()) {
+    return false;
+  }
+  remove(index->second);
+  return true;
+}
+
+void EventQueue::TimerQueue::remove(size_t index)
+{
+  m_index.erase(m_heap[index].getTimer());
+
+  // fill the hole with the last timer and move that where it belongs
+  const size_t last = m_heap.size() - 1;
+  if (index != last) {
+    place(index, m_heap[last]);
+  }
+  m_heap.pop_back();
+  if (index != last) {
+    if (index > 0 && m_heap[index] < m_heap[(index - 1) / 2]) {
+      siftUp(index);
+    } else {
+      siftDown(index);
+    }
+  }
+}
+
+void EventQueue::TimerQueue::siftUp(size_t index)
+{
+  const Timer timer = m_heap[index];
+  while (index > 0) {
+    const size_t parent = (index - 1) / 2;
+    if (!(timer < m_heap[parent])) {
+      break;
+    }
+    place(index, m_heap[parent]);
+    index = parent;
+  }
+  place(index, timer);
+}
+
+void EventQueue::TimerQueue::siftDown(size_t index)
+{
+  const Timer timer = m_heap[index];
+  const size_t size = m_heap.size();
+  while (true) {
+    size_t child = 2 * index + 1;
+    if (child >= size) {
+      break;
+    }
+    if (child + 1 < size && m_heap[child + 1] < m_heap[child]) {
+      ++child;
+    }
+    if (!(m_heap[child] < timer)) {
+      break;
+    }
+    place(index, m_heap[child]);
+    index = child;
+  }
+  place(index, timer);
+}
+
+void EventQueue::TimerQueue::place(size_t index, const Timer &timer)
+{
+  m_heap[index] = timer;
+  m_index[timer.getTimer()] = index;
 }
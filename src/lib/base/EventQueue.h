@@ -22,13 +22,13 @@
 #include "base/Event.h"
 #include "base/EventTypes.h"
 #include "base/IEventQueue.h"
-#include "base/PriorityQueue.h"
 #include "base/Stopwatch.h"
 #include "common/stdmap.h"
-#include "common/stdset.h"
+#include "common/stdvector.h"
 #include "mt/CondVar.h"
 
 #include <queue>
+#include <unordered_map>
 
 class Mutex;
 
@@ -70,27 +70,24 @@ public:
 private:
   UInt32 saveEvent(const Event &event);
   Event removeEvent(UInt32 eventID);
-  bool hasTimerExpired(Event &event);
-  double getNextTimerTimeout() const;
+  bool hasTimerExpired(Event &event, double now);
+  double getNextTimerTimeout(double now) const;
   void addEventToBuffer(const Event &event);
 
 private:
   class Timer
   {
   public:
-    Timer(EventQueueTimer *, double timeout, double initialTime, void *target, bool oneShot);
+    Timer(EventQueueTimer *, double timeout, double deadline, void *target, bool oneShot);
     ~Timer();
 
-    void reset();
-
-    Timer &operator-=(double);
-
-    operator double() const;
+    void reset(double now);
 
     bool isOneShot() const;
     EventQueueTimer *getTimer() const;
     void *getTarget() const;
-    void fillEvent(TimerEvent &) const;
+    double getDeadline() const;
+    void fillEvent(TimerEvent &, double now) const;
 
     bool operator<(const Timer &) const;
 
@@ -99,11 +96,32 @@ private:
     double m_timeout;
     void *m_target;
     bool m_oneShot;
-    double m_time;
+    double m_deadline;
+  };
+
+  // a heap of timers ordered by deadline that also knows where each
+  // timer is, so a timer can be removed without searching for it
+  class TimerQueue
+  {
+  public:
+    bool empty() const;
+    const Timer &top() const;
+
+    void push(const Timer &);
+    void pop();
+    void replaceTop(const Timer &);
+    bool erase(EventQueueTimer *);
+
+  private:
+    void remove(size_t index);
+    void siftUp(size_t index);
+    void siftDown(size_t index);
+    void place(size_t index, const Timer &);
+
+    std::vector<Timer> m_heap;
+    std::unordered_map<EventQueueTimer *, size_t> m_index;
   };
 
-  typedef std::set<EventQueueTimer *> Timers;
-  typedef PriorityQueue<Timer> TimerQueue;
   typedef std::map<UInt32, Event> EventTable;
   typedef std::vector<UInt32> EventIDList;
   typedef std::map<Event::Type, const char *> TypeMap;
@@ -126,9 +144,8 @@ private:
   EventTable m_events;
   EventIDList m_oldEventIDs;
 
-  // timers
+  // timers.  deadlines are times on m_time, which is never reset.
   Stopwatch m_time;
-  Timers m_timers;
   TimerQueue m_timerQueue;
   TimerEvent m_timerEvent;
 
@@ -44,6 +44,7 @@ REGISTER_EVENT(Client, connected)
 REGISTER_EVENT(Client, connectionFailed)
 REGISTER_EVENT(Client, connectionRefused)
 REGISTER_EVENT(Client, disconnected)
+REGISTER_EVENT(Client, resolved)
 
 //
 // IStream
@@ -141,6 +142,7 @@ REGISTER_EVENT(Server, screenSwitched)
 //
 
 REGISTER_EVENT(ServerApp, reloadConfig)
+REGISTER_EVENT(ServerApp, configRead)
 REGISTER_EVENT(ServerApp, forceReconnect)
 REGISTER_EVENT(ServerApp, resetServer)
 
@@ -190,6 +192,7 @@ REGISTER_EVENT(IpcServer, messageReceived)
 
 REGISTER_EVENT(Clipboard, clipboardGrabbed)
 REGISTER_EVENT(Clipboard, clipboardChanged)
+REGISTER_EVENT(Clipboard, clipboardRequested)
 REGISTER_EVENT(Clipboard, clipboardSending)
 
 //
@@ -75,6 +75,14 @@ public:
   */
   Event::Type disconnected();
 
+  //! Get resolved event type
+  /*!
+  Returns the resolved event type.  This is sent by the client to
+  itself when the lookup of the server's hostname has finished.  The
+  event data is private to the client.
+  */
+  Event::Type resolved();
+
   //@}
 
 private:
@@ -82,6 +90,7 @@ private:
   Event::Type m_connectionFailed = Event::kUnknown;
   Event::Type m_connectionRefused = Event::kUnknown;
   Event::Type m_disconnected = Event::kUnknown;
+  Event::Type m_resolved = Event::kUnknown;
 };
 
 class IStreamEvents : public EventTypes
@@ -543,7 +552,11 @@ private:
 class ServerAppEvents : public EventTypes
 {
 public:
-  ServerAppEvents() : m_reloadConfig(Event::kUnknown), m_forceReconnect(Event::kUnknown), m_resetServer(Event::kUnknown)
+  ServerAppEvents()
+      : m_reloadConfig(Event::kUnknown),
+        m_configRead(Event::kUnknown),
+        m_forceReconnect(Event::kUnknown),
+        m_resetServer(Event::kUnknown)
   {
   }
 
@@ -551,6 +564,13 @@ public:
   //@{
 
   Event::Type reloadConfig();
+
+  //! Get config read event type
+  /*!
+  Sent when the configuration being reloaded has been read.
+  */
+  Event::Type configRead();
+
   Event::Type forceReconnect();
   Event::Type resetServer();
 
@@ -558,6 +578,7 @@ public:
 
 private:
   Event::Type m_reloadConfig;
+  Event::Type m_configRead;
   Event::Type m_forceReconnect;
   Event::Type m_resetServer;
 };
@@ -723,6 +744,7 @@ public:
   ClipboardEvents()
       : m_clipboardGrabbed(Event::kUnknown),
         m_clipboardChanged(Event::kUnknown),
+        m_clipboardRequested(Event::kUnknown),
         m_clipboardSending(Event::kUnknown)
   {
   }
@@ -746,6 +768,15 @@ public:
   */
   Event::Type clipboardChanged();
 
+  //! Get clipboard requested event type
+  /*!
+  Returns the clipboard requested event type.  This is sent when an
+  application asks for clipboard formats that were deferred when the
+  clipboard was set.  The data is a pointer to a
+  IScreen::ClipboardRequestInfo.
+  */
+  Event::Type clipboardRequested();
+
   //! Clipboard sending event type
   /*!
   Returns the clipboard sending event type. This is used to send
@@ -758,6 +789,7 @@ public:
 private:
   Event::Type m_clipboardGrabbed;
   Event::Type m_clipboardChanged;
+  Event::Type m_clipboardRequested;
   Event::Type m_clipboardSending;
 };
 
@@ -29,6 +29,8 @@
 #include <iostream>
 
 const int kPriorityPrefixLength = 3;
+const int kTimeStringSize = 50;
+const int kInitBufferSize = 1024;
 
 // names of priorities
 static const char *g_priority[] = {"FATAL",  "ERROR",  "WARNING", "NOTE",   "INFO",  "DEBUG",
@@ -64,13 +66,21 @@ ELevel getPriority(const char *&fmt)
   return static_cast<ELevel>(fmt[2] - '0');
 }
 
-void makeTimeString(std::vector<char> &buffer)
+// returns the current local time, formatted once per second per thread.
+const char *makeTimeString()
 {
   const int yearOffset = 1900;
   const int monthOffset = 1;
 
+  thread_local time_t cachedTime = -1;
+  thread_local char cachedString[kTimeStringSize] = {};
+
   time_t t;
   time(&t);
+  if (t == cachedTime) {
+    return cachedString;
+  }
+
   struct tm tm;
 
 #if WINAPI_MSWINDOWS
@@ -80,46 +90,75 @@ void makeTimeString(std::vector<char> &buffer)
 #endif
 
   snprintf(
-      buffer.data(), buffer.size(), "%04i-%02i-%02iT%02i:%02i:%02i", tm.tm_year + yearOffset, tm.tm_mon + monthOffset,
-      tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec
+      cachedString, sizeof(cachedString), "%04i-%02i-%02iT%02i:%02i:%02i", tm.tm_year + yearOffset,
+      tm.tm_mon + monthOffset, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec
   );
+  cachedTime = t;
+  return cachedString;
 }
 
-std::vector<char> makeMessage(const char *filename, int lineNumber, const char *message, ELevel priority)
+// per-thread buffer that messages are formatted into, reused across calls.
+std::vector<char> &messageBuffer()
 {
+  thread_local std::vector<char> buffer(kInitBufferSize);
+  return buffer;
+}
 
-  // base size includes null terminator, colon, space, etc.
-  const int baseSize = 10;
-
-  const int timeBufferSize = 50;
-  const int priorityMaxSize = 10;
+// set while the thread's buffer holds a message that's being output.
+thread_local bool t_messageBufferInUse = false;
 
-  std::vector<char> timeBuffer(timeBufferSize);
-  makeTimeString(timeBuffer);
+// marks the thread's buffer in use for as long as it's in scope.
+class MessageBufferLock
+{
+public:
+  MessageBufferLock() : m_wasInUse(t_messageBufferInUse)
+  {
+    t_messageBufferInUse = true;
+  }
+  MessageBufferLock(MessageBufferLock const &) = delete;
+  MessageBufferLock &operator=(MessageBufferLock const &) = delete;
+  ~MessageBufferLock()
+  {
+    t_messageBufferInUse = m_wasInUse;
+  }
 
-  size_t timestampLength = strnlen(timeBuffer.data(), timeBufferSize);
-  size_t priorityLength = strnlen(g_priority[priority], priorityMaxSize);
-  size_t messageLength = strnlen(message, SIZE_MAX);
-  size_t bufferSize = baseSize + timestampLength + priorityLength + messageLength;
+private:
+  bool m_wasInUse;
+};
 
-  const auto filenameSet = filename != nullptr && filename[0] != '\0';
-  if (filenameSet) {
-    size_t filenameLength = strnlen(filename, SIZE_MAX);
-    size_t lineNumberLength = snprintf(nullptr, 0, "%d", lineNumber);
-    bufferSize += filenameLength + lineNumberLength;
+// appends printf-style output at offset, growing the buffer as needed.
+// returns the new length of the string in the buffer.
+size_t vappendFormat(std::vector<char> &buffer, size_t offset, const char *fmt, va_list args)
+{
+  va_list argsCopy;
+  va_copy(argsCopy, args);
+  int n = vsnprintf(buffer.data() + offset, buffer.size() - offset, fmt, argsCopy);
+  va_end(argsCopy);
+
+  if (n < 0) {
+    buffer[offset] = '\0';
+    return offset;
+  }
 
-    std::vector<char> buffer(bufferSize);
-    snprintf(
-        buffer.data(), bufferSize, "[%s] %s: %s\n\t%s:%d", timeBuffer.data(), g_priority[priority], message, filename,
-        lineNumber
-    );
-    return buffer;
-  } else {
-    std::vector<char> buffer(bufferSize);
-    snprintf(buffer.data(), bufferSize, "[%s] %s: %s", timeBuffer.data(), g_priority[priority], message);
-    return buffer;
+  if (offset + n >= buffer.size()) {
+    buffer.resize(offset + n + 1);
+    va_copy(argsCopy, args);
+    vsnprintf(buffer.data() + offset, buffer.size() - offset, fmt, argsCopy);
+    va_end(argsCopy);
   }
+
+  return offset + n;
+}
+
+size_t appendFormat(std::vector<char> &buffer, size_t offset, const char *fmt, ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  offset = vappendFormat(buffer, offset, fmt, args);
+  va_end(args);
+  return offset;
 }
+
 } // namespace
 
 //
@@ -184,9 +223,6 @@ const char *Log::getFilterName(int level) const
 
 void Log::print(const char *file, int line, const char *fmt, ...)
 {
-  const int initBufferSize = 1024;
-  const int bufferResizeScale = 2;
-
   ELevel priority = getPriority(fmt);
   fmt += kPriorityPrefixLength;
 
@@ -194,29 +230,33 @@ void Log::print(const char *file, int line, const char *fmt, ...)
     return;
   }
 
-  std::vector<char> buffer(initBufferSize);
-  auto length = static_cast<int>(buffer.size());
-
-  while (true) {
-    va_list args;
-    va_start(args, fmt);
-    int n = vsnprintf(buffer.data(), length, fmt, args);
-    va_end(args);
+  // format straight into a reused per-thread buffer, so that logging
+  // doesn't allocate once the buffer has grown to fit typical messages.
+  // a message logged by an outputter while it writes this one gets a
+  // buffer of its own, so it doesn't overwrite this one.
+  std::vector<char> nestedBuffer;
+  if (t_messageBufferInUse) {
+    nestedBuffer.resize(kInitBufferSize);
+  }
+  auto &buffer = t_messageBufferInUse ? nestedBuffer : messageBuffer();
+  MessageBufferLock bufferLock;
+  size_t length = 0;
 
-    if (n < 0 || n > length) {
-      length *= bufferResizeScale;
-      buffer.resize(length);
-    } else {
-      break;
-    }
+  if (priority != kPRINT) {
+    length = appendFormat(buffer, length, "[%s] %s: ", makeTimeString(), g_priority[priority]);
   }
 
-  if (priority == kPRINT) {
-    output(priority, buffer.data());
-  } else {
-    auto message = makeMessage(file, line, buffer.data(), priority);
-    output(priority, message.data());
+  va_list args;
+  va_start(args, fmt);
+  length = vappendFormat(buffer, length, fmt, args);
+  va_end(args);
+
+  const auto filenameSet = file != nullptr && file[0] != '\0';
+  if (priority != kPRINT && filenameSet) {
+    appendFormat(buffer, length, "\n\t%s:%d", file, line);
   }
+
+  output(priority, buffer.data());
 }
 
 void Log::insert(ILogOutputter *outputter, bool alwaysAtHead)
@@ -275,17 +315,15 @@ bool Log::setFilter(const char *maxPriority)
 
 void Log::setFilter(int maxPriority)
 {
-  ArchMutexLock lock(m_mutex);
   m_maxPriority = maxPriority;
 }
 
 int Log::getFilter() const
 {
-  ArchMutexLock lock(m_mutex);
   return m_maxPriority;
 }
 
-void Log::output(ELevel priority, char *msg)
+void Log::output(ELevel priority, const char *msg)
 {
   assert(priority >= -1 && priority < g_numPriority);
   assert(msg != NULL);
@@ -23,6 +23,7 @@
 #include "common/common.h"
 #include "common/stdlist.h"
 
+#include <atomic>
 #include <stdarg.h>
 
 #define CLOG (Log::getInstance())
@@ -133,7 +134,7 @@ public:
   //@}
 
 private:
-  void output(ELevel priority, char *msg);
+  void output(ELevel priority, const char *msg);
 
 private:
   typedef std::list<ILogOutputter *> OutputterList;
@@ -143,7 +144,7 @@ private:
   ArchMutex m_mutex;
   OutputterList m_outputters;
   OutputterList m_alwaysOutputters;
-  int m_maxPriority;
+  std::atomic<int> m_maxPriority;
 };
 
 /*!
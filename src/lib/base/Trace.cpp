@@ -0,0 +1,361 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/Trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+#if SYSAPI_UNIX
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const std::size_t kMaxThreads = 256;
+const std::uint32_t kFileVersion = 1;
+const char kFileMagic[8] = {'D', 'F', 'T', 'R', 'A', 'C', 'E', '\0'};
+
+// names of events, indexed by TraceEvent
+const char *const g_eventNames[] = {
+    "none", "server-mouse-move-secondary", "client-proxy-mouse-move", "socket-read", "socket-write",
+    "server-proxy-mouse-move", "fake-mouse-move"
+};
+
+static_assert(
+    sizeof(g_eventNames) / sizeof(g_eventNames[0]) == static_cast<std::size_t>(TraceEvent::kCount),
+    "missing trace event name"
+);
+
+struct TraceFileHeader
+{
+  char m_magic[8];
+  std::uint32_t m_version;
+  std::uint32_t m_recordSize;
+};
+
+//! Single writer ring of trace records, owned by one thread
+class TraceRing
+{
+public:
+  TraceRing(std::size_t capacity, std::uint32_t thread)
+      : m_records(new TraceRecord[capacity]()),
+        m_capacity(capacity),
+        m_thread(thread)
+  {
+  }
+
+  void push(TraceEvent event, std::int32_t arg0, std::int32_t arg1, std::int32_t arg2, std::int32_t arg3)
+  {
+    const auto now = std::chrono::system_clock::now().time_since_epoch();
+    const std::uint64_t head = m_head.load(std::memory_order_relaxed);
+
+    TraceRecord &record = m_records[head & (m_capacity - 1)];
+    record.m_time = std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+    record.m_thread = m_thread;
+    record.m_event = static_cast<std::uint16_t>(event);
+    record.m_args[0] = arg0;
+    record.m_args[1] = arg1;
+    record.m_args[2] = arg2;
+    record.m_args[3] = arg3;
+
+    m_head.store(head + 1, std::memory_order_release);
+  }
+
+  // total number of records written, the ring holds the newest of them.
+  std::uint64_t getHead() const
+  {
+    return m_head.load(std::memory_order_acquire);
+  }
+
+  const TraceRecord *getRecords() const
+  {
+    return m_records.get();
+  }
+
+  std::size_t getCapacity() const
+  {
+    return m_capacity;
+  }
+
+  void clear()
+  {
+    m_head.store(0, std::memory_order_release);
+  }
+
+private:
+  std::unique_ptr<TraceRecord[]> m_records;
+  std::size_t m_capacity;
+  std::uint32_t m_thread;
+  std::atomic<std::uint64_t> m_head{0};
+};
+
+// rings are never freed, so that the events of threads that have exited
+// are still dumped, and so the crash handler can read them without locking.
+std::atomic<TraceRing *> g_rings[kMaxThreads];
+std::atomic<std::size_t> g_ringCount{0};
+std::size_t g_ringCapacity = Trace::kDefaultRecordsPerThread;
+std::string g_filename;
+
+thread_local TraceRing *t_ring = nullptr;
+
+TraceRing *getRing()
+{
+  if (t_ring == nullptr) {
+    const std::size_t index = g_ringCount.fetch_add(1);
+    if (index >= kMaxThreads) {
+      return nullptr;
+    }
+
+    t_ring = new TraceRing(g_ringCapacity, static_cast<std::uint32_t>(index));
+    g_rings[index].store(t_ring, std::memory_order_release);
+  }
+  return t_ring;
+}
+
+// writes the header and the rings using only the given write function,
+// which must be async signal safe when called from the crash handler.
+template <typename WriteFunc> void writeRings(WriteFunc write)
+{
+  TraceFileHeader header = {};
+  memcpy(header.m_magic, kFileMagic, sizeof(header.m_magic));
+  header.m_version = kFileVersion;
+  header.m_recordSize = sizeof(TraceRecord);
+  write(&header, sizeof(header));
+
+  const std::size_t count = std::min(g_ringCount.load(), kMaxThreads);
+  for (std::size_t i = 0; i < count; ++i) {
+    const TraceRing *ring = g_rings[i].load(std::memory_order_acquire);
+    if (ring == nullptr) {
+      continue;
+    }
+
+    const std::uint64_t head = ring->getHead();
+    const std::size_t capacity = ring->getCapacity();
+    const std::size_t used = head < capacity ? static_cast<std::size_t>(head) : capacity;
+    const std::size_t start = static_cast<std::size_t>((head - used) & (capacity - 1));
+
+    // oldest records up to the end of the buffer, then the wrapped part.
+    const std::size_t firstPart = std::min(used, capacity - start);
+    write(ring->getRecords() + start, firstPart * sizeof(TraceRecord));
+    write(ring->getRecords(), (used - firstPart) * sizeof(TraceRecord));
+  }
+}
+
+#if SYSAPI_UNIX
+
+const int g_crashSignals[] = {SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT};
+const std::size_t kNumCrashSignals = sizeof(g_crashSignals) / sizeof(g_crashSignals[0]);
+
+// the handlers that were installed before ours
+struct sigaction g_oldActions[kNumCrashSignals];
+
+void crashHandler(int signal)
+{
+  // only async signal safe calls from here on.
+  int fd = open(g_filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd >= 0) {
+    writeRings([fd](const void *data, std::size_t size) {
+      auto bytes = static_cast<const char *>(data);
+      while (size > 0) {
+        ssize_t n = ::write(fd, bytes, size);
+        if (n <= 0) {
+          break;
+        }
+        bytes += n;
+        size -= static_cast<std::size_t>(n);
+      }
+    });
+    close(fd);
+  }
+
+  // the handler was reset on entry, so this crashes as before.
+  raise(signal);
+}
+
+void installCrashHandler()
+{
+  struct sigaction action = {};
+  action.sa_handler = &crashHandler;
+  action.sa_flags = SA_RESETHAND;
+  sigemptyset(&action.sa_mask);
+
+  for (std::size_t i = 0; i < kNumCrashSignals; ++i) {
+    sigaction(g_crashSignals[i], &action, &g_oldActions[i]);
+  }
+}
+
+void uninstallCrashHandler()
+{
+  for (std::size_t i = 0; i < kNumCrashSignals; ++i) {
+    sigaction(g_crashSignals[i], &g_oldActions[i], nullptr);
+  }
+}
+
+#else
+
+void installCrashHandler()
+{
+  // not supported, events are only written by Trace::dump()
+}
+
+void uninstallCrashHandler()
+{
+  // nothing was installed
+}
+
+#endif
+
+} // namespace
+
+//
+// Trace
+//
+
+std::atomic<bool> Trace::s_enabled{false};
+
+void Trace::enable(const std::string &filename, std::size_t recordsPerThread)
+{
+  if (isEnabled()) {
+    return;
+  }
+
+  // rings are indexed by masking, so the capacity must be a power of two.
+  g_ringCapacity = 1;
+  while (g_ringCapacity < recordsPerThread) {
+    g_ringCapacity <<= 1;
+  }
+
+  g_filename = filename;
+  installCrashHandler();
+  s_enabled = true;
+}
+
+void Trace::disable()
+{
+  if (!isEnabled()) {
+    return;
+  }
+
+  s_enabled = false;
+  uninstallCrashHandler();
+
+  const std::size_t count = std::min(g_ringCount.load(), kMaxThreads);
+  for (std::size_t i = 0; i < count; ++i) {
+    if (TraceRing *ring = g_rings[i].load(std::memory_order_acquire); ring != nullptr) {
+      ring->clear();
+    }
+  }
+}
+
+void Trace::record(TraceEvent event, std::int32_t arg0, std::int32_t arg1, std::int32_t arg2, std::int32_t arg3)
+{
+  if (TraceRing *ring = getRing(); ring != nullptr) {
+    ring->push(event, arg0, arg1, arg2, arg3);
+  }
+}
+
+bool Trace::dump()
+{
+  if (!isEnabled()) {
+    return false;
+  }
+
+  std::ofstream file(g_filename, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    return false;
+  }
+
+  writeRings([&file](const void *data, std::size_t size) {
+    file.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+  });
+  return file.good();
+}
+
+bool Trace::read(std::istream &stream, std::vector<TraceRecord> &records)
+{
+  TraceFileHeader header;
+  if (!stream.read(reinterpret_cast<char *>(&header), sizeof(header))) {
+    return false;
+  }
+
+  if (memcmp(header.m_magic, kFileMagic, sizeof(kFileMagic)) != 0 || header.m_version != kFileVersion ||
+      header.m_recordSize != sizeof(TraceRecord)) {
+    return false;
+  }
+
+  TraceRecord record;
+  while (stream.read(reinterpret_cast<char *>(&record), sizeof(record))) {
+    // skip unused slots and records torn by a concurrent write.
+    if (record.m_event == 0 || record.m_event >= static_cast<std::uint16_t>(TraceEvent::kCount)) {
+      continue;
+    }
+    records.push_back(record);
+  }
+
+  std::stable_sort(records.begin(), records.end(), [](const TraceRecord &a, const TraceRecord &b) {
+    return a.m_time < b.m_time;
+  });
+  return true;
+}
+
+void Trace::writeText(std::ostream &stream, const std::vector<TraceRecord> &records)
+{
+  if (records.empty()) {
+    return;
+  }
+
+  // times are relative to the first record, in microseconds.
+  const std::uint64_t start = records.front().m_time;
+  for (const auto &record : records) {
+    const auto offset = static_cast<double>(record.m_time - start) / 1000.0;
+    stream << std::fixed;
+    stream.precision(3);
+    stream << record.m_time << " +" << offset << "us thread=" << record.m_thread << " "
+           << getEventName(record.m_event);
+    for (auto arg : record.m_args) {
+      stream << " " << arg;
+    }
+    stream << "\n";
+  }
+}
+
+void Trace::writeJson(std::ostream &stream, const std::vector<TraceRecord> &records)
+{
+  stream << "[";
+  for (std::size_t i = 0; i < records.size(); ++i) {
+    const auto &record = records[i];
+    stream << (i == 0 ? "\n" : ",\n");
+    stream << "  {\"time\": " << record.m_time << ", \"thread\": " << record.m_thread << ", \"event\": \""
+           << getEventName(record.m_event) << "\", \"args\": [" << record.m_args[0] << ", " << record.m_args[1] << ", "
+           << record.m_args[2] << ", " << record.m_args[3] << "]}";
+  }
+  stream << "\n]\n";
+}
+
+const char *Trace::getEventName(std::uint16_t event)
+{
+  if (event >= static_cast<std::uint16_t>(TraceEvent::kCount)) {
+    return "unknown";
+  }
+  return g_eventNames[event];
+}
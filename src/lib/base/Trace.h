@@ -0,0 +1,161 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+//! Trace event identifiers
+/*!
+Identifies the hook point that wrote a trace record.  The values are
+stored in trace files, so new events must only be appended.
+*/
+enum class TraceEvent : std::uint16_t
+{
+  kNone,
+  kServerMouseMoveSecondary, //!< Server got relative motion on a secondary screen (dx, dy)
+  kClientProxyMouseMove,     //!< Server sent absolute motion to a client (x, y)
+  kSocketRead,               //!< Socket read from the network (bytes)
+  kSocketWrite,              //!< Socket wrote to the network (bytes, bytes left)
+  kServerProxyMouseMove,     //!< Client got absolute motion from the server (x, y, ignored)
+  kFakeMouseMove,            //!< Client injected absolute motion into the OS (x, y)
+  kCount
+};
+
+//! Binary trace record
+/*!
+Fixed size record written by \c TRACE().  Trace files contain these
+records verbatim, in native byte order.
+*/
+struct TraceRecord
+{
+  std::uint64_t m_time;    //!< Wall clock time in nanoseconds since the epoch
+  std::uint32_t m_thread;  //!< Trace thread number, in order of first use
+  std::uint16_t m_event;   //!< A \c TraceEvent value
+  std::uint16_t m_padding; //!< Unused, always zero
+  std::int32_t m_args[4];  //!< Event specific arguments
+};
+
+static_assert(sizeof(TraceRecord) == 32, "trace record size is part of the file format");
+
+//! Low overhead binary event tracing
+/*!
+Records fixed size events into a per-thread ring buffer without locking
+or formatting, so that tracing can be left on in the field to measure
+input latency without the cost of DEBUG2 text logging.  Only the most
+recent records of each thread are kept.  The rings are written to the
+trace file by \c dump(), and also if the process crashes on platforms
+that support it.  Trace files are decoded offline with the trace tool.
+
+Tracing is disabled by default, in which case \c TRACE() costs a
+single relaxed atomic load.
+*/
+class Trace
+{
+public:
+  //! @name manipulators
+  //@{
+
+  //! Enable tracing
+  /*!
+  Starts recording events, keeping up to \p recordsPerThread records for
+  each thread (rounded up to a power of two).  Records are written to
+  \p filename when \c dump() is called or the process crashes.  Calling
+  this more than once has no effect.
+  */
+  static void enable(const std::string &filename, std::size_t recordsPerThread = kDefaultRecordsPerThread);
+
+  //! Disable tracing
+  /*!
+  Stops recording events, discards the recorded ones and restores the
+  crash signal handlers that \c enable() replaced.  The rings of threads
+  that have already recorded events keep their size if tracing is
+  enabled again.
+  */
+  static void disable();
+
+  //! Record an event
+  /*!
+  Appends a record to the calling thread's ring.  Use \c TRACE() rather
+  than calling this directly, so that nothing is evaluated when tracing
+  is disabled.
+  */
+  static void record(
+      TraceEvent event, std::int32_t arg0 = 0, std::int32_t arg1 = 0, std::int32_t arg2 = 0, std::int32_t arg3 = 0
+  );
+
+  //! Write the recorded events to the trace file
+  /*!
+  Returns false if tracing isn't enabled or the file can't be written.
+  Records being written by other threads during the dump may be torn;
+  the decoder discards records it doesn't recognize.
+  */
+  static bool dump();
+
+  //@}
+  //! @name accessors
+  //@{
+
+  //! Returns true if tracing is enabled
+  static bool isEnabled()
+  {
+    return s_enabled.load(std::memory_order_relaxed);
+  }
+
+  //! Read the records from a trace file
+  /*!
+  Returns false if \p stream isn't a trace file of a known version.
+  Records are returned in time order.
+  */
+  static bool read(std::istream &stream, std::vector<TraceRecord> &records);
+
+  //! Write records as text, one per line
+  static void writeText(std::ostream &stream, const std::vector<TraceRecord> &records);
+
+  //! Write records as a JSON array
+  static void writeJson(std::ostream &stream, const std::vector<TraceRecord> &records);
+
+  //! Get the name of a trace event
+  static const char *getEventName(std::uint16_t event);
+
+  //@}
+
+  static const std::size_t kDefaultRecordsPerThread = 16384;
+
+private:
+  static std::atomic<bool> s_enabled;
+};
+
+//! Record a trace event
+/*!
+Records \c event with up to four integer arguments if tracing is
+enabled, otherwise does nothing and doesn't evaluate the arguments:
+\code
+TRACE(TraceEvent::kClientProxyMouseMove, x, y);
+\endcode
+*/
+#define TRACE(...)                                                                                                     \
+  do {                                                                                                                 \
+    if (Trace::isEnabled()) {                                                                                          \
+      Trace::record(__VA_ARGS__);                                                                                      \
+    }                                                                                                                  \
+  } while (0)
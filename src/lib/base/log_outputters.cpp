@@ -21,11 +21,14 @@
 #include "base/Path.h"
 #include "base/TMethodJob.h"
 
+#include <cstring>
 #include <fstream>
 
 enum EFileLogOutputter
 {
-  kFileSizeLimit = 1024 // kb
+  kFileSizeLimit = 1024,   // kb
+  kBufferSizeLimit = 4096, // kb
+  kBufferInitialSize = 64  // kb
 };
 
 //
@@ -214,52 +217,202 @@ bool BufferedLogOutputter::write(ELevel, const char *message)
 //
 
 FileLogOutputter::FileLogOutputter(const char *logFile)
+    : m_fileSize(0),
+      m_droppedCount(0),
+      m_running(false),
+      m_writerThread(nullptr),
+      m_bufferMutex(ARCH->newMutex()),
+      m_bufferCond(ARCH->newCondVar()),
+      m_fileMutex(ARCH->newMutex())
 {
   setLogFilename(logFile);
+
+  // reserve up front so that appending a line doesn't allocate.
+  m_buffer.reserve(kBufferInitialSize * 1024);
+  m_writeBuffer.reserve(kBufferInitialSize * 1024);
 }
 
 FileLogOutputter::~FileLogOutputter()
 {
+  close();
+
+  ARCH->closeMutex(m_fileMutex);
+  ARCH->closeCondVar(m_bufferCond);
+  ARCH->closeMutex(m_bufferMutex);
 }
 
 void FileLogOutputter::setLogFilename(const char *logFile)
 {
   assert(logFile != NULL);
+
+  ArchMutexLock lock(m_fileMutex);
   m_fileName = logFile;
+
+  // the next write opens the new file.
+  if (m_handle.is_open()) {
+    m_handle.close();
+  }
+}
+
+void FileLogOutputter::startWriter()
+{
+  if (m_writerThread != nullptr) {
+    return;
+  }
+
+  {
+    ArchMutexLock lock(m_bufferMutex);
+    m_running = true;
+  }
+  m_writerThread = new Thread(new TMethodJob<FileLogOutputter>(this, &FileLogOutputter::writerThread));
 }
 
 bool FileLogOutputter::write(ELevel level, const char *message)
 {
-  bool moveFile = false;
+  const size_t length = strlen(message);
+  bool wasEmpty;
+  bool running;
+  {
+    ArchMutexLock lock(m_bufferMutex);
+    running = m_running;
+    wasEmpty = m_buffer.empty();
+
+    if (m_buffer.size() + length + 1 > kBufferSizeLimit * 1024) {
+      // the writer can't keep up (e.g. the disk is stalled), so
+      // discard rather than grow without bound or block the caller.
+      m_droppedCount++;
+      return true;
+    }
 
-  std::ofstream m_handle;
-  m_handle.open(deskflow::filesystem::path(m_fileName), std::fstream::app);
-  if (m_handle.is_open() && m_handle.fail() != true) {
-    m_handle << message << std::endl;
+    m_buffer.append(message, length);
+    m_buffer.push_back('\n');
 
-    // when file size exceeds limits, move to 'old log' filename.
-    size_t p = m_handle.tellp();
-    if (p > (kFileSizeLimit * 1024)) {
-      moveFile = true;
+    // only wake the writer when it may be waiting; lines added while
+    // it's busy get picked up by the same batch.
+    if (wasEmpty && running) {
+      ARCH->signalCondVar(m_bufferCond);
     }
   }
-  m_handle.close();
 
-  if (moveFile) {
-    String oldLogFilename = deskflow::string::sprintf("%s.1", m_fileName.c_str());
-    remove(oldLogFilename.c_str());
-    rename(m_fileName.c_str(), oldLogFilename.c_str());
+  // make sure errors reach the disk in case we're about to die.
+  if (!running || (level >= kFATAL && level <= kERROR)) {
+    flush();
   }
 
   return true;
 }
 
+void FileLogOutputter::flush()
+{
+  ArchMutexLock fileLock(m_fileMutex);
+
+  UInt32 droppedCount;
+  {
+    ArchMutexLock lock(m_bufferMutex);
+    m_writeBuffer.swap(m_buffer);
+    droppedCount = m_droppedCount;
+    m_droppedCount = 0;
+  }
+
+  if (droppedCount > 0) {
+    writeToFile(deskflow::string::sprintf("log buffer full, %u lines dropped\n", droppedCount));
+  }
+
+  if (!m_writeBuffer.empty()) {
+    writeToFile(m_writeBuffer);
+    m_writeBuffer.clear();
+  }
+}
+
+void FileLogOutputter::writerThread(void *)
+{
+  while (isRunning()) {
+    {
+      ArchMutexLock lock(m_bufferMutex);
+      while (m_running && m_buffer.empty()) {
+        ARCH->waitCondVar(m_bufferCond, m_bufferMutex, -1);
+      }
+    }
+
+    flush();
+  }
+}
+
+bool FileLogOutputter::isRunning()
+{
+  ArchMutexLock lock(m_bufferMutex);
+  return m_running;
+}
+
+void FileLogOutputter::writeToFile(const std::string &data)
+{
+  if (!m_handle.is_open()) {
+    openFile();
+  }
+
+  if (!m_handle.is_open() || m_handle.fail()) {
+    // try again next time, the file may have been moved or locked.
+    m_handle.close();
+    return;
+  }
+
+  m_handle.write(data.data(), static_cast<std::streamsize>(data.size()));
+  m_handle.flush();
+  m_fileSize += data.size();
+
+  // when file size exceeds limits, move to 'old log' filename.
+  if (m_fileSize > kFileSizeLimit * 1024) {
+    rotateFile();
+  }
+}
+
+void FileLogOutputter::openFile()
+{
+  m_handle.open(deskflow::filesystem::path(m_fileName), std::fstream::app);
+  m_handle.seekp(0, std::ios::end);
+
+  const auto position = m_handle.tellp();
+  m_fileSize = position > 0 ? static_cast<size_t>(position) : 0;
+}
+
+void FileLogOutputter::rotateFile()
+{
+  m_handle.close();
+
+  String oldLogFilename = deskflow::string::sprintf("%s.1", m_fileName.c_str());
+  remove(oldLogFilename.c_str());
+  rename(m_fileName.c_str(), oldLogFilename.c_str());
+
+  openFile();
+}
+
 void FileLogOutputter::open(const char *title)
 {
 }
 
 void FileLogOutputter::close()
 {
+  if (m_writerThread != nullptr) {
+    {
+      ArchMutexLock lock(m_bufferMutex);
+      m_running = false;
+      ARCH->broadcastCondVar(m_bufferCond);
+    }
+
+    // the writer uses this outputter, so wait for it however long its
+    // last write takes.  it stops once it has written what it holds.
+    m_writerThread->wait();
+    delete m_writerThread;
+    m_writerThread = nullptr;
+  }
+
+  // write anything left over, and from now on write synchronously.
+  flush();
+
+  ArchMutexLock fileLock(m_fileMutex);
+  if (m_handle.is_open()) {
+    m_handle.close();
+  }
 }
 
 void FileLogOutputter::show(bool showIfEmpty)
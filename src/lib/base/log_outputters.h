@@ -68,25 +68,72 @@ public:
 //! Write log to file
 /*!
 This outputter writes output to the file.  The level for each
-message is ignored.
-*/
+message is ignored, except that errors and worse are flushed to disk
+before \c write() returns.
 
+Messages are appended to an in-memory buffer and written to the file in
+batches by a background thread which keeps the file open, so logging
+threads never block on file I/O.  When the file exceeds the size limit,
+it is moved to the 'old log' filename and a new file is started.
+*/
 class FileLogOutputter : public ILogOutputter
 {
 public:
   FileLogOutputter(const char *logFile);
+  FileLogOutputter(FileLogOutputter const &) = delete;
+  FileLogOutputter(FileLogOutputter &&) = delete;
   virtual ~FileLogOutputter();
 
+  FileLogOutputter &operator=(FileLogOutputter const &) = delete;
+  FileLogOutputter &operator=(FileLogOutputter &&) = delete;
+
   // ILogOutputter overrides
   virtual void open(const char *title);
   virtual void close();
   virtual void show(bool showIfEmpty);
   virtual bool write(ELevel level, const char *message);
 
+  //! @name manipulators
+  //@{
+
   void setLogFilename(const char *title);
 
+  //! Start writing from a background thread
+  /*!
+  Until this is called messages are written to the file as they're
+  logged.  On unix this must be called after daemonizing, since threads
+  don't survive fork().
+  */
+  void startWriter();
+
+  //! Write buffered messages to the file
+  /*!
+  Writes all buffered messages to the file from the calling thread and
+  returns once they have been handed to the OS.
+  */
+  void flush();
+
+  //@}
+
+private:
+  void writerThread(void *);
+  bool isRunning();
+  void writeToFile(const std::string &data);
+  void openFile();
+  void rotateFile();
+
 private:
   std::string m_fileName;
+  std::ofstream m_handle;
+  size_t m_fileSize;
+  std::string m_buffer;
+  std::string m_writeBuffer;
+  UInt32 m_droppedCount;
+  bool m_running;
+  Thread *m_writerThread;
+  ArchMutex m_bufferMutex;
+  ArchCond m_bufferCond;
+  ArchMutex m_fileMutex;
 };
 
 //! Write log to system log
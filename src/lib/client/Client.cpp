@@ -19,10 +19,12 @@
 #include "client/Client.h"
 
 #include "arch/Arch.h"
+#include "base/FunctionJob.h"
 #include "base/IEventQueue.h"
 #include "base/Log.h"
 #include "base/TMethodEventJob.h"
 #include "base/TMethodJob.h"
+#include "client/ClientMotionChannel.h"
 #include "client/ServerProxy.h"
 #include "common/stdexcept.h"
 #include "deskflow/AppUtil.h"
@@ -35,6 +37,8 @@
 #include "deskflow/StreamChunker.h"
 #include "deskflow/XDeskflow.h"
 #include "deskflow/protocol_types.h"
+#include "mt/Lock.h"
+#include "mt/Mutex.h"
 #include "mt/Thread.h"
 #include "net/IDataSocket.h"
 #include "net/ISocketFactory.h"
@@ -49,6 +53,58 @@
 #include <iterator>
 #include <sstream>
 
+namespace {
+
+// how long to wait for a connection attempt before also trying the next
+// address, as recommended for happy eyeballs (RFC 8305)
+const double kConnectAttemptDelay = 0.25;
+
+// alternates between address families, starting with the family of
+// the first address, keeping the resolver's order within each family.
+std::vector<NetworkAddress> interleaveFamilies(const std::vector<NetworkAddress> &addresses)
+{
+  std::vector<NetworkAddress> first;
+  std::vector<NetworkAddress> other;
+  const auto family = ARCH->getAddrFamily(addresses.front().getAddress());
+  for (const auto &address : addresses) {
+    if (ARCH->getAddrFamily(address.getAddress()) == family) {
+      first.push_back(address);
+    } else {
+      other.push_back(address);
+    }
+  }
+
+  std::vector<NetworkAddress> result;
+  for (size_t i = 0; i < first.size() || i < other.size(); ++i) {
+    if (i < first.size()) {
+      result.push_back(first[i]);
+    }
+    if (i < other.size()) {
+      result.push_back(other[i]);
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+//
+// Client::Resolver
+//
+
+// one lookup of the server's hostname.  shared with the resolver thread,
+// which may outlive the client since a lookup can't be interrupted, so
+// the client clears m_events to stop the result being posted.
+struct Client::Resolver
+{
+  Mutex m_mutex;
+  IEventQueue *m_events = nullptr;
+  Event::Type m_resolved = Event::kUnknown;
+  void *m_target = nullptr;
+  NetworkAddress m_address;
+  UInt32 m_id = 0;
+};
+
 //
 // Client
 //
@@ -87,6 +143,9 @@ Client::Client(
   m_events->adoptHandler(
       m_events->forIScreen().resume(), getEventTarget(), new TMethodEventJob<Client>(this, &Client::handleResume)
   );
+  m_events->adoptHandler(
+      m_events->forClient().resolved(), this, new TMethodEventJob<Client>(this, &Client::handleResolved)
+  );
 
   if (m_args.m_enableDragDrop) {
     m_events->adoptHandler(
@@ -107,17 +166,19 @@ Client::~Client()
 
   m_events->removeHandler(m_events->forIScreen().suspend(), getEventTarget());
   m_events->removeHandler(m_events->forIScreen().resume(), getEventTarget());
+  m_events->removeHandler(m_events->forClient().resolved(), this);
 
   cleanupTimer();
   cleanupScreen();
-  cleanupConnecting();
+  cleanupResolver();
+  cleanupConnectAttempts();
   cleanupConnection();
   delete m_socketFactory;
 }
 
-void Client::connect(size_t addressIndex)
+void Client::connect()
 {
-  if (m_stream != NULL) {
+  if (m_stream != NULL || isConnecting()) {
     return;
   }
   if (m_suspended) {
@@ -125,48 +186,30 @@ void Client::connect(size_t addressIndex)
     return;
   }
 
-  try {
-    if (m_args.m_hostMode) {
-      LOG((CLOG_NOTE "waiting for server connection on %i port", m_serverAddress.getPort()));
-    } else {
-      // resolve the server hostname.  do this every time we connect
-      // in case we couldn't resolve the address earlier or the address
-      // has changed (which can happen frequently if this is a laptop
-      // being shuttled between various networks).  patch by Brent
-      // Priddy.
-      m_resolvedAddressesCount = m_serverAddress.resolve(addressIndex);
-
-      // m_serverAddress will be null if the hostname address is not reolved
-      if (m_serverAddress.getAddress() != nullptr) {
-        // to help users troubleshoot, show server host name (issue: 60)
-        LOG(
-            (CLOG_NOTE "connecting to '%s': %s:%i", m_serverAddress.getHostname().c_str(),
-             ARCH->addrToString(m_serverAddress.getAddress()).c_str(), m_serverAddress.getPort())
-        );
-      }
-    }
-
-    // create the socket
-    IDataSocket *socket =
-        m_socketFactory->create(m_useSecureNetwork, ARCH->getAddrFamily(m_serverAddress.getAddress()));
-    bindNetworkInterface(socket);
-
-    // filter socket messages, including a packetizing filter
-    m_stream = new PacketStreamFilter(m_events, socket, true);
-
-    // connect
-    LOG((CLOG_DEBUG1 "connecting to server"));
-    setupConnecting();
-    setupTimer();
-    socket->connect(m_serverAddress);
-  } catch (XBase &e) {
-    cleanupTimer();
-    cleanupConnecting();
-    cleanupStream();
-    LOG((CLOG_DEBUG1 "connection failed"));
-    sendConnectionFailedEvent(e.what());
+  if (m_args.m_hostMode) {
+    LOG((CLOG_NOTE "waiting for server connection on %i port", m_serverAddress.getPort()));
+    m_connectAddresses.assign(1, m_serverAddress);
+    m_nextConnectAddress = 0;
+    startConnectAttempt();
     return;
   }
+
+  // resolve the server hostname.  do this every time we connect
+  // in case we couldn't resolve the address earlier or the address
+  // has changed (which can happen frequently if this is a laptop
+  // being shuttled between various networks).  patch by Brent
+  // Priddy.  the lookup can block for several seconds, so do it on
+  // another thread and carry on in handleResolved().
+  LOG((CLOG_DEBUG1 "resolving '%s'", m_serverAddress.getHostname().c_str()));
+  m_resolver = std::make_shared<Resolver>();
+  m_resolver->m_events = m_events;
+  m_resolver->m_resolved = m_events->forClient().resolved();
+  m_resolver->m_target = this;
+  m_resolver->m_address = m_serverAddress;
+  m_resolver->m_id = ++m_resolveId;
+
+  // the thread is detached when this goes out of scope
+  Thread thread(new FunctionJob(&Client::resolveThread, new std::shared_ptr<Resolver>(m_resolver)));
 }
 
 void Client::disconnect(const char *msg)
@@ -206,7 +249,7 @@ bool Client::isConnected() const
 
 bool Client::isConnecting() const
 {
-  return (m_timer != NULL);
+  return (m_resolver != nullptr || !m_connectAttempts.empty() || m_timer != NULL);
 }
 
 NetworkAddress Client::getServerAddress() const
@@ -271,6 +314,115 @@ void Client::setClipboard(ClipboardID id, const IClipboard *clipboard)
   m_sentClipboard[id] = false;
 }
 
+void Client::setClipboardFormats(ClipboardID id, UInt32 seqNum, const std::vector<ClipboardFormatInfo> &formats)
+{
+  m_advertisedFormats[id] = formats;
+  m_advertisedSeqNum[id] = seqNum;
+  m_advertisedSet[id] = false;
+  m_requestedFormats[id].clear();
+
+  // only ask for the formats that differ from the ones we already have.
+  // a format the server hasn't read yet never matches.
+  UInt32 changed = 0;
+  const auto received = m_receivedClipboard[id].getFormatInfo();
+  for (const auto &format : formats) {
+    auto same = std::find_if(received.begin(), received.end(), [&format](const ClipboardFormatInfo &info) {
+      return info.m_format == format.m_format && info.m_size == format.m_size && info.m_hash == format.m_hash &&
+             info.m_size != ClipboardFormatInfo::kUnknownSize;
+    });
+    if (same == received.end()) {
+      changed |= 1u << format.m_format;
+    }
+  }
+
+  // text is small and usually what gets pasted so it's requested now.
+  // other formats are requested when an application asks for them, if
+  // the screen can wait for them.
+  m_deferredFormats[id] = changed & m_screen->getDeferrableClipboardFormats() & ~(1u << IClipboard::kText);
+  const UInt32 requested = changed & ~m_deferredFormats[id];
+
+  if (requested == 0) {
+    LOG((CLOG_DEBUG "clipboard %d formats unchanged or deferred, not requesting data", id));
+    setAdvertisedClipboard(id, Clipboard());
+  } else {
+    LOG((CLOG_DEBUG "requesting clipboard %d formats=0x%x", id, requested));
+    m_requestedFormats[id].push_back(requested);
+    m_server->requestClipboard(id, seqNum, requested);
+  }
+}
+
+void Client::setRequestedClipboard(ClipboardID id, UInt32 seqNum, const Clipboard &data)
+{
+  if (seqNum == 0 || seqNum != m_advertisedSeqNum[id] || m_requestedFormats[id].empty()) {
+    LOG((CLOG_DEBUG "ignored clipboard %d data for old formats seqnum=%d", id, seqNum));
+    return;
+  }
+
+  // the server answers requests in order
+  const UInt32 formats = m_requestedFormats[id].front();
+  m_requestedFormats[id].pop_front();
+
+  if (!m_advertisedSet[id]) {
+    setAdvertisedClipboard(id, data);
+    return;
+  }
+
+  // give the screen the data applications are waiting for
+  LOG((CLOG_DEBUG "resolving clipboard %d formats=0x%x", id, formats));
+  m_receivedClipboard[id].resolve(data, formats);
+  m_screen->resolveClipboard(id, &m_receivedClipboard[id]);
+}
+
+void Client::setAdvertisedClipboard(ClipboardID id, const Clipboard &data)
+{
+  // combine the requested formats with the unchanged and deferred ones
+  Clipboard clipboard;
+  Clipboard &received = m_receivedClipboard[id];
+  clipboard.setDeferrableFormats(m_deferredFormats[id]);
+  clipboard.open(0);
+  clipboard.empty();
+  data.open(0);
+  received.open(0);
+  for (const auto &format : m_advertisedFormats[id]) {
+    if (clipboard.addDeferred(format.m_format, m_advertisedSeqNum[id])) {
+      continue;
+    }
+    const Clipboard &source = data.has(format.m_format) ? data : received;
+    if (source.has(format.m_format)) {
+      clipboard.add(format.m_format, source.get(format.m_format));
+    }
+  }
+  received.close();
+  data.close();
+  clipboard.close();
+
+  received = clipboard;
+  m_advertisedSet[id] = true;
+
+  setClipboard(id, &received);
+}
+
+void Client::openMotionChannel(UInt32 channel, UInt16 port, const String &key)
+{
+  // in host mode the server connected to us, so we don't know its address
+  if (m_args.m_hostMode || m_motionChannel != nullptr || !m_connectedAddress.isValid()) {
+    return;
+  }
+
+  ArchNetAddress address = ARCH->copyAddr(m_connectedAddress.getAddress());
+  ARCH->setAddrPort(address, port);
+  NetworkAddress serverAddress(address);
+
+  try {
+    m_motionChannel = new ClientMotionChannel(
+        m_events, m_socketFactory, serverAddress, channel, key, m_server, kKeepAliveRate
+    );
+    LOG((CLOG_DEBUG "opened motion channel to %s:%d", serverAddress.getHostname().c_str(), port));
+  } catch (XBase &e) {
+    LOG((CLOG_WARN "cannot open motion channel: %s", e.what()));
+  }
+}
+
 void Client::grabClipboard(ClipboardID id)
 {
   m_screen->grabClipboard(id);
@@ -362,7 +514,7 @@ void Client::setOptions(const OptionsList &options)
   m_screen->setOptions(options);
 }
 
-String Client::getName() const
+const String &Client::getName() const
 {
   return m_name;
 }
@@ -430,24 +582,79 @@ void Client::sendFileChunk(const void *data)
   m_server->fileChunkSending(chunk->m_chunk[0], &chunk->m_chunk[1], chunk->m_dataSize);
 }
 
-void Client::setupConnecting()
+void Client::startConnectAttempt()
 {
-  assert(m_stream != NULL);
+  cleanupConnectAttemptTimer();
+
+  while (m_nextConnectAddress < m_connectAddresses.size()) {
+    const NetworkAddress &address = m_connectAddresses[m_nextConnectAddress++];
+    if (!m_args.m_hostMode) {
+      // to help users troubleshoot, show server host name (issue: 60)
+      LOG(
+          (CLOG_NOTE "connecting to '%s': %s:%i", address.getHostname().c_str(),
+           ARCH->addrToString(address.getAddress()).c_str(), address.getPort())
+      );
+    }
+
+    deskflow::IStream *stream = NULL;
+    try {
+      // create the socket
+      IDataSocket *socket = m_socketFactory->create(m_useSecureNetwork, ARCH->getAddrFamily(address.getAddress()));
+      bindNetworkInterface(socket);
+
+      // filter socket messages, including a packetizing filter
+      stream = new PacketStreamFilter(m_events, socket, true);
+      m_connectAttempts.push_back({stream, address});
+
+      // connect
+      LOG((CLOG_DEBUG1 "connecting to server"));
+      setupConnecting(stream);
+      socket->connect(address);
+    } catch (XBase &e) {
+      LOG((CLOG_DEBUG1 "connection attempt failed: %s", e.what()));
+      m_connectError = e.what();
+      if (stream != NULL) {
+        removeConnectAttempt(stream);
+      }
+      continue;
+    }
+
+    // give this attempt a head start before racing it with the next address
+    if (m_nextConnectAddress < m_connectAddresses.size()) {
+      m_connectAttemptTimer = m_events->newOneShotTimer(kConnectAttemptDelay, NULL);
+      m_events->adoptHandler(
+          Event::kTimer, m_connectAttemptTimer, new TMethodEventJob<Client>(this, &Client::handleConnectAttemptDelay)
+      );
+    }
+    return;
+  }
+
+  if (m_connectAttempts.empty()) {
+    // every address has failed
+    cleanupTimer();
+    LOG((CLOG_DEBUG1 "connection failed"));
+    sendConnectionFailedEvent(m_connectError.c_str());
+  }
+}
+
+void Client::setupConnecting(deskflow::IStream *stream)
+{
+  assert(stream != NULL);
 
   if (m_args.m_enableCrypto) {
     m_events->adoptHandler(
-        m_events->forIDataSocket().secureConnected(), m_stream->getEventTarget(),
+        m_events->forIDataSocket().secureConnected(), stream->getEventTarget(),
         new TMethodEventJob<Client>(this, &Client::handleConnected)
     );
   } else {
     m_events->adoptHandler(
-        m_events->forIDataSocket().connected(), m_stream->getEventTarget(),
+        m_events->forIDataSocket().connected(), stream->getEventTarget(),
         new TMethodEventJob<Client>(this, &Client::handleConnected)
     );
   }
 
   m_events->adoptHandler(
-      m_events->forIDataSocket().connectionFailed(), m_stream->getEventTarget(),
+      m_events->forIDataSocket().connectionFailed(), stream->getEventTarget(),
       new TMethodEventJob<Client>(this, &Client::handleConnectionFailed)
   );
 }
@@ -497,6 +704,10 @@ void Client::setupScreen()
       m_events->forClipboard().clipboardGrabbed(), getEventTarget(),
       new TMethodEventJob<Client>(this, &Client::handleClipboardGrabbed)
   );
+  m_events->adoptHandler(
+      m_events->forClipboard().clipboardRequested(), getEventTarget(),
+      new TMethodEventJob<Client>(this, &Client::handleClipboardRequested)
+  );
 }
 
 void Client::setupTimer()
@@ -514,15 +725,59 @@ void Client::cleanup()
   m_connectOnResume = false;
   cleanupTimer();
   cleanupScreen();
-  cleanupConnecting();
+  cleanupResolver();
+  cleanupConnectAttempts();
   cleanupConnection();
 }
 
-void Client::cleanupConnecting()
+void Client::cleanupResolver()
 {
-  if (m_stream != NULL) {
-    m_events->removeHandler(m_events->forIDataSocket().connected(), m_stream->getEventTarget());
-    m_events->removeHandler(m_events->forIDataSocket().connectionFailed(), m_stream->getEventTarget());
+  if (m_resolver != nullptr) {
+    // the lookup carries on, but its result is discarded
+    Lock lock(&m_resolver->m_mutex);
+    m_resolver->m_events = nullptr;
+  }
+  m_resolver.reset();
+}
+
+void Client::cleanupConnecting(deskflow::IStream *stream)
+{
+  m_events->removeHandler(m_events->forIDataSocket().connected(), stream->getEventTarget());
+  m_events->removeHandler(m_events->forIDataSocket().secureConnected(), stream->getEventTarget());
+  m_events->removeHandler(m_events->forIDataSocket().connectionFailed(), stream->getEventTarget());
+}
+
+void Client::removeConnectAttempt(deskflow::IStream *stream)
+{
+  cleanupConnecting(stream);
+  m_connectAttempts.erase(
+      std::remove_if(
+          m_connectAttempts.begin(), m_connectAttempts.end(),
+          [stream](const ConnectAttempt &attempt) { return attempt.m_stream == stream; }
+      ),
+      m_connectAttempts.end()
+  );
+  delete stream;
+}
+
+void Client::cleanupConnectAttempts()
+{
+  cleanupConnectAttemptTimer();
+  for (const auto &attempt : m_connectAttempts) {
+    cleanupConnecting(attempt.m_stream);
+    delete attempt.m_stream;
+  }
+  m_connectAttempts.clear();
+  m_connectAddresses.clear();
+  m_nextConnectAddress = 0;
+}
+
+void Client::cleanupConnectAttemptTimer()
+{
+  if (m_connectAttemptTimer != NULL) {
+    m_events->removeHandler(Event::kTimer, m_connectAttemptTimer);
+    m_events->deleteTimer(m_connectAttemptTimer);
+    m_connectAttemptTimer = NULL;
   }
 }
 
@@ -541,6 +796,7 @@ void Client::cleanupConnection()
 
 void Client::cleanupScreen()
 {
+  cleanupMotionChannel();
   if (m_server != NULL) {
     if (m_ready) {
       m_screen->disable();
@@ -548,11 +804,26 @@ void Client::cleanupScreen()
     }
     m_events->removeHandler(m_events->forIScreen().shapeChanged(), getEventTarget());
     m_events->removeHandler(m_events->forClipboard().clipboardGrabbed(), getEventTarget());
+    m_events->removeHandler(m_events->forClipboard().clipboardRequested(), getEventTarget());
+
+    // the formats we haven't got can't be asked for any more
+    for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+      if (m_receivedClipboard[id].getDeferredFormats() != 0) {
+        m_receivedClipboard[id].resolve(Clipboard());
+        m_screen->resolveClipboard(id, &m_receivedClipboard[id]);
+      }
+    }
     delete m_server;
     m_server = NULL;
   }
 }
 
+void Client::cleanupMotionChannel()
+{
+  delete m_motionChannel;
+  m_motionChannel = nullptr;
+}
+
 void Client::cleanupTimer()
 {
   if (m_timer != NULL) {
@@ -568,10 +839,51 @@ void Client::cleanupStream()
   m_stream = NULL;
 }
 
-void Client::handleConnected(const Event &, void *)
+void Client::handleResolved(const Event &event, void *)
+{
+  const auto result = static_cast<const ResolveResult *>(event.getDataObject());
+  if (m_resolver == nullptr || result->m_id != m_resolver->m_id) {
+    // connecting was cancelled or restarted since this lookup started
+    return;
+  }
+  cleanupResolver();
+
+  if (result->m_addresses.empty()) {
+    LOG((CLOG_DEBUG1 "connection failed"));
+    sendConnectionFailedEvent(result->m_error.c_str());
+    return;
+  }
+
+  m_connectAddresses = interleaveFamilies(result->m_addresses);
+  m_nextConnectAddress = 0;
+  m_connectError.clear();
+  setupTimer();
+  startConnectAttempt();
+}
+
+void Client::handleConnectAttemptDelay(const Event &, void *)
+{
+  startConnectAttempt();
+}
+
+void Client::handleConnected(const Event &event, void *)
 {
+  deskflow::IStream *stream = findConnectAttempt(event.getTarget());
+  if (stream == NULL) {
+    return;
+  }
+
+  // the first attempt to connect wins, the others are abandoned
   LOG((CLOG_DEBUG1 "connected;  wait for hello"));
-  cleanupConnecting();
+  cleanupConnecting(stream);
+  const auto attempt = std::find_if(
+      m_connectAttempts.begin(), m_connectAttempts.end(),
+      [stream](const ConnectAttempt &attempt) { return attempt.m_stream == stream; }
+  );
+  m_connectedAddress = attempt->m_address;
+  m_connectAttempts.erase(attempt);
+  cleanupConnectAttempts();
+  m_stream = stream;
   setupConnection();
 
   // reset clipboard state
@@ -579,25 +891,36 @@ void Client::handleConnected(const Event &, void *)
     m_ownClipboard[id] = false;
     m_sentClipboard[id] = false;
     m_timeClipboard[id] = 0;
+    m_advertisedFormats[id].clear();
+    m_advertisedSeqNum[id] = 0;
+    m_advertisedSet[id] = false;
+    m_deferredFormats[id] = 0;
+    m_requestedFormats[id].clear();
   }
 }
 
 void Client::handleConnectionFailed(const Event &event, void *)
 {
   IDataSocket::ConnectionFailedInfo *info = static_cast<IDataSocket::ConnectionFailedInfo *>(event.getData());
-
-  cleanupTimer();
-  cleanupConnecting();
-  cleanupStream();
-  LOG((CLOG_DEBUG1 "connection failed"));
-  sendConnectionFailedEvent(info->m_what.c_str());
+  m_connectError = info->m_what;
   delete info;
+
+  deskflow::IStream *stream = findConnectAttempt(event.getTarget());
+  if (stream == NULL) {
+    return;
+  }
+
+  LOG((CLOG_DEBUG1 "connection attempt failed: %s", m_connectError.c_str()));
+  removeConnectAttempt(stream);
+
+  // try the next address now rather than after the delay
+  startConnectAttempt();
 }
 
 void Client::handleConnectTimeout(const Event &, void *)
 {
   cleanupTimer();
-  cleanupConnecting();
+  cleanupConnectAttempts();
   cleanupConnection();
   cleanupStream();
   LOG((CLOG_DEBUG1 "connection timed out"));
@@ -651,6 +974,25 @@ void Client::handleClipboardGrabbed(const Event &event, void *)
   }
 }
 
+void Client::handleClipboardRequested(const Event &event, void *)
+{
+  const IScreen::ClipboardRequestInfo *info = static_cast<const IScreen::ClipboardRequestInfo *>(event.getData());
+  const ClipboardID id = info->m_id;
+
+  // skip formats that have already been requested
+  UInt32 formats = info->m_formats & m_receivedClipboard[id].getDeferredFormats();
+  for (UInt32 requested : m_requestedFormats[id]) {
+    formats &= ~requested;
+  }
+  if (formats == 0 || m_advertisedSeqNum[id] == 0) {
+    return;
+  }
+
+  LOG((CLOG_DEBUG "requesting clipboard %d formats=0x%x for paste", id, formats));
+  m_requestedFormats[id].push_back(formats);
+  m_server->requestClipboard(id, m_advertisedSeqNum[id], formats);
+}
+
 void Client::handleHello(const Event &, void *)
 {
   SInt16 major, minor;
@@ -686,6 +1028,7 @@ void Client::handleHello(const Event &, void *)
 
   // now connected but waiting to complete handshake
   setupScreen();
+  m_server->setProtocolVersion(helloBackMajor, helloBackMinor);
   cleanupTimer();
 
   // make sure we process any remaining messages later.  we won't
@@ -754,6 +1097,36 @@ void Client::bindNetworkInterface(IDataSocket *socket) const
   }
 }
 
+deskflow::IStream *Client::findConnectAttempt(void *target) const
+{
+  for (const auto &attempt : m_connectAttempts) {
+    if (attempt.m_stream->getEventTarget() == target) {
+      return attempt.m_stream;
+    }
+  }
+  return NULL;
+}
+
+void Client::resolveThread(void *arg)
+{
+  std::unique_ptr<std::shared_ptr<Resolver>> owner(static_cast<std::shared_ptr<Resolver> *>(arg));
+  Resolver &resolver = **owner;
+
+  auto result = new ResolveResult(resolver.m_id);
+  try {
+    result->m_addresses = resolver.m_address.resolveAll();
+  } catch (XBase &e) {
+    result->m_error = e.what();
+  }
+
+  Lock lock(&resolver.m_mutex);
+  if (resolver.m_events != nullptr) {
+    resolver.m_events->addEvent(Event(resolver.m_resolved, resolver.m_target, result));
+  } else {
+    delete result;
+  }
+}
+
 void Client::handleStopRetry(const Event &, void *)
 {
   m_args.m_restartable = false;
@@ -27,8 +27,11 @@
 #include "deskflow/INode.h"
 #include "mt/CondVar.h"
 #include "net/NetworkAddress.h"
+#include <deque>
 #include <memory>
+#include <vector>
 
+class ClientMotionChannel;
 class EventQueueTimer;
 namespace deskflow {
 class Screen;
@@ -77,15 +80,25 @@ public:
   Client &operator=(Client const &) = delete;
   Client &operator=(Client &&) = delete;
 
+#ifdef TEST_ENV
+  Client() : m_mock(true)
+  {
+  }
+#endif
+
   //! @name manipulators
   //@{
 
   //! Connect to server
   /*!
   Starts an attempt to connect to the server.  This is ignored if
-  the client is trying to connect or is already connected.
+  the client is trying to connect or is already connected.  The
+  server's hostname is resolved on another thread, then every address
+  it resolves to is tried in turn, starting the next attempt if the
+  previous one hasn't connected within a short delay, and the first
+  connection to succeed is used.
   */
-  void connect(size_t addressIndex = 0);
+  void connect();
 
   //! Disconnect
   /*!
@@ -115,6 +128,33 @@ public:
   //! Send dragging file information back to server
   void sendDragInfo(UInt32 fileCount, String &info, size_t size);
 
+  //! Set advertised clipboard formats
+  /*!
+  Called when the server lists the formats of its clipboard.  Requests
+  the formats that differ from the last clipboard received, or sets
+  the clipboard straight away if none do.  If the screen can wait for
+  them, formats other than text are left deferred and requested when
+  an application asks for them.
+  */
+  void setClipboardFormats(ClipboardID, UInt32 seqNum, const std::vector<ClipboardFormatInfo> &formats);
+
+  //! Set requested clipboard formats
+  /*!
+  Called with the data of the formats requested for the advertisement
+  \p seqNum.  Sets the clipboard, or gives the screen the deferred
+  formats an application asked for once the clipboard is set.  Ignored
+  if the server has listed other formats since.
+  */
+  void setRequestedClipboard(ClipboardID, UInt32 seqNum, const Clipboard &clipboard);
+
+  //! Open the motion channel
+  /*!
+  Called when the server offers its UDP motion channel \p channel on
+  \p port with \p key.  The offer is ignored in host mode, or if the
+  channel can't be opened, in which case motion stays on TCP.
+  */
+  void openMotionChannel(UInt32 channel, UInt16 port, const String &key);
+
   //@}
   //! @name accessors
   //@{
@@ -160,12 +200,6 @@ public:
     return m_dragFileList;
   }
 
-  //! Return last resolved adresses count
-  size_t getLastResolvedAddressesCount() const
-  {
-    return m_resolvedAddressesCount;
-  }
-
   //@}
 
   // IScreen overrides
@@ -191,25 +225,53 @@ public:
   virtual void screensaver(bool activate);
   virtual void resetOptions();
   virtual void setOptions(const OptionsList &options);
-  virtual String getName() const;
+  virtual const String &getName() const;
 
 private:
+  struct Resolver;
+
+  class ResolveResult : public EventData
+  {
+  public:
+    ResolveResult(UInt32 id) : m_id(id)
+    {
+    }
+
+    UInt32 m_id;
+    std::vector<NetworkAddress> m_addresses;
+    String m_error;
+  };
+
+  struct ConnectAttempt
+  {
+    deskflow::IStream *m_stream;
+    NetworkAddress m_address;
+  };
+
   void sendClipboard(ClipboardID);
   void sendEvent(Event::Type, void *);
   void sendConnectionFailedEvent(const char *msg);
   void sendFileChunk(const void *data);
   void sendFileThread(void *);
   void writeToDropDirThread(void *);
-  void setupConnecting();
+  void startConnectAttempt();
+  void setupConnecting(deskflow::IStream *stream);
   void setupConnection();
   void setupScreen();
   void setupTimer();
   void cleanup();
-  void cleanupConnecting();
+  void cleanupResolver();
+  void cleanupConnecting(deskflow::IStream *stream);
+  void removeConnectAttempt(deskflow::IStream *stream);
+  void cleanupConnectAttempts();
+  void cleanupConnectAttemptTimer();
   void cleanupConnection();
   void cleanupScreen();
   void cleanupTimer();
   void cleanupStream();
+  void cleanupMotionChannel();
+  void handleResolved(const Event &, void *);
+  void handleConnectAttemptDelay(const Event &, void *);
   void handleConnected(const Event &, void *);
   void handleConnectionFailed(const Event &, void *);
   void handleConnectTimeout(const Event &, void *);
@@ -217,6 +279,8 @@ private:
   void handleDisconnected(const Event &, void *);
   void handleShapeChanged(const Event &, void *);
   void handleClipboardGrabbed(const Event &, void *);
+  void handleClipboardRequested(const Event &, void *);
+  void setAdvertisedClipboard(ClipboardID, const Clipboard &data);
   void handleHello(const Event &, void *);
   void handleSuspend(const Event &event, void *);
   void handleResume(const Event &event, void *);
@@ -226,6 +290,12 @@ private:
   void onFileRecieveCompleted();
   void sendClipboardThread(void *);
   void bindNetworkInterface(IDataSocket *socket) const;
+  deskflow::IStream *findConnectAttempt(void *target) const;
+  static void resolveThread(void *);
+
+#ifdef TEST_ENV
+  friend class ClientConnectTests;
+#endif
 
 public:
   bool m_mock;
@@ -246,6 +316,12 @@ private:
   bool m_sentClipboard[kClipboardEnd];
   IClipboard::Time m_timeClipboard[kClipboardEnd];
   String m_dataClipboard[kClipboardEnd];
+  Clipboard m_receivedClipboard[kClipboardEnd];
+  std::vector<ClipboardFormatInfo> m_advertisedFormats[kClipboardEnd];
+  UInt32 m_advertisedSeqNum[kClipboardEnd];
+  bool m_advertisedSet[kClipboardEnd];
+  UInt32 m_deferredFormats[kClipboardEnd];
+  std::deque<UInt32> m_requestedFormats[kClipboardEnd];
   IEventQueue *m_events;
   std::size_t m_expectedFileSize;
   String m_receivedFileData;
@@ -258,5 +334,13 @@ private:
   bool m_enableClipboard;
   size_t m_maximumClipboardSize;
   deskflow::ClientArgs m_args;
-  size_t m_resolvedAddressesCount = 0;
+  std::shared_ptr<Resolver> m_resolver;
+  UInt32 m_resolveId = 0;
+  std::vector<NetworkAddress> m_connectAddresses;
+  size_t m_nextConnectAddress = 0;
+  std::vector<ConnectAttempt> m_connectAttempts;
+  EventQueueTimer *m_connectAttemptTimer = nullptr;
+  String m_connectError;
+  NetworkAddress m_connectedAddress;
+  ClientMotionChannel *m_motionChannel = nullptr;
 };
@@ -0,0 +1,114 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "client/ClientMotionChannel.h"
+
+#include "arch/Arch.h"
+#include "base/IEventQueue.h"
+#include "base/Log.h"
+#include "base/TMethodEventJob.h"
+#include "client/ServerProxy.h"
+#include "deskflow/MotionDatagram.h"
+#include "deskflow/protocol_types.h"
+#include "net/DatagramSocket.h"
+#include "net/ISocketFactory.h"
+#include "net/NetworkAddress.h"
+
+namespace {
+
+// datagrams read per event, so a flood can't starve the event queue
+const int kMaxDatagramsPerEvent = 64;
+
+} // namespace
+
+//
+// ClientMotionChannel
+//
+
+ClientMotionChannel::ClientMotionChannel(
+    IEventQueue *events, ISocketFactory *socketFactory, const NetworkAddress &address, UInt32 channel,
+    const String &key, ServerProxy *server, double rate
+)
+    : m_events(events),
+      m_socket(socketFactory->createDatagram(ARCH->getAddrFamily(address.getAddress()))),
+      m_timer(nullptr),
+      m_channel(channel),
+      m_key(key),
+      m_seq(0),
+      m_server(server)
+{
+  try {
+    m_socket->connect(address);
+  } catch (...) {
+    delete m_socket;
+    throw;
+  }
+
+  m_events->adoptHandler(
+      m_events->forIStream().inputReady(), m_socket->getEventTarget(),
+      new TMethodEventJob<ClientMotionChannel>(this, &ClientMotionChannel::handleDatagrams)
+  );
+
+  m_timer = m_events->newTimer(rate, this);
+  m_events->adoptHandler(
+      Event::kTimer, m_timer, new TMethodEventJob<ClientMotionChannel>(this, &ClientMotionChannel::handleTimer)
+  );
+
+  sendRegistration();
+}
+
+ClientMotionChannel::~ClientMotionChannel()
+{
+  m_events->removeHandler(Event::kTimer, m_timer);
+  m_events->deleteTimer(m_timer);
+  m_events->removeHandler(m_events->forIStream().inputReady(), m_socket->getEventTarget());
+  delete m_socket;
+}
+
+void ClientMotionChannel::sendRegistration()
+{
+  MotionDatagram registration(m_channel, ++m_seq, MotionDatagram::kRegister);
+  String datagram = registration.seal(m_key, false);
+  if (datagram.empty() || !m_socket->write(datagram)) {
+    LOG((CLOG_DEBUG1 "failed to register motion channel %d", m_channel));
+  }
+}
+
+void ClientMotionChannel::handleDatagrams(const Event &, void *)
+{
+  String datagram;
+  for (int i = 0; i < kMaxDatagramsPerEvent; ++i) {
+    if (!m_socket->read(datagram)) {
+      return;
+    }
+
+    MotionDatagram motion;
+    if (!motion.open(datagram, m_key, true) || motion.m_channel != m_channel) {
+      LOG((CLOG_DEBUG2 "ignoring motion datagram"));
+      continue;
+    }
+    m_server->onMotion(motion);
+  }
+
+  // come back for the rest after other events have been handled
+  m_events->addEvent(Event(m_events->forIStream().inputReady(), m_socket->getEventTarget()));
+}
+
+void ClientMotionChannel::handleTimer(const Event &, void *)
+{
+  sendRegistration();
+}
@@ -0,0 +1,70 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "base/String.h"
+#include "common/basic_types.h"
+
+class DatagramSocket;
+class Event;
+class EventQueueTimer;
+class IEventQueue;
+class ISocketFactory;
+class NetworkAddress;
+class ServerProxy;
+
+//! Client side of the UDP motion channel
+/*!
+Accepts a motion channel offered by the server.  Registers with the
+server's UDP port straight away and then periodically, which also keeps
+any NAT mapping open, and passes the motion it receives to the server
+proxy.
+*/
+class ClientMotionChannel
+{
+public:
+  /*!
+  Connects a UDP socket to \p address and registers every \p rate
+  seconds.  Throws \c XSocket on failure.  \p server must outlive the
+  channel.
+  */
+  ClientMotionChannel(
+      IEventQueue *events, ISocketFactory *socketFactory, const NetworkAddress &address, UInt32 channel,
+      const String &key, ServerProxy *server, double rate
+  );
+  ClientMotionChannel(ClientMotionChannel const &) = delete;
+  ClientMotionChannel(ClientMotionChannel &&) = delete;
+  ~ClientMotionChannel();
+
+  ClientMotionChannel &operator=(ClientMotionChannel const &) = delete;
+  ClientMotionChannel &operator=(ClientMotionChannel &&) = delete;
+
+private:
+  void sendRegistration();
+  void handleDatagrams(const Event &, void *);
+  void handleTimer(const Event &, void *);
+
+private:
+  IEventQueue *m_events;
+  DatagramSocket *m_socket;
+  EventQueueTimer *m_timer;
+  UInt32 m_channel;
+  String m_key;
+  UInt32 m_seq;
+  ServerProxy *m_server;
+};
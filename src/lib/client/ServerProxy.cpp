@@ -18,15 +18,18 @@
 
 #include "client/ServerProxy.h"
 
+#include "arch/Arch.h"
 #include "base/IEventQueue.h"
 #include "base/Log.h"
 #include "base/TMethodEventJob.h"
+#include "base/Trace.h"
 #include "base/XBase.h"
 #include "client/Client.h"
 #include "deskflow/AppUtil.h"
 #include "deskflow/Clipboard.h"
 #include "deskflow/ClipboardChunk.h"
 #include "deskflow/FileChunk.h"
+#include "deskflow/MotionDatagram.h"
 #include "deskflow/ProtocolUtil.h"
 #include "deskflow/StreamChunker.h"
 #include "deskflow/option_types.h"
@@ -47,13 +50,20 @@ ServerProxy::ServerProxy(Client *client, deskflow::IStream *stream, IEventQueue
       m_seqNum(0),
       m_compressMouse(false),
       m_compressMouseRelative(false),
+      m_compressChunks(false),
       m_xMouse(0),
       m_yMouse(0),
       m_dxMouse(0),
       m_dyMouse(0),
       m_ignoreMouse(false),
+      m_motionSeq(0),
+      m_xRelTotal(0),
+      m_yRelTotal(0),
+      m_motionFences(0),
+      m_motionHeld(false),
       m_keepAliveAlarm(0.0),
       m_keepAliveAlarmTimer(NULL),
+      m_lastReceived(0.0),
       m_parser(&ServerProxy::parseHandshakeMessage),
       m_events(events)
 {
@@ -86,28 +96,34 @@ ServerProxy::~ServerProxy()
 }
 
 void ServerProxy::resetKeepAliveAlarm()
+{
+  // the alarm timer checks this, so it doesn't have to be replaced
+  m_lastReceived = ARCH->time();
+}
+
+void ServerProxy::setKeepAliveRate(double rate)
 {
   if (m_keepAliveAlarmTimer != NULL) {
     m_events->removeHandler(Event::kTimer, m_keepAliveAlarmTimer);
     m_events->deleteTimer(m_keepAliveAlarmTimer);
     m_keepAliveAlarmTimer = NULL;
   }
+  m_keepAliveAlarm = rate * kKeepAlivesUntilDeath;
   if (m_keepAliveAlarm > 0.0) {
-    m_keepAliveAlarmTimer = m_events->newOneShotTimer(m_keepAliveAlarm, NULL);
+    // check once per keep alive whether the server has gone quiet
+    m_keepAliveAlarmTimer = m_events->newTimer(rate, NULL);
     m_events->adoptHandler(
         Event::kTimer, m_keepAliveAlarmTimer, new TMethodEventJob<ServerProxy>(this, &ServerProxy::handleKeepAliveAlarm)
     );
   }
-}
-
-void ServerProxy::setKeepAliveRate(double rate)
-{
-  m_keepAliveAlarm = rate * kKeepAlivesUntilDeath;
   resetKeepAliveAlarm();
 }
 
 void ServerProxy::handleData(const Event &, void *)
 {
+  // any message shows the server is alive, not just keep alives
+  resetKeepAliveAlarm();
+
   // handle messages until there are no more.  first read message code.
   UInt8 code[4];
   UInt32 n = m_stream->read(code, 4);
@@ -168,9 +184,8 @@ ServerProxy::EResult ServerProxy::parseHandshakeMessage(const UInt8 *code)
   }
 
   else if (memcmp(code, kMsgCKeepAlive, 4) == 0) {
-    // echo keep alives and reset alarm
+    // echo keep alives
     ProtocolUtil::writef(m_stream, kMsgCKeepAlive);
-    resetKeepAliveAlarm();
   }
 
   else if (memcmp(code, kMsgCNoop, 4) == 0) {
@@ -231,6 +246,14 @@ ServerProxy::EResult ServerProxy::parseMessage(const UInt8 *code)
     mouseWheel();
   }
 
+  else if (memcmp(code, kMsgDMotionFence, 4) == 0) {
+    motionFence();
+  }
+
+  else if (memcmp(code, kMsgDMotionChannel, 4) == 0) {
+    motionChannel();
+  }
+
   else if (memcmp(code, kMsgDKeyDown, 4) == 0) {
     UInt16 id = 0;
     UInt16 mask = 0;
@@ -271,9 +294,8 @@ ServerProxy::EResult ServerProxy::parseMessage(const UInt8 *code)
   }
 
   else if (memcmp(code, kMsgCKeepAlive, 4) == 0) {
-    // echo keep alives and reset alarm
+    // echo keep alives
     ProtocolUtil::writef(m_stream, kMsgCKeepAlive);
-    resetKeepAliveAlarm();
   }
 
   else if (memcmp(code, kMsgCNoop, 4) == 0) {
@@ -308,6 +330,10 @@ ServerProxy::EResult ServerProxy::parseMessage(const UInt8 *code)
     setClipboard();
   }
 
+  else if (memcmp(code, kMsgDClipboardFormats, 4) == 0) {
+    setClipboardFormats();
+  }
+
   else if (memcmp(code, kMsgCResetOptions, 4) == 0) {
     resetOptions();
   }
@@ -351,6 +377,10 @@ ServerProxy::EResult ServerProxy::parseMessage(const UInt8 *code)
 
 void ServerProxy::handleKeepAliveAlarm(const Event &, void *)
 {
+  if (ARCH->time() - m_lastReceived < m_keepAliveAlarm) {
+    return;
+  }
+
   LOG((CLOG_NOTE "server is dead"));
   m_client->disconnect("server is not responding");
 }
@@ -551,15 +581,66 @@ void ServerProxy::setClipboard()
   } else if (r == kFinish) {
     LOG((CLOG_DEBUG "received clipboard %d size=%d", id, dataCached.size()));
 
-    // forward
+    // forward.  a non-zero sequence number means it's the data of
+    // formats we requested.
     Clipboard clipboard;
     clipboard.unmarshall(dataCached, 0);
-    m_client->setClipboard(id, &clipboard);
+    if (seq != 0) {
+      m_client->setRequestedClipboard(id, seq, clipboard);
+    } else {
+      m_client->setClipboard(id, &clipboard);
+    }
 
     LOG((CLOG_INFO "clipboard was updated"));
   }
 }
 
+void ServerProxy::setClipboardFormats()
+{
+  // parse
+  ClipboardID id;
+  UInt32 seqNum;
+  std::vector<UInt32> list;
+  ProtocolUtil::readf(m_stream, kMsgDClipboardFormats + 4, &id, &seqNum, &list);
+  LOG((CLOG_DEBUG "recv clipboard %d formats seqnum=%d", id, seqNum));
+
+  // validate
+  if (id >= kClipboardEnd) {
+    return;
+  }
+
+  // format, size, hash high and low bits for each format
+  std::vector<ClipboardFormatInfo> formats;
+  for (size_t i = 0; i + 3 < list.size(); i += 4) {
+    if (list[i] >= IClipboard::kNumFormats) {
+      continue;
+    }
+    const std::uint64_t hash = (static_cast<std::uint64_t>(list[i + 2]) << 32) | list[i + 3];
+    formats.push_back({static_cast<IClipboard::EFormat>(list[i]), list[i + 1], hash});
+  }
+
+  // forward
+  m_client->setClipboardFormats(id, seqNum, formats);
+}
+
+void ServerProxy::setProtocolVersion(SInt16 major, SInt16 minor)
+{
+  // chunks may be compressed from 1.10
+  m_compressChunks = major > 1 || (major == 1 && minor >= 10);
+
+  // from 1.11 the server doesn't ask for our info, it expects it in the
+  // same flight as the hello reply, which saves a round trip.
+  if (major > 1 || (major == 1 && minor >= 11)) {
+    queryInfo();
+  }
+}
+
+void ServerProxy::requestClipboard(ClipboardID id, UInt32 seqNum, UInt32 formats)
+{
+  LOG((CLOG_DEBUG "request clipboard %d seqnum=%d formats=0x%x", id, seqNum, formats));
+  ProtocolUtil::writef(m_stream, kMsgQClipboard, id, seqNum, formats);
+}
+
 void ServerProxy::grabClipboard()
 {
   // parse
@@ -691,6 +772,7 @@ void ServerProxy::mouseMove()
     m_dyMouse = 0;
   }
   LOG((CLOG_DEBUG2 "recv mouse move %d,%d", x, y));
+  TRACE(TraceEvent::kServerProxyMouseMove, x, y, ignore);
 
   // forward
   if (!ignore) {
@@ -727,6 +809,79 @@ void ServerProxy::mouseRelativeMove()
   }
 }
 
+void ServerProxy::onMotion(const MotionDatagram &motion)
+{
+  // the datagram overtook messages sent before it, so wait for them
+  if (motion.m_fence > m_motionFences) {
+    if (!m_motionHeld || motion.m_seq > m_heldMotion.m_seq) {
+      LOG((CLOG_DEBUG2 "holding motion %d for fence %d", motion.m_seq, motion.m_fence));
+      m_heldMotion = motion;
+      m_motionHeld = true;
+    }
+    return;
+  }
+
+  applyMotion(motion);
+}
+
+void ServerProxy::applyMotion(const MotionDatagram &motion)
+{
+  if (motion.m_seq <= m_motionSeq) {
+    LOG((CLOG_DEBUG2 "ignoring old motion %d", motion.m_seq));
+    return;
+  }
+  m_motionSeq = motion.m_seq;
+
+  if (motion.m_kind == MotionDatagram::kAbsolute) {
+    LOG((CLOG_DEBUG2 "recv motion %d move %d,%d", motion.m_seq, motion.m_x, motion.m_y));
+    TRACE(TraceEvent::kServerProxyMouseMove, motion.m_x, motion.m_y, m_ignoreMouse);
+    if (!m_ignoreMouse) {
+      m_client->mouseMove(motion.m_x, motion.m_y);
+    }
+  } else if (motion.m_kind == MotionDatagram::kRelative) {
+    // apply whatever the datagrams we skipped would have
+    const auto dx = static_cast<SInt32>(static_cast<UInt32>(motion.m_x) - static_cast<UInt32>(m_xRelTotal));
+    const auto dy = static_cast<SInt32>(static_cast<UInt32>(motion.m_y) - static_cast<UInt32>(m_yRelTotal));
+    m_xRelTotal = motion.m_x;
+    m_yRelTotal = motion.m_y;
+    LOG((CLOG_DEBUG2 "recv motion %d relative move %d,%d", motion.m_seq, dx, dy));
+    if (!m_ignoreMouse) {
+      m_client->mouseRelativeMove(dx, dy);
+    }
+  }
+}
+
+void ServerProxy::motionChannel()
+{
+  UInt32 channel;
+  UInt16 port;
+  String key;
+  ProtocolUtil::readf(m_stream, kMsgDMotionChannel + 4, &channel, &port, &key);
+  LOG((CLOG_DEBUG1 "recv motion channel %d port=%d", channel, port));
+  m_client->openMotionChannel(channel, port, key);
+}
+
+void ServerProxy::motionFence()
+{
+  UInt32 seq;
+  UInt8 kind;
+  SInt32 x, y;
+  ProtocolUtil::readf(m_stream, kMsgDMotionFence + 4, &seq, &kind, &x, &y);
+  LOG((CLOG_DEBUG2 "recv motion fence %d", seq));
+
+  // motion received over tcp before the fence comes first
+  flushCompressedMouse();
+
+  ++m_motionFences;
+  applyMotion(MotionDatagram(0, seq, static_cast<MotionDatagram::EKind>(kind), x, y));
+
+  // then anything that was waiting for this fence
+  if (m_motionHeld && m_heldMotion.m_fence <= m_motionFences) {
+    m_motionHeld = false;
+    applyMotion(m_heldMotion);
+  }
+}
+
 void ServerProxy::mouseWheel()
 {
   // get mouse up to date
@@ -846,12 +1001,12 @@ void ServerProxy::dragInfoReceived()
 
 void ServerProxy::handleClipboardSendingEvent(const Event &event, void *)
 {
-  ClipboardChunk::send(m_stream, event.getDataObject());
+  ClipboardChunk::send(m_stream, event.getDataObject(), m_compressChunks);
 }
 
 void ServerProxy::fileChunkSending(UInt8 mark, char *data, size_t dataSize)
 {
-  FileChunk::send(m_stream, mark, data, dataSize);
+  FileChunk::send(m_stream, mark, data, dataSize, m_compressChunks ? &m_fileCompression : NULL);
 }
 
 void ServerProxy::sendDragInfo(UInt32 fileCount, const char *info, size_t size)
@@ -21,6 +21,8 @@
 #include "base/Event.h"
 #include "base/Stopwatch.h"
 #include "base/String.h"
+#include "deskflow/FileChunk.h"
+#include "deskflow/MotionDatagram.h"
 #include "deskflow/clipboard_types.h"
 #include "deskflow/key_types.h"
 #include "deskflow/languages/LanguageManager.h"
@@ -61,6 +63,31 @@ public:
   bool onGrabClipboard(ClipboardID);
   void onClipboardChanged(ClipboardID, const IClipboard *);
 
+  //! Request clipboard data
+  /*!
+  Asks the server for the data of \p formats (a mask of \c 1 << format)
+  from the clipboard formats it advertised with \p seqNum.
+  */
+  void requestClipboard(ClipboardID, UInt32 seqNum, UInt32 formats);
+
+  //! Set the protocol version
+  /*!
+  Enables the features of the protocol version agreed with the server.
+  Must be called straight after the hello reply is sent, as from 1.11
+  this also sends the screen info without waiting for the server to
+  ask for it.
+  */
+  void setProtocolVersion(SInt16 major, SInt16 minor);
+
+  //! Apply motion from the motion channel
+  /*!
+  Moves the mouse as given by \p motion, unless it's older than motion
+  that has already been applied, including that of any motion fence.
+  Motion sent after a fence that hasn't been read yet is held back until
+  it has.
+  */
+  void onMotion(const MotionDatagram &motion);
+
   //@}
 
   // sending file chunk to server
@@ -107,6 +134,7 @@ private:
   void enter();
   void leave();
   void setClipboard();
+  void setClipboardFormats();
   void grabClipboard();
   void keyDown(UInt16 id, UInt16 mask, UInt16 button, const String &lang);
   void keyRepeat();
@@ -116,6 +144,9 @@ private:
   void mouseMove();
   void mouseRelativeMove();
   void mouseWheel();
+  void motionChannel();
+  void motionFence();
+  void applyMotion(const MotionDatagram &motion);
   void screensaver();
   void resetOptions();
   void setOptions();
@@ -139,15 +170,27 @@ private:
 
   bool m_compressMouse;
   bool m_compressMouseRelative;
+  bool m_compressChunks;
+  FileChunk::Compression m_fileCompression;
   SInt32 m_xMouse, m_yMouse;
   SInt32 m_dxMouse, m_dyMouse;
 
   bool m_ignoreMouse;
 
+  // newest motion channel datagram applied, and its relative totals
+  UInt32 m_motionSeq;
+  SInt32 m_xRelTotal, m_yRelTotal;
+
+  // motion fences read, and the newest datagram waiting for a fence
+  UInt32 m_motionFences;
+  MotionDatagram m_heldMotion;
+  bool m_motionHeld;
+
   KeyModifierID m_modifierTranslationTable[kKeyModifierIDLast];
 
   double m_keepAliveAlarm;
   EventQueueTimer *m_keepAliveAlarmTimer;
+  double m_lastReceived;
 
   MessageParser m_parser;
   IEventQueue *m_events;
@@ -24,6 +24,7 @@
 #include "base/EventQueue.h"
 #include "base/Log.h"
 #include "base/TMethodEventJob.h"
+#include "base/Trace.h"
 #include "base/XBase.h"
 #include "base/log_outputters.h"
 #include "common/constants.h"
@@ -161,6 +162,10 @@ int App::run(int argc, char **argv)
 
   appUtil().beforeAppExit();
 
+  if (Trace::isEnabled()) {
+    Trace::dump();
+  }
+
   return result;
 }
 
@@ -183,6 +188,29 @@ void App::setupFileLogging()
   }
 }
 
+void App::startFileLogWriter()
+{
+  if (m_fileLog != nullptr) {
+    m_fileLog->startWriter();
+  }
+}
+
+void App::setupTracing()
+{
+  if (argsBase().m_traceFile != nullptr) {
+    Trace::enable(argsBase().m_traceFile);
+    ARCH->setSignalHandler(Arch::kUSER, &dumpTraceSignalHandler, nullptr);
+    LOG((CLOG_DEBUG1 "tracing to file (%s) enabled", argsBase().m_traceFile));
+  }
+}
+
+void App::dumpTraceSignalHandler(Arch::ESignal, void *)
+{
+  if (!Trace::dump()) {
+    LOG((CLOG_ERR "failed to write trace file"));
+  }
+}
+
 void App::loggingFilterWarning()
 {
   if (CLOG->getFilter() > CLOG->getConsoleMaxLevel()) {
@@ -232,6 +260,7 @@ void App::initApp(int argc, const char **argv)
 
   // setup file logging after parsing args
   setupFileLogging();
+  setupTracing();
 
   // load configuration
   loadConfig();
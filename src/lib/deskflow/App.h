@@ -100,6 +100,7 @@ public:
   int run(int argc, char **argv);
   int daemonMainLoop(int, const char **);
   void setupFileLogging();
+  void setupTracing();
   void loggingFilterWarning();
   void initApp(int argc, const char **argv);
   void initApp(int argc, char **argv)
@@ -131,11 +132,13 @@ public:
 
 private:
   void handleIpcMessage(const Event &, void *);
+  static void dumpTraceSignalHandler(Arch::ESignal, void *);
 
 protected:
   void initIpcClient();
   void cleanupIpcClient();
   void runEventsLoop(void *);
+  void startFileLogWriter();
 
   IArchTaskBarReceiver *m_taskBarReceiver;
   bool m_suspended;
@@ -197,6 +200,8 @@ public:
   "  -1, --no-restart         do not try to restart on failure.\n"                                                     \
   "*     --restart            restart the server automatically if it fails.\n"                                         \
   "  -l  --log <file>         write log messages to file.\n"                                                           \
+  "      --trace <file>       record latency trace events, written to file\n"                                          \
+  "                             on exit, crash or SIGUSR2.\n"                                                          \
   "      --no-tray            disable the system tray icon.\n"                                                         \
   "      --enable-drag-drop   enable file drag & drop.\n"                                                              \
   "      --enable-crypto      enable TLS encryption.\n"                                                                \
@@ -191,6 +191,8 @@ bool ArgParser::parseGenericArgs(int argc, const char *const *argv, int &i)
     argsBase().m_logFilter = argv[++i];
   } else if (isArg(i, argc, argv, "-l", "--log", 1)) {
     argsBase().m_logFile = argv[++i];
+  } else if (isArg(i, argc, argv, nullptr, "--trace", 1)) {
+    argsBase().m_traceFile = argv[++i];
   } else if (isArg(i, argc, argv, "-f", "--no-daemon")) {
     // not a daemon
     argsBase().m_daemon = false;
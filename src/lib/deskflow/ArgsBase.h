@@ -61,6 +61,9 @@ public:
   /// @brief The full path to the logfile
   const char *m_logFile = nullptr;
 
+  /// @brief The full path to write trace events to, tracing is off if not set
+  const char *m_traceFile = nullptr;
+
   /// @brief Contains the X-Server display to use
   const char *m_display = nullptr;
 
@@ -18,6 +18,22 @@
 #include "deskflow/Chunk.h"
 #include "base/String.h"
 
+#include <zlib.h>
+
+namespace {
+
+// smaller chunks aren't worth the cost of compressing
+const size_t kMinCompressSize = 256;
+
+// chunks are sent at most 512 KiB at a time, so anything claiming to be
+// much larger than that is corrupt.
+const UInt32 kMaxDecompressedSize = 4 * 1024 * 1024;
+
+// compressed data is prefixed with the uncompressed size, big endian
+const size_t kSizePrefixLength = 4;
+
+} // namespace
+
 Chunk::Chunk(size_t size) : m_dataSize(0)
 {
   m_chunk = new char[size];
@@ -28,3 +44,58 @@ Chunk::~Chunk()
 {
   delete[] m_chunk;
 }
+
+bool Chunk::compress(const String &data, String &compressed)
+{
+  if (data.size() < kMinCompressSize || data.size() > kMaxDecompressedSize) {
+    return false;
+  }
+
+  uLongf compressedSize = compressBound(static_cast<uLong>(data.size()));
+  compressed.resize(kSizePrefixLength + compressedSize);
+
+  const auto size = static_cast<UInt32>(data.size());
+  compressed[0] = static_cast<char>((size >> 24) & 0xff);
+  compressed[1] = static_cast<char>((size >> 16) & 0xff);
+  compressed[2] = static_cast<char>((size >> 8) & 0xff);
+  compressed[3] = static_cast<char>(size & 0xff);
+
+  // favour speed, the aim is to save time on slow links not bytes.
+  int result = compress2(
+      reinterpret_cast<Bytef *>(&compressed[kSizePrefixLength]), &compressedSize,
+      reinterpret_cast<const Bytef *>(data.data()), static_cast<uLong>(data.size()), Z_BEST_SPEED
+  );
+  if (result != Z_OK) {
+    return false;
+  }
+
+  // not worth it unless it saves at least an eighth
+  if (kSizePrefixLength + compressedSize > data.size() - data.size() / 8) {
+    return false;
+  }
+
+  compressed.resize(kSizePrefixLength + compressedSize);
+  return true;
+}
+
+bool Chunk::decompress(const String &compressed, String &data)
+{
+  if (compressed.size() < kSizePrefixLength) {
+    return false;
+  }
+
+  const auto bytes = reinterpret_cast<const unsigned char *>(compressed.data());
+  const UInt32 size = (static_cast<UInt32>(bytes[0]) << 24) | (static_cast<UInt32>(bytes[1]) << 16) |
+                      (static_cast<UInt32>(bytes[2]) << 8) | static_cast<UInt32>(bytes[3]);
+  if (size > kMaxDecompressedSize) {
+    return false;
+  }
+
+  data.resize(size);
+  uLongf dataSize = size;
+  int result = uncompress(
+      reinterpret_cast<Bytef *>(&data[0]), &dataSize, bytes + kSizePrefixLength,
+      static_cast<uLong>(compressed.size() - kSizePrefixLength)
+  );
+  return result == Z_OK && dataSize == size;
+}
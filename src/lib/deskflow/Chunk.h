@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "base/String.h"
 #include "common/basic_types.h"
 #include <base/EventTypes.h>
 
@@ -31,6 +32,22 @@ public:
   Chunk &operator=(Chunk const &) = delete;
   Chunk &operator=(Chunk &&) = delete;
 
+  //! Compress chunk data
+  /*!
+  Compresses \p data into \p compressed, to be sent with the
+  \c kDataChunkCompressed mark.  Each chunk is compressed on its own, so
+  neither side holds more than a chunk of compression state.  Returns
+  false if the data is too small or doesn't compress well, e.g. when it
+  is already compressed, in which case it should be sent as is.
+  */
+  static bool compress(const String &data, String &compressed);
+
+  //! Decompress chunk data
+  /*!
+  Reverses \c compress().  Returns false if \p compressed is corrupt.
+  */
+  static bool decompress(const String &compressed, String &data);
+
 public:
   size_t m_dataSize;
   char *m_chunk;
@@ -33,6 +33,7 @@
 #include "deskflow/protocol_types.h"
 #include "net/InverseSockets/InverseSocketFactory.h"
 #include "net/NetworkAddress.h"
+#include "net/SecureSession.h"
 #include "net/SocketMultiplexer.h"
 #include "net/TCPSocketFactory.h"
 #include "net/XSocket.h"
@@ -317,18 +318,8 @@ void ClientApp::handleClientConnected(const Event &, void *)
 
 void ClientApp::handleClientFailed(const Event &e, void *)
 {
-  if ((++m_lastServerAddressIndex) < m_client->getLastResolvedAddressesCount()) {
-    std::unique_ptr<Client::FailInfo> info(static_cast<Client::FailInfo *>(e.getData()));
-
-    updateStatus(String("Failed to connect to server: ") + info->m_what + " Trying next address...");
-    LOG((CLOG_NOTE "failed to connect to server=%s, trying next address", info->m_what.c_str()));
-    if (!m_suspended) {
-      scheduleClientRestart(nextRestartTimeout());
-    }
-  } else {
-    m_lastServerAddressIndex = 0;
-    handleClientRefused(e, nullptr);
-  }
+  // every address of the server has already been tried by the client
+  handleClientRefused(e, nullptr);
 }
 
 void ClientApp::handleClientRefused(const Event &e, void *)
@@ -424,7 +415,7 @@ bool ClientApp::startClient()
       LOG((CLOG_NOTE "started client"));
     }
 
-    m_client->connect(m_lastServerAddressIndex);
+    m_client->connect();
 
     updateStatus();
     return true;
@@ -462,10 +453,11 @@ void ClientApp::stopClient()
 
 int ClientApp::mainLoop()
 {
-  // create socket multiplexer.  this must happen after daemonization
-  // on unix because threads evaporate across a fork().
+  // create socket multiplexer and file log writer.  this must happen
+  // after daemonization on unix because threads evaporate across a fork().
   SocketMultiplexer multiplexer;
   setSocketMultiplexer(&multiplexer);
+  startFileLogWriter();
 
   // start client, etc
   appUtil().startNode();
@@ -499,6 +491,7 @@ int ClientApp::mainLoop()
   // close down
   LOG((CLOG_DEBUG1 "stopping client"));
   stopClient();
+  SecureSession::cleanup();
   updateStatus();
   LOG((CLOG_NOTE "stopped client"));
 
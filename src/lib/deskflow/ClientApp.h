@@ -116,5 +116,4 @@ private:
   Client *m_client;
   deskflow::Screen *m_clientScreen;
   NetworkAddress *m_serverAddress;
-  size_t m_lastServerAddressIndex = 0;
 };
@@ -18,12 +18,67 @@
 
 #include "deskflow/Clipboard.h"
 
+#include <cstring>
+
+namespace {
+
+const std::uint64_t kHashOffset = 14695981039346656037ull;
+const std::uint64_t kHashPrime = 1099511628211ull;
+
+std::uint64_t hashMix(std::uint64_t hash, std::uint64_t value)
+{
+  hash = (hash ^ value) * kHashPrime;
+  return hash ^ (hash >> 32);
+}
+
+// FNV style hash that takes 8 bytes at a time, since clipboard data can
+// be tens of megabytes.  not suitable for anything but change detection.
+std::uint64_t hashData(const String &data)
+{
+  std::uint64_t hash = kHashOffset;
+  const char *bytes = data.data();
+  const size_t size = data.size();
+
+  size_t i = 0;
+  for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t)) {
+    std::uint64_t word;
+    memcpy(&word, bytes + i, sizeof(word));
+    hash = hashMix(hash, word);
+  }
+  for (; i < size; ++i) {
+    hash = hashMix(hash, static_cast<unsigned char>(bytes[i]));
+  }
+  return hash;
+}
+
+} // namespace
+
+//
+// ClipboardFormatInfo
+//
+
+const UInt32 ClipboardFormatInfo::kUnknownSize;
+
 //
 // Clipboard
 //
 
-Clipboard::Clipboard() : m_open(false), m_owner(false)
+Clipboard::Clipboard()
+    : m_open(false),
+      m_owner(false),
+      m_marshalledSize(0),
+      m_generation(1),
+      m_deferrable(0),
+      m_changed(false)
 {
+  for (SInt32 index = 0; index < kNumFormats; ++index) {
+    m_added[index] = false;
+    m_hashed[index] = false;
+    m_deferred[index] = false;
+    m_deferredTime[index] = 0;
+    m_removed[index] = false;
+  }
+
   open(0);
   empty();
   close();
@@ -38,11 +93,19 @@ bool Clipboard::empty()
 {
   assert(m_open);
 
-  // clear all data
+  // clear all data, but keep the data of added formats and the time of
+  // deferred formats until close() so that adding them again doesn't
+  // count as a change
   for (SInt32 index = 0; index < kNumFormats; ++index) {
-    m_data[index] = "";
-    m_added[index] = false;
+    if (m_added[index] || m_deferred[index]) {
+      m_added[index] = false;
+      m_removed[index] = true;
+    } else if (!m_removed[index]) {
+      m_data[index] = "";
+      m_hashed[index] = false;
+    }
   }
+  m_marshalledSize = 4;
 
   // save time
   m_timeOwned = m_time;
@@ -58,8 +121,43 @@ void Clipboard::add(EFormat format, const String &data)
   assert(m_open);
   assert(m_owner);
 
-  m_data[format] = data;
+  if (m_added[format]) {
+    m_marshalledSize -= 4 + 4 + m_data[format].size();
+  }
+  if ((!m_added[format] && !m_removed[format]) || m_deferred[format] || m_data[format] != data) {
+    m_data[format] = data;
+    m_hashed[format] = false;
+    m_changed = true;
+  }
   m_added[format] = true;
+  m_deferred[format] = false;
+  m_removed[format] = false;
+  m_marshalledSize += 4 + 4 + data.size();
+}
+
+bool Clipboard::addDeferred(EFormat format, Time owned)
+{
+  assert(m_open);
+  assert(m_owner);
+
+  if ((m_deferrable & (1u << format)) == 0) {
+    return false;
+  }
+
+  // the data can't be compared, so only the same owner's data is unchanged
+  if (m_added[format] || !m_removed[format] || !m_deferred[format] || m_deferredTime[format] != owned) {
+    m_changed = true;
+  }
+  if (m_added[format]) {
+    m_marshalledSize -= 4 + 4 + m_data[format].size();
+  }
+  m_data[format] = "";
+  m_hashed[format] = false;
+  m_added[format] = false;
+  m_deferred[format] = true;
+  m_deferredTime[format] = owned;
+  m_removed[format] = false;
+  return true;
 }
 
 bool Clipboard::open(Time time) const
@@ -76,6 +174,22 @@ void Clipboard::close() const
 {
   assert(m_open);
 
+  // formats that weren't added again since empty() have been removed
+  for (SInt32 index = 0; index < kNumFormats; ++index) {
+    if (m_removed[index]) {
+      m_removed[index] = false;
+      m_hashed[index] = false;
+      m_deferred[index] = false;
+      m_changed = true;
+    }
+  }
+  if (m_changed) {
+    m_changed = false;
+    if (++m_generation == 0) {
+      m_generation = 1;
+    }
+  }
+
   m_open = false;
 }
 
@@ -87,21 +201,139 @@ Clipboard::Time Clipboard::getTime() const
 bool Clipboard::has(EFormat format) const
 {
   assert(m_open);
-  return m_added[format];
+  return m_added[format] || isDeferred(format);
 }
 
 String Clipboard::get(EFormat format) const
 {
   assert(m_open);
+  if (!m_added[format]) {
+    return String();
+  }
   return m_data[format];
 }
 
+bool Clipboard::isDeferred(EFormat format) const
+{
+  assert(m_open);
+  return m_deferred[format] && !m_removed[format];
+}
+
 void Clipboard::unmarshall(const String &data, Time time)
 {
   IClipboard::unmarshall(this, data, time);
 }
 
+void Clipboard::setDeferrableFormats(UInt32 formats)
+{
+  m_deferrable = formats;
+}
+
+bool Clipboard::resolve(const Clipboard &source, UInt32 formats, size_t maxMarshalledSize)
+{
+  assert(!m_open);
+
+  formats &= getDeferredFormats();
+  size_t size = m_marshalledSize;
+  for (SInt32 index = 0; index < kNumFormats; ++index) {
+    if ((formats & (1u << index)) != 0 && source.m_added[index]) {
+      size += 4 + 4 + source.m_data[index].size();
+    }
+  }
+  if (size > maxMarshalledSize) {
+    return false;
+  }
+
+  for (SInt32 index = 0; index < kNumFormats; ++index) {
+    if ((formats & (1u << index)) == 0 || source.m_deferred[index]) {
+      continue;
+    }
+    m_deferred[index] = false;
+    if (source.m_added[index]) {
+      m_added[index] = true;
+      m_data[index] = source.m_data[index];
+      m_hashed[index] = false;
+    }
+  }
+  m_marshalledSize = size;
+  return true;
+}
+
 String Clipboard::marshall() const
 {
   return IClipboard::marshall(this);
 }
+
+String Clipboard::marshall(UInt32 formats) const
+{
+  return IClipboard::marshall(this, formats);
+}
+
+size_t Clipboard::getMarshalledSize() const
+{
+  // format count, then format id, size and data for each format
+  return m_marshalledSize;
+}
+
+UInt32 Clipboard::getDeferredFormats() const
+{
+  UInt32 formats = 0;
+  for (SInt32 index = 0; index < kNumFormats; ++index) {
+    if (m_deferred[index]) {
+      formats |= 1u << index;
+    }
+  }
+  return formats;
+}
+
+UInt32 Clipboard::getGeneration() const
+{
+  return m_generation;
+}
+
+std::uint64_t Clipboard::getDigest() const
+{
+  std::uint64_t digest = kHashOffset;
+  for (SInt32 index = 0; index < kNumFormats; ++index) {
+    if (m_deferred[index]) {
+      digest = hashMix(digest, static_cast<std::uint64_t>(index));
+      digest = hashMix(digest, m_deferredTime[index]);
+      continue;
+    }
+    if (!m_added[index]) {
+      continue;
+    }
+
+    digest = hashMix(digest, static_cast<std::uint64_t>(index));
+    digest = hashMix(digest, m_data[index].size());
+    digest = hashMix(digest, getHash(static_cast<EFormat>(index)));
+  }
+  return digest;
+}
+
+std::uint64_t Clipboard::getHash(EFormat format) const
+{
+  if (!m_added[format]) {
+    return 0;
+  }
+
+  if (!m_hashed[format]) {
+    m_hash[format] = hashData(m_data[format]);
+    m_hashed[format] = true;
+  }
+  return m_hash[format];
+}
+
+std::vector<ClipboardFormatInfo> Clipboard::getFormatInfo() const
+{
+  std::vector<ClipboardFormatInfo> formats;
+  for (SInt32 index = 0; index < kNumFormats; ++index) {
+    const auto format = static_cast<EFormat>(index);
+    if (m_deferred[index]) {
+      formats.push_back({format, ClipboardFormatInfo::kUnknownSize, 0});
+    } else if (m_added[index]) {
+      formats.push_back({format, static_cast<UInt32>(m_data[index].size()), getHash(format)});
+    }
+  }
+  return formats;
+}
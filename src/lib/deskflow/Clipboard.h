@@ -20,6 +20,25 @@
 
 #include "deskflow/IClipboard.h"
 
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+//! Clipboard format summary
+/*!
+The size and a hash of the data of one clipboard format, so that the
+format can be advertised and compared without its data.  A deferred
+format has size \c kUnknownSize and hash 0.
+*/
+struct ClipboardFormatInfo
+{
+  static const UInt32 kUnknownSize = 0xffffffff;
+
+  IClipboard::EFormat m_format;
+  UInt32 m_size;
+  std::uint64_t m_hash;
+};
+
 //! Memory buffer clipboard
 /*!
 This class implements a clipboard that stores data in memory.
@@ -40,6 +59,29 @@ public:
   */
   void unmarshall(const String &data, Time time);
 
+  //! Set deferrable formats
+  /*!
+  Formats with their bit (\c 1 << format) set in \p formats are
+  deferred when copied from a clipboard that hasn't read them yet,
+  rather than read from it.  None are by default.
+  */
+  void setDeferrableFormats(UInt32 formats);
+
+  //! Resolve deferred formats
+  /*!
+  Fills in the deferred formats with their bit (\c 1 << format) set in
+  \p formats from \p source, which should be a copy of the same
+  clipboard that has read them.  Formats \p source doesn't have are
+  removed and formats it still defers stay deferred.  This
+  doesn't change the generation since the content is the same.  If the
+  marshalled size would exceed \p maxMarshalledSize nothing changes and
+  this returns false.  Must not be called while the clipboard is open.
+  */
+  bool resolve(
+      const Clipboard &source, UInt32 formats = kAllFormats,
+      size_t maxMarshalledSize = std::numeric_limits<size_t>::max()
+  );
+
   //@}
   //! @name accessors
   //@{
@@ -51,16 +93,72 @@ public:
   */
   String marshall() const;
 
+  //! Marshall some clipboard data
+  /*!
+  Like \c marshall() but only includes the formats with their bit
+  (\c 1 << format) set in \p formats.
+  */
+  String marshall(UInt32 formats) const;
+
+  //! Get marshalled size
+  /*!
+  Returns the size of the buffer \c marshall() would return, without
+  building it.  The size is kept up to date as formats are added.
+  Deferred formats aren't counted.
+  */
+  size_t getMarshalledSize() const;
+
+  //! Get deferred formats
+  /*!
+  Returns the formats the clipboard has but hasn't read yet, with bit
+  \c 1 << format set for each.
+  */
+  UInt32 getDeferredFormats() const;
+
+  //! Get generation
+  /*!
+  Returns a number that changes whenever the clipboard's content
+  changes.  Emptying the clipboard and adding the same data again, as
+  copying an unchanged clipboard does, keeps the generation.  So does
+  deferring a format again with the same timestamp.  It's never 0.
+  */
+  UInt32 getGeneration() const;
+
+  //! Get content digest
+  /*!
+  Returns a value that combines the size and a hash of the data of each
+  format the clipboard has, so that a change of content can be detected
+  without keeping or comparing a copy of the data.  The hash of each
+  format is only computed the first time it's needed after the format
+  is added.
+  */
+  std::uint64_t getDigest() const;
+
+  //! Get format hash
+  /*!
+  Returns the hash of the data of \p format, as used by \c getDigest(),
+  or 0 if the clipboard doesn't have the format's data.
+  */
+  std::uint64_t getHash(EFormat format) const;
+
+  //! Get format summaries
+  /*!
+  Returns the size and hash of each format the clipboard has.
+  */
+  std::vector<ClipboardFormatInfo> getFormatInfo() const;
+
   //@}
 
   // IClipboard overrides
   virtual bool empty();
   virtual void add(EFormat, const String &data);
+  virtual bool addDeferred(EFormat, Time owned);
   virtual bool open(Time) const;
   virtual void close() const;
   virtual Time getTime() const;
   virtual bool has(EFormat) const;
   virtual String get(EFormat) const;
+  virtual bool isDeferred(EFormat) const;
 
 private:
   mutable bool m_open;
@@ -69,4 +167,17 @@ private:
   Time m_timeOwned;
   bool m_added[kNumFormats];
   String m_data[kNumFormats];
+  mutable bool m_hashed[kNumFormats];
+  mutable std::uint64_t m_hash[kNumFormats];
+  size_t m_marshalledSize;
+  mutable UInt32 m_generation;
+  UInt32 m_deferrable;
+  mutable bool m_deferred[kNumFormats];
+  Time m_deferredTime[kNumFormats];
+
+  // between empty() and close(), the formats that haven't been added
+  // or deferred again yet.  their data (or deferred time) is kept to
+  // compare with until the next empty().
+  mutable bool m_removed[kNumFormats];
+  mutable bool m_changed;
 };
@@ -90,6 +90,14 @@ int ClipboardChunk::assemble(deskflow::IStream *stream, String &dataCached, Clip
   } else if (mark == kDataChunk) {
     dataCached.append(data);
     return kNotFinish;
+  } else if (mark == kDataChunkCompressed) {
+    String decompressed;
+    if (!Chunk::decompress(data, decompressed)) {
+      LOG((CLOG_ERR "corrupted compressed clipboard chunk"));
+      return kError;
+    }
+    dataCached.append(decompressed);
+    return kNotFinish;
   } else if (mark == kDataEnd) {
     // validate
     if (id >= kClipboardEnd) {
@@ -105,7 +113,7 @@ int ClipboardChunk::assemble(deskflow::IStream *stream, String &dataCached, Clip
   return kError;
 }
 
-void ClipboardChunk::send(deskflow::IStream *stream, void *data)
+void ClipboardChunk::send(deskflow::IStream *stream, void *data, bool compress)
 {
   ClipboardChunk *clipboardData = static_cast<ClipboardChunk *>(data);
 
@@ -118,12 +126,22 @@ void ClipboardChunk::send(deskflow::IStream *stream, void *data)
   UInt8 mark = chunk[5];
   String dataChunk(&chunk[6], clipboardData->m_dataSize);
 
+  if (compress && mark == kDataChunk) {
+    String compressed;
+    if (Chunk::compress(dataChunk, compressed)) {
+      LOG((CLOG_DEBUG2 "compressed clipboard chunk: size=%i compressed=%i", dataChunk.size(), compressed.size()));
+      dataChunk.swap(compressed);
+      mark = kDataChunkCompressed;
+    }
+  }
+
   switch (mark) {
   case kDataStart:
     LOG((CLOG_DEBUG2 "sending clipboard chunk start: size=%s", dataChunk.c_str()));
     break;
 
   case kDataChunk:
+  case kDataChunkCompressed:
     LOG((CLOG_DEBUG2 "sending clipboard chunk data: size=%i", dataChunk.size()));
     break;
 
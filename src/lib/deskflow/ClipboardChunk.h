@@ -39,7 +39,7 @@ public:
 
   static int assemble(deskflow::IStream *stream, String &dataCached, ClipboardID &id, UInt32 &sequence);
 
-  static void send(deskflow::IStream *stream, void *data);
+  static void send(deskflow::IStream *stream, void *data, bool compress = false);
 
   static size_t getExpectedSize()
   {
@@ -76,6 +76,16 @@ int FileChunk::assemble(deskflow::IStream *stream, String &dataReceived, size_t
     return kError;
   }
 
+  if (mark == kDataChunkCompressed) {
+    String decompressed;
+    if (!Chunk::decompress(content, decompressed)) {
+      LOG((CLOG_ERR "corrupted compressed file chunk"));
+      return kError;
+    }
+    content.swap(decompressed);
+    mark = kDataChunk;
+  }
+
   switch (mark) {
   case kDataStart:
     dataReceived.clear();
@@ -128,16 +138,33 @@ int FileChunk::assemble(deskflow::IStream *stream, String &dataReceived, size_t
   return kError;
 }
 
-void FileChunk::send(deskflow::IStream *stream, UInt8 mark, char *data, size_t dataSize)
+void FileChunk::send(deskflow::IStream *stream, UInt8 mark, char *data, size_t dataSize, Compression *compression)
 {
   String chunk(data, dataSize);
 
+  // chunks are only compressed if the receiver supports it
+  if (compression == NULL) {
+    // send as is
+  } else if (mark == kDataStart) {
+    compression->m_incompressible = false;
+  } else if (mark == kDataChunk && !compression->m_incompressible) {
+    String compressed;
+    if (Chunk::compress(chunk, compressed)) {
+      LOG((CLOG_DEBUG2 "compressed file chunk: size=%i compressed=%i", chunk.size(), compressed.size()));
+      chunk.swap(compressed);
+      mark = kDataChunkCompressed;
+    } else {
+      compression->m_incompressible = true;
+    }
+  }
+
   switch (mark) {
   case kDataStart:
     LOG((CLOG_DEBUG2 "sending file chunk start: size=%s", data));
     break;
 
   case kDataChunk:
+  case kDataChunkCompressed:
     LOG((CLOG_DEBUG2 "sending file chunk: size=%i", chunk.size()));
     break;
 
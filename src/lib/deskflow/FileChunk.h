@@ -30,11 +30,23 @@ class IStream;
 class FileChunk : public Chunk
 {
 public:
+  //! Compression state of a file transfer
+  /*!
+  Each sender keeps one for the file it's sending.  Once a chunk of the
+  file doesn't compress, the file is most likely already compressed and
+  the rest of it is sent as is.  The start chunk resets it.
+  */
+  class Compression
+  {
+  public:
+    bool m_incompressible = false;
+  };
+
   FileChunk(size_t size);
 
   static FileChunk *start(const String &size);
   static FileChunk *data(UInt8 *data, size_t dataSize);
   static FileChunk *end();
   static int assemble(deskflow::IStream *stream, String &dataCached, size_t &expectedSize);
-  static void send(deskflow::IStream *stream, UInt8 mark, char *data, size_t dataSize);
+  static void send(deskflow::IStream *stream, UInt8 mark, char *data, size_t dataSize, Compression *compression = NULL);
 };
@@ -161,7 +161,7 @@ public:
   /*!
   Return the client's name.
   */
-  virtual String getName() const = 0;
+  virtual const String &getName() const = 0;
 
   //@}
 
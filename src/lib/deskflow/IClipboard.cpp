@@ -80,6 +80,11 @@ void IClipboard::unmarshall(IClipboard *clipboard, const String &data, Time time
 }
 
 String IClipboard::marshall(const IClipboard *clipboard)
+{
+  return marshall(clipboard, kAllFormats);
+}
+
+String IClipboard::marshall(const IClipboard *clipboard, UInt32 formats)
 {
   // return data format:
   // 4 bytes => number of formats included
@@ -101,7 +106,7 @@ String IClipboard::marshall(const IClipboard *clipboard)
     UInt32 size = 4;
     UInt32 numFormats = 0;
     for (UInt32 format = 0; format != IClipboard::kNumFormats; ++format) {
-      if (clipboard->has(static_cast<IClipboard::EFormat>(format))) {
+      if ((formats & (1u << format)) != 0 && hasData(clipboard, static_cast<IClipboard::EFormat>(format))) {
         ++numFormats;
         formatData[format] = clipboard->get(static_cast<IClipboard::EFormat>(format));
         size += 4 + 4 + (UInt32)formatData[format].size();
@@ -114,7 +119,7 @@ String IClipboard::marshall(const IClipboard *clipboard)
     // marshall the data
     writeUInt32(&data, numFormats);
     for (UInt32 format = 0; format != IClipboard::kNumFormats; ++format) {
-      if (clipboard->has(static_cast<IClipboard::EFormat>(format))) {
+      if ((formats & (1u << format)) != 0 && hasData(clipboard, static_cast<IClipboard::EFormat>(format))) {
         writeUInt32(&data, format);
         writeUInt32(&data, (UInt32)formatData[format].size());
         data += formatData[format];
@@ -145,7 +150,10 @@ bool IClipboard::copy(IClipboard *dst, const IClipboard *src, Time time)
       if (dst->empty()) {
         for (SInt32 format = 0; format != IClipboard::kNumFormats; ++format) {
           IClipboard::EFormat eFormat = (IClipboard::EFormat)format;
-          if (src->has(eFormat)) {
+          if (!src->has(eFormat)) {
+            continue;
+          }
+          if (!src->isDeferred(eFormat) || !dst->addDeferred(eFormat, src->getTime())) {
             dst->add(eFormat, src->get(eFormat));
           }
         }
@@ -159,6 +167,21 @@ bool IClipboard::copy(IClipboard *dst, const IClipboard *src, Time time)
   return success;
 }
 
+bool IClipboard::addDeferred(EFormat, Time)
+{
+  return false;
+}
+
+bool IClipboard::isDeferred(EFormat) const
+{
+  return false;
+}
+
+bool IClipboard::hasData(const IClipboard *clipboard, EFormat format)
+{
+  return clipboard->has(format) && !clipboard->isDeferred(format);
+}
+
 UInt32 IClipboard::readUInt32(const char *buf)
 {
   const unsigned char *ubuf = reinterpret_cast<const unsigned char *>(buf);
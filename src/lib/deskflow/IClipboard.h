@@ -64,6 +64,9 @@ public:
     kNumFormats //!< The number of clipboard formats
   };
 
+  //! Mask of all clipboard formats, with bit \c 1 << format for each format
+  static const UInt32 kAllFormats = (1u << kNumFormats) - 1;
+
   //! @name manipulators
   //@{
 
@@ -83,6 +86,17 @@ public:
   */
   virtual void add(EFormat, const String &data) = 0;
 
+  //! Add deferred data
+  /*!
+  Record that the source clipboard has data in the given format
+  without reading the data yet.  \c owned identifies that data, it's
+  the source's timestamp when the data was taken.  Returns false if
+  this clipboard can't defer the format, in which case the caller must
+  add() the data instead.  May only be called after a successful
+  empty().  The default returns false.
+  */
+  virtual bool addDeferred(EFormat, Time owned);
+
   //@}
   //! @name accessors
   //@{
@@ -129,13 +143,30 @@ public:
   */
   virtual String get(EFormat) const = 0;
 
+  //! Check for deferred data
+  /*!
+  Return true iff the clipboard has data in the given format that
+  hasn't been read yet, so that get() would have to fetch it.  Must
+  be called between a successful open() and close().  The default
+  returns false.
+  */
+  virtual bool isDeferred(EFormat) const;
+
   //! Marshall clipboard data
   /*!
   Merge \p clipboard's data into a single buffer that can be later
   unmarshalled to restore the clipboard and return the buffer.
+  Deferred formats are left out.
   */
   static String marshall(const IClipboard *clipboard);
 
+  //! Marshall some clipboard data
+  /*!
+  Like \c marshall() but only includes the formats with their bit
+  (\c 1 << format) set in \p formats.
+  */
+  static String marshall(const IClipboard *clipboard, UInt32 formats);
+
   //! Unmarshall clipboard data
   /*!
   Extract marshalled clipboard data and store it in \p clipboard.
@@ -149,7 +180,9 @@ public:
   clipboards can be of any concrete clipboard type (and
   they don't have to be the same type).  This also sets
   the destination clipboard's timestamp to source clipboard's
-  timestamp.  Returns true iff the copy succeeded.
+  timestamp.  Formats the source hasn't read yet stay deferred
+  if the destination can defer them.  Returns true iff the copy
+  succeeded.
   */
   static bool copy(IClipboard *dst, const IClipboard *src);
 
@@ -165,6 +198,7 @@ public:
   //@}
 
 private:
+  static bool hasData(const IClipboard *, EFormat);
   static UInt32 readUInt32(const char *);
   static void writeUInt32(String *, UInt32);
 };
@@ -87,6 +87,15 @@ public:
   */
   virtual bool setClipboard(ClipboardID id, const IClipboard *) = 0;
 
+  //! Resolve deferred clipboard formats
+  /*!
+  Supply the data of the formats that were deferred when the system
+  clipboard indicated by \c id was set.  Applications waiting for a
+  format \c clipboard has get its data, those waiting for a format it
+  doesn't have at all are refused.
+  */
+  virtual void resolveClipboard(ClipboardID id, const IClipboard *clipboard) = 0;
+
   //! Check clipboard owner
   /*!
   Check ownership of all clipboards and post grab events for any that
@@ -158,6 +167,14 @@ public:
   */
   virtual bool isPrimary() const = 0;
 
+  //! Get deferrable clipboard formats
+  /*!
+  Return the clipboard formats (bit \c 1 << format) that setClipboard()
+  can leave deferred.  The screen sends a clipboard requested event
+  when an application asks for one, and resolveClipboard() supplies it.
+  */
+  virtual UInt32 getDeferrableClipboardFormats() const = 0;
+
   //@}
 
   // IScreen overrides
@@ -39,6 +39,13 @@ public:
     UInt32 m_sequenceNumber;
   };
 
+  struct ClipboardRequestInfo
+  {
+  public:
+    ClipboardID m_id;
+    UInt32 m_formats;
+  };
+
   //! @name accessors
   //@{
 
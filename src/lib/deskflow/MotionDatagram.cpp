@@ -0,0 +1,173 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "deskflow/MotionDatagram.h"
+
+#include <cstring>
+#include <memory>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+
+namespace {
+
+// magic, channel, sequence number, kind and fence count, authenticated
+// but not encrypted
+const size_t kHeaderSize = 2 + 4 + 4 + 1 + 4;
+// x and y, encrypted
+const size_t kBodySize = 4 + 4;
+const size_t kTagSize = 16;
+const size_t kDatagramSize = kHeaderSize + kBodySize + kTagSize;
+const size_t kNonceSize = 12;
+const char kMagic[2] = {'D', 'M'};
+
+using CipherContext = std::unique_ptr<EVP_CIPHER_CTX, decltype(&EVP_CIPHER_CTX_free)>;
+
+void write4(unsigned char *p, UInt32 v)
+{
+  p[0] = static_cast<unsigned char>(v >> 24);
+  p[1] = static_cast<unsigned char>(v >> 16);
+  p[2] = static_cast<unsigned char>(v >> 8);
+  p[3] = static_cast<unsigned char>(v);
+}
+
+UInt32 read4(const unsigned char *p)
+{
+  return (static_cast<UInt32>(p[0]) << 24) | (static_cast<UInt32>(p[1]) << 16) | (static_cast<UInt32>(p[2]) << 8) |
+         static_cast<UInt32>(p[3]);
+}
+
+// the direction keeps the two sides' sequence numbers apart
+void makeNonce(unsigned char *nonce, UInt32 channel, UInt32 seq, bool fromPrimary)
+{
+  nonce[0] = fromPrimary ? 1 : 2;
+  nonce[1] = nonce[2] = nonce[3] = 0;
+  write4(nonce + 4, channel);
+  write4(nonce + 8, seq);
+}
+
+bool initCipher(EVP_CIPHER_CTX *ctx, const String &key, const unsigned char *nonce, bool encrypt)
+{
+  if (key.size() != MotionDatagram::kKeySize) {
+    return false;
+  }
+  const auto keyData = reinterpret_cast<const unsigned char *>(key.data());
+  return EVP_CipherInit_ex(ctx, EVP_aes_128_gcm(), nullptr, nullptr, nullptr, encrypt ? 1 : 0) > 0 &&
+         EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_IVLEN, kNonceSize, nullptr) > 0 &&
+         EVP_CipherInit_ex(ctx, nullptr, nullptr, keyData, nonce, -1) > 0;
+}
+
+} // namespace
+
+//
+// MotionDatagram
+//
+
+MotionDatagram::MotionDatagram(UInt32 channel, UInt32 seq, EKind kind, SInt32 x, SInt32 y, UInt32 fence)
+    : m_channel(channel),
+      m_seq(seq),
+      m_kind(kind),
+      m_x(x),
+      m_y(y),
+      m_fence(fence)
+{
+  // nothing
+}
+
+bool MotionDatagram::open(const String &datagram, const String &key, bool fromPrimary)
+{
+  UInt32 channel;
+  if (datagram.size() != kDatagramSize || !peekChannel(datagram, channel)) {
+    return false;
+  }
+
+  const auto data = reinterpret_cast<const unsigned char *>(datagram.data());
+  const UInt32 seq = read4(data + 6);
+  const UInt8 kind = data[10];
+  if (kind > kRelative) {
+    return false;
+  }
+
+  unsigned char nonce[kNonceSize];
+  makeNonce(nonce, channel, seq, fromPrimary);
+
+  CipherContext ctx(EVP_CIPHER_CTX_new(), &EVP_CIPHER_CTX_free);
+  unsigned char body[kBodySize];
+  unsigned char tag[kTagSize];
+  memcpy(tag, data + kHeaderSize + kBodySize, kTagSize);
+  int n = 0;
+  if (!ctx || !initCipher(ctx.get(), key, nonce, false) ||
+      EVP_DecryptUpdate(ctx.get(), nullptr, &n, data, kHeaderSize) <= 0 ||
+      EVP_DecryptUpdate(ctx.get(), body, &n, data + kHeaderSize, kBodySize) <= 0 ||
+      EVP_CIPHER_CTX_ctrl(ctx.get(), EVP_CTRL_GCM_SET_TAG, kTagSize, tag) <= 0 ||
+      EVP_DecryptFinal_ex(ctx.get(), body + n, &n) <= 0) {
+    return false;
+  }
+
+  m_channel = channel;
+  m_seq = seq;
+  m_kind = static_cast<EKind>(kind);
+  m_x = static_cast<SInt32>(read4(body));
+  m_y = static_cast<SInt32>(read4(body + 4));
+  m_fence = read4(data + 11);
+  return true;
+}
+
+String MotionDatagram::seal(const String &key, bool fromPrimary) const
+{
+  unsigned char data[kDatagramSize];
+  memcpy(data, kMagic, sizeof(kMagic));
+  write4(data + 2, m_channel);
+  write4(data + 6, m_seq);
+  data[10] = m_kind;
+  write4(data + 11, m_fence);
+
+  unsigned char body[kBodySize];
+  write4(body, static_cast<UInt32>(m_x));
+  write4(body + 4, static_cast<UInt32>(m_y));
+
+  unsigned char nonce[kNonceSize];
+  makeNonce(nonce, m_channel, m_seq, fromPrimary);
+
+  CipherContext ctx(EVP_CIPHER_CTX_new(), &EVP_CIPHER_CTX_free);
+  int n = 0;
+  if (!ctx || !initCipher(ctx.get(), key, nonce, true) ||
+      EVP_EncryptUpdate(ctx.get(), nullptr, &n, data, kHeaderSize) <= 0 ||
+      EVP_EncryptUpdate(ctx.get(), data + kHeaderSize, &n, body, kBodySize) <= 0 ||
+      EVP_EncryptFinal_ex(ctx.get(), data + kHeaderSize + n, &n) <= 0 ||
+      EVP_CIPHER_CTX_ctrl(ctx.get(), EVP_CTRL_GCM_GET_TAG, kTagSize, data + kHeaderSize + kBodySize) <= 0) {
+    return String();
+  }
+  return String(reinterpret_cast<const char *>(data), kDatagramSize);
+}
+
+bool MotionDatagram::peekChannel(const String &datagram, UInt32 &channel)
+{
+  if (datagram.size() != kDatagramSize || datagram.compare(0, sizeof(kMagic), kMagic, sizeof(kMagic)) != 0) {
+    return false;
+  }
+  channel = read4(reinterpret_cast<const unsigned char *>(datagram.data()) + 2);
+  return true;
+}
+
+String MotionDatagram::newKey()
+{
+  unsigned char key[kKeySize];
+  if (RAND_bytes(key, sizeof(key)) <= 0) {
+    return String();
+  }
+  return String(reinterpret_cast<const char *>(key), sizeof(key));
+}
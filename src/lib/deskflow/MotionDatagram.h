@@ -0,0 +1,102 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "base/String.h"
+#include "common/basic_types.h"
+
+//! Mouse motion datagram
+/*!
+A message on the UDP motion channel offered with \c kMsgDMotionChannel.
+The primary sends motion to the secondary; the secondary sends
+\c kRegister messages to the primary so it knows where to send them.
+
+Datagrams are encrypted and authenticated with AES-128-GCM using the
+channel's key, which is only ever sent over the TCP connection, so they
+are as private as that connection.  The channel id and sequence number
+are sent in the clear, and together with the direction they form the
+nonce, so each side must never reuse a sequence number with a key.
+
+Relative motion carries the total of all relative motion sent on the
+channel rather than a delta, so that the receiver can skip lost and
+late datagrams and only apply the newest.
+
+Each datagram also carries the number of motion fences sent over TCP
+before it, so that the receiver can hold it back until it has read the
+messages that were sent ahead of it.
+*/
+class MotionDatagram
+{
+public:
+  enum EKind : UInt8
+  {
+    kRegister, //!< Secondary is listening, x and y are unused
+    kAbsolute, //!< Absolute position
+    kRelative  //!< Total relative motion so far
+  };
+
+  MotionDatagram() = default;
+  MotionDatagram(UInt32 channel, UInt32 seq, EKind kind, SInt32 x = 0, SInt32 y = 0, UInt32 fence = 0);
+
+  //! @name manipulators
+  //@{
+
+  //! Decode a datagram
+  /*!
+  Decodes \p datagram, which was sent by the primary if \p fromPrimary
+  is true.  Returns false if it isn't a valid datagram encrypted with
+  \p key in that direction.
+  */
+  bool open(const String &datagram, const String &key, bool fromPrimary);
+
+  //@}
+  //! @name accessors
+  //@{
+
+  //! Encode a datagram
+  /*!
+  Returns the datagram encrypted with \p key, to be sent by the primary
+  if \p fromPrimary is true.  Returns an empty string on failure.
+  */
+  String seal(const String &key, bool fromPrimary) const;
+
+  //! Get the channel a datagram claims to be for
+  /*!
+  Reads the channel id without authenticating the datagram, to find the
+  key to open it with.  Returns false if it isn't a motion datagram.
+  */
+  static bool peekChannel(const String &datagram, UInt32 &channel);
+
+  //! Generate a channel key
+  /*!
+  Returns a new random key, or an empty string on failure.
+  */
+  static String newKey();
+
+  //@}
+
+  static const size_t kKeySize = 16;
+
+public:
+  UInt32 m_channel = 0;
+  UInt32 m_seq = 0;
+  EKind m_kind = kRegister;
+  SInt32 m_x = 0;
+  SInt32 m_y = 0;
+  UInt32 m_fence = 0;
+};
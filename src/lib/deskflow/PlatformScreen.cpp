@@ -104,6 +104,16 @@ void PlatformScreen::clearStaleModifiers()
   getKeyState()->clearStaleModifiers();
 }
 
+void PlatformScreen::resolveClipboard(ClipboardID, const IClipboard *)
+{
+  // do nothing, no formats are deferred
+}
+
+UInt32 PlatformScreen::getDeferrableClipboardFormats() const
+{
+  return 0;
+}
+
 bool PlatformScreen::isDraggingStarted()
 {
   if (App::instance().argsBase().m_enableDragDrop) {
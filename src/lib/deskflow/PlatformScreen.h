@@ -100,6 +100,7 @@ public:
   virtual bool canLeave() = 0;
   virtual void leave() = 0;
   virtual bool setClipboard(ClipboardID, const IClipboard *) = 0;
+  virtual void resolveClipboard(ClipboardID, const IClipboard *);
   virtual void checkClipboards() = 0;
   virtual void openScreensaver(bool notify) = 0;
   virtual void closeScreensaver() = 0;
@@ -108,6 +109,7 @@ public:
   virtual void setOptions(const OptionsList &options) = 0;
   virtual void setSequenceNumber(UInt32) = 0;
   virtual bool isPrimary() const = 0;
+  virtual UInt32 getDeferrableClipboardFormats() const;
 
   virtual void fakeDraggingFiles(DragFileList fileList)
   {
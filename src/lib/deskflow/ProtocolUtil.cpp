@@ -91,6 +91,21 @@ void ProtocolUtil::writef(deskflow::IStream *stream, const char *fmt, ...)
   va_end(args);
 }
 
+void ProtocolUtil::formatf(std::vector<UInt8> &buffer, const char *fmt, ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  vformatf(buffer, fmt, args);
+  va_end(args);
+}
+
+void ProtocolUtil::vformatf(std::vector<UInt8> &buffer, const char *fmt, va_list args)
+{
+  assert(fmt != NULL);
+  LOG((CLOG_DEBUG2 "formatf(%s)", fmt));
+  writef(buffer, fmt, args);
+}
+
 bool ProtocolUtil::readf(deskflow::IStream *stream, const char *fmt, ...)
 {
   bool result = false;
@@ -55,6 +55,20 @@ public:
   */
   static void writef(deskflow::IStream *, const char *fmt, ...);
 
+  //! Format data
+  /*!
+  Same as writef() but appends the data to \c buffer instead of writing
+  it to a stream, so a message written to many streams is only
+  formatted once.
+  */
+  static void formatf(std::vector<UInt8> &buffer, const char *fmt, ...);
+
+  //! Format data
+  /*!
+  Same as formatf() but takes a va_list.
+  */
+  static void vformatf(std::vector<UInt8> &buffer, const char *fmt, va_list);
+
   //! Read formatted data
   /*!
   Read formatted binary data from a buffer.  This performs the
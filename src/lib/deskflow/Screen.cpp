@@ -188,6 +188,11 @@ void Screen::setClipboard(ClipboardID id, const IClipboard *clipboard)
   m_screen->setClipboard(id, clipboard);
 }
 
+void Screen::resolveClipboard(ClipboardID id, const IClipboard *clipboard)
+{
+  m_screen->resolveClipboard(id, clipboard);
+}
+
 void Screen::grabClipboard(ClipboardID id)
 {
   m_screen->setClipboard(id, NULL);
@@ -415,6 +420,11 @@ const String &Screen::getDropTarget() const
   return m_screen->getDropTarget();
 }
 
+UInt32 Screen::getDeferrableClipboardFormats() const
+{
+  return m_screen->getDeferrableClipboardFormats();
+}
+
 void *Screen::getEventTarget() const
 {
   return m_screen;
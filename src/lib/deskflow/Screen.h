@@ -49,7 +49,7 @@ public:
   Screen &operator&(Screen &&) = delete;
 
 #ifdef TEST_ENV
-  Screen() : m_mock(true)
+  Screen() : m_screen(NULL), m_mock(true)
   {
   }
 #endif
@@ -108,6 +108,13 @@ public:
   */
   void setClipboard(ClipboardID, const IClipboard *);
 
+  //! Resolve deferred clipboard formats
+  /*!
+  Supplies the data of clipboard formats that were deferred when the
+  clipboard was set.
+  */
+  void resolveClipboard(ClipboardID, const IClipboard *);
+
   //! Grab clipboard
   /*!
   Grabs (i.e. take ownership of) the system clipboard.
@@ -306,6 +313,13 @@ public:
   //! Get the drop target directory
   const String &getDropTarget() const;
 
+  //! Get deferrable clipboard formats
+  /*!
+  Returns the clipboard formats (bit \c 1 << format) that
+  setClipboard() can leave deferred until an application asks for them.
+  */
+  UInt32 getDeferrableClipboardFormats() const;
+
   //@}
 
   // IScreen overrides
@@ -23,13 +23,16 @@
 #include "base/Log.h"
 #include "base/Path.h"
 #include "base/TMethodEventJob.h"
+#include "base/TMethodJob.h"
 #include "deskflow/App.h"
 #include "deskflow/ArgParser.h"
 #include "deskflow/Screen.h"
 #include "deskflow/ServerArgs.h"
 #include "deskflow/ServerTaskBarReceiver.h"
 #include "deskflow/XScreen.h"
+#include "mt/Thread.h"
 #include "net/InverseSockets/InverseSocketFactory.h"
+#include "net/SecureSession.h"
 #include "net/SocketMultiplexer.h"
 #include "net/TCPSocketFactory.h"
 #include "net/XSocket.h"
@@ -64,11 +67,6 @@
 #include "platform/wayland.h"
 #endif
 
-#if defined(MAC_OS_X_VERSION_10_7)
-#include "base/TMethodJob.h"
-#include "mt/Thread.h"
-#endif
-
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -88,7 +86,10 @@ ServerApp::ServerApp(IEventQueue *events, CreateTaskBarReceiverFunc createTaskBa
       m_primaryClient(NULL),
       m_listener(NULL),
       m_timer(NULL),
-      m_deskflowAddress(NULL)
+      m_deskflowAddress(NULL),
+      m_reloadThread(NULL),
+      m_reloadedConfig(NULL),
+      m_reloadPending(false)
 {
 }
 
@@ -176,15 +177,74 @@ void ServerApp::reloadSignalHandler(Arch::ESignal, void *)
 
 void ServerApp::reloadConfig(const Event &, void *)
 {
+  // a reload asked for while the file is being read starts again once
+  // the read is done, so it sees the latest file
+  if (m_reloadThread != NULL) {
+    m_reloadPending = true;
+    return;
+  }
+
+  // read the file on another thread so input isn't held up, then apply
+  // it on this one
   LOG((CLOG_DEBUG "reload configuration"));
-  if (loadConfig(args().m_configFile)) {
+  m_reloadedConfig = new ServerConfig(m_events);
+  m_reloadThread = new Thread(new TMethodJob<ServerApp>(this, &ServerApp::readConfigThread));
+}
+
+void ServerApp::readConfigThread(void *)
+{
+  if (!readConfig(args().m_configFile, *m_reloadedConfig)) {
+    delete m_reloadedConfig;
+    m_reloadedConfig = NULL;
+  }
+  m_events->addEvent(Event(m_events->forServerApp().configRead(), m_events->getSystemTarget()));
+}
+
+void ServerApp::handleConfigRead(const Event &, void *)
+{
+  if (m_reloadThread == NULL) {
+    return;
+  }
+  m_reloadThread->wait();
+  delete m_reloadThread;
+  m_reloadThread = NULL;
+
+  if (m_reloadedConfig != NULL) {
+    // the server only applies the parts that changed
+    bool applied = true;
     if (m_server != NULL) {
-      m_server->setConfig(*args().m_config);
+      applied = m_server->setConfig(*m_reloadedConfig);
+    } else {
+      *args().m_config = *m_reloadedConfig;
     }
-    LOG((CLOG_NOTE "reloaded configuration"));
+    delete m_reloadedConfig;
+    m_reloadedConfig = NULL;
+
+    if (applied) {
+      LOG((CLOG_NOTE "reloaded configuration"));
+    } else {
+      LOG((CLOG_ERR "reloaded configuration doesn't include this screen, ignored"));
+    }
+  }
+
+  if (m_reloadPending) {
+    m_reloadPending = false;
+    reloadConfig(Event(), NULL);
   }
 }
 
+void ServerApp::stopConfigRead()
+{
+  if (m_reloadThread != NULL) {
+    m_reloadThread->wait();
+    delete m_reloadThread;
+    m_reloadThread = NULL;
+  }
+  delete m_reloadedConfig;
+  m_reloadedConfig = NULL;
+  m_reloadPending = false;
+}
+
 void ServerApp::loadConfig()
 {
   bool loaded = false;
@@ -230,6 +290,11 @@ void ServerApp::loadConfig()
 }
 
 bool ServerApp::loadConfig(const String &pathname)
+{
+  return readConfig(pathname, *args().m_config);
+}
+
+bool ServerApp::readConfig(const String &pathname, ServerConfig &config) const
 {
   try {
     // load configuration
@@ -242,7 +307,7 @@ bool ServerApp::loadConfig(const String &pathname)
       LOG((CLOG_DEBUG "cannot open configuration \"%s\"", pathname.c_str()));
       return false;
     }
-    configStream >> *args().m_config;
+    configStream >> config;
     LOG((CLOG_DEBUG "configuration read successfully"));
     return true;
   } catch (XConfigRead &e) {
@@ -686,10 +751,11 @@ NetworkAddress ServerApp::getAddress(const NetworkAddress &address) const
 
 int ServerApp::mainLoop()
 {
-  // create socket multiplexer.  this must happen after daemonization
-  // on unix because threads evaporate across a fork().
+  // create socket multiplexer and file log writer.  this must happen
+  // after daemonization on unix because threads evaporate across a fork().
   SocketMultiplexer multiplexer;
   setSocketMultiplexer(&multiplexer);
+  startFileLogWriter();
 
   // if configuration has no screens then add this system
   // as the default
@@ -728,6 +794,10 @@ int ServerApp::mainLoop()
       m_events->forServerApp().reloadConfig(), m_events->getSystemTarget(),
       new TMethodEventJob<ServerApp>(this, &ServerApp::reloadConfig)
   );
+  m_events->adoptHandler(
+      m_events->forServerApp().configRead(), m_events->getSystemTarget(),
+      new TMethodEventJob<ServerApp>(this, &ServerApp::handleConfigRead)
+  );
 
   // handle force reconnect event by disconnecting clients.  they'll
   // reconnect automatically.
@@ -767,7 +837,10 @@ int ServerApp::mainLoop()
   LOG((CLOG_DEBUG1 "stopping server"));
   m_events->removeHandler(m_events->forServerApp().forceReconnect(), m_events->getSystemTarget());
   m_events->removeHandler(m_events->forServerApp().reloadConfig(), m_events->getSystemTarget());
+  m_events->removeHandler(m_events->forServerApp().configRead(), m_events->getSystemTarget());
+  stopConfigRead();
   cleanupServer();
+  SecureSession::cleanup();
   updateStatus();
   LOG((CLOG_NOTE "stopped server"));
 
@@ -43,6 +43,7 @@ class Screen;
 class ClientListener;
 class EventQueueTimer;
 class ILogOutputter;
+class Thread;
 class IEventQueue;
 class ISocketFactory;
 
@@ -89,6 +90,7 @@ public:
   //
 
   void reloadConfig(const Event &, void *);
+  void handleConfigRead(const Event &, void *);
   void forceReconnect(const Event &, void *);
   void resetServer(const Event &, void *);
   void handleClientConnected(const Event &, void *vlistener);
@@ -137,6 +139,9 @@ private:
   void handleScreenSwitched(const Event &, void *data);
   ISocketFactory *getSocketFactory() const;
   NetworkAddress getAddress(const NetworkAddress &address) const;
+  bool readConfig(const String &pathname, ServerConfig &config) const;
+  void readConfigThread(void *);
+  void stopConfigRead();
 
   Server *m_server;
   EServerState m_serverState;
@@ -145,6 +150,11 @@ private:
   ClientListener *m_listener;
   EventQueueTimer *m_timer;
   NetworkAddress *m_deskflowAddress;
+
+  // state for reading the configuration off the event thread on reload
+  Thread *m_reloadThread;
+  ServerConfig *m_reloadedConfig;
+  bool m_reloadPending;
 };
 
 // configuration file name
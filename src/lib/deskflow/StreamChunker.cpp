@@ -106,7 +106,7 @@ void StreamChunker::sendFile(char *filename, IEventQueue *events, void *eventTar
 }
 
 void StreamChunker::sendClipboard(
-    String &data, size_t size, ClipboardID id, UInt32 sequence, IEventQueue *events, void *eventTarget
+    const String &data, size_t size, ClipboardID id, UInt32 sequence, IEventQueue *events, void *eventTarget
 )
 {
   // send first message (data size)
@@ -27,8 +27,9 @@ class StreamChunker
 {
 public:
   static void sendFile(char *filename, IEventQueue *events, void *eventTarget);
-  static void
-  sendClipboard(String &data, size_t size, ClipboardID id, UInt32 sequence, IEventQueue *events, void *eventTarget);
+  static void sendClipboard(
+      const String &data, size_t size, ClipboardID id, UInt32 sequence, IEventQueue *events, void *eventTarget
+  );
   static void interruptFile();
 
 private:
@@ -41,9 +41,12 @@ const char *const kMsgDMouseDown = "DMDN%1i";
 const char *const kMsgDMouseUp = "DMUP%1i";
 const char *const kMsgDMouseMove = "DMMV%2i%2i";
 const char *const kMsgDMouseRelMove = "DMRM%2i%2i";
+const char *const kMsgDMotionChannel = "DMCH%4i%2i%s";
+const char *const kMsgDMotionFence = "DMFN%4i%1i%4i%4i";
 const char *const kMsgDMouseWheel = "DMWM%2i%2i";
 const char *const kMsgDMouseWheel1_0 = "DMWM%2i";
 const char *const kMsgDClipboard = "DCLP%1i%4i%1i%s";
+const char *const kMsgDClipboardFormats = "DCLF%1i%4i%4I";
 const char *const kMsgDInfo = "DINF%2i%2i%2i%2i%2i%2i%2i";
 const char *const kMsgDSetOptions = "DSOP%4I";
 const char *const kMsgDFileTransfer = "DFTR%1i%s";
@@ -51,6 +54,7 @@ const char *const kMsgDDragInfo = "DDRG%2i%s";
 const char *const kMsgDSecureInputNotification = "SECN%s";
 const char *const kMsgDLanguageSynchronisation = "LSYN%s";
 const char *const kMsgQInfo = "QINF";
+const char *const kMsgQClipboard = "QCLP%1i%4i%4i";
 const char *const kMsgEIncompatible = "EICV%2i%2i";
 const char *const kMsgEBusy = "EBSY";
 const char *const kMsgEUnknown = "EUNK";
@@ -31,9 +31,13 @@
 // 1.6:  adds clipboard streaming
 // 1.7   adds security input notifications
 // 1.8   adds language synchronization functionality
+// 1.9   adds clipboard format advertisement and requests
+// 1.10  adds compressed clipboard and file chunks
+// 1.11  sends the client's screen info with the hello reply
+// 1.12  adds the udp motion channel
 // NOTE: with new version, deskflow minor version should increment
 static const SInt16 kProtocolMajorVersion = 1;
-static const SInt16 kProtocolMinorVersion = 8;
+static const SInt16 kProtocolMinorVersion = 12;
 
 // default contact port number
 static const UInt16 kDefaultPort = 24800;
@@ -79,7 +83,8 @@ enum EDataTransfer
 {
   kDataStart = 1,
   kDataChunk = 2,
-  kDataEnd = 3
+  kDataEnd = 3,
+  kDataChunkCompressed = 4
 };
 
 // Data received constants
@@ -234,6 +239,27 @@ extern const char *const kMsgDMouseMove;
 // $1 = dx, $2 = dy.  dx,dy are motion deltas.
 extern const char *const kMsgDMouseRelMove;
 
+// motion channel:  primary -> secondary
+// offers to send mouse motion as udp datagrams, see MotionDatagram.
+// $1 = channel id, $2 = udp port on the address the secondary connected
+// to, $3 = channel key.  the secondary may ignore the offer, otherwise
+// it sends kRegister datagrams to the port every kKeepAliveRate
+// seconds.  the primary only sends motion datagrams while they arrive.
+extern const char *const kMsgDMotionChannel;
+
+// motion fence:  primary -> secondary
+// sent before any other message that follows motion sent on the motion
+// channel, so that it's applied after that motion even if datagrams
+// were lost or are late, and before the first motion datagram that
+// follows any other message, so that motion isn't applied before the
+// message.  $1 = sequence number, $2 = kind, $3, $4 = the x, y of the
+// last motion datagram.  the secondary applies the motion if it hasn't
+// applied that datagram and ignores datagrams with a sequence number not
+// greater than $1 from then on.  it holds back datagrams that carry a
+// count of fences greater than the number it has read until it reads
+// the fence that makes up the count.
+extern const char *const kMsgDMotionFence;
+
 // mouse scroll:  primary -> secondary
 // $1 = xDelta, $2 = yDelta.  the delta should be +120 for one tick forward
 // (away from the user) or right and -120 for one tick backward (toward
@@ -248,9 +274,19 @@ extern const char *const kMsgDMouseWheel1_0;
 // $2 = sequence number, $3 = mark $4 = clipboard data.  the sequence number
 // is 0 when sent by the primary.  secondary screens should use the
 // sequence number from the most recent kMsgCEnter.  $1 = clipboard
-// identifier.
+// identifier.  from protocol 1.10 a chunk's mark may be
+// kDataChunkCompressed, see Chunk::compress().
 extern const char *const kMsgDClipboard;
 
+// clipboard formats:  primary -> secondary
+// sent instead of kMsgDClipboard to clients that support it, listing
+// the formats the clipboard has without their data.  $1 = clipboard
+// identifier, $2 = sequence number (never 0), $3 = for each format:
+// the format, data size and the high and low 32 bits of a hash of the
+// data.  a format the primary hasn't read yet has size 0xffffffff and
+// hash 0.  the secondary requests the data it wants with kMsgQClipboard.
+extern const char *const kMsgDClipboardFormats;
+
 // client data:  secondary -> primary
 // $1 = coordinate of leftmost pixel on secondary screen,
 // $2 = coordinate of topmost pixel on secondary screen,
@@ -260,7 +296,9 @@ extern const char *const kMsgDClipboard;
 // $6, $7 = the x,y position of the mouse on the secondary screen.
 //
 // the secondary screen must send this message in response to the
-// kMsgQInfo message.  it must also send this message when the
+// kMsgQInfo message.  from protocol 1.11 the primary doesn't send
+// kMsgQInfo, instead the secondary sends this message straight after
+// kMsgHelloBack.  it must also send this message when the
 // screen's resolution changes.  in this case, the secondary screen
 // should ignore any kMsgDMouseMove messages until it receives a
 // kMsgCInfoAck in order to prevent attempts to move the mouse off
@@ -277,6 +315,7 @@ extern const char *const kMsgDSetOptions;
 // 0 means the content followed is the file size.
 // 1 means the content followed is the chunk data.
 // 2 means the file transfer is finished.
+// from protocol 1.10, 4 means the content is compressed chunk data.
 extern const char *const kMsgDFileTransfer;
 
 // drag infomation:  primary <-> secondary
@@ -299,9 +338,17 @@ extern const char *const kMsgDLanguageSynchronisation;
 //
 
 // query screen info:  primary -> secondary
-// client should reply with a kMsgDInfo.
+// client should reply with a kMsgDInfo.  not sent from protocol 1.11.
 extern const char *const kMsgQInfo;
 
+// query clipboard data:  secondary -> primary
+// primary should reply with a kMsgDClipboard containing only the
+// requested formats, using $2 as the sequence number.  $1 = clipboard
+// identifier, $2 = sequence number from the kMsgDClipboardFormats,
+// $3 = bit mask of requested formats (1 << format).  requests with an
+// old sequence number are ignored.
+extern const char *const kMsgQClipboard;
+
 //
 // error codes
 //
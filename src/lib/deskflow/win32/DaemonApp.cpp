@@ -347,6 +347,7 @@ void DaemonApp::initLogging()
 #endif
 
   m_pFileLogOutputter = new FileLogOutputter(logFilename().c_str()); // NOSONAR - Adopted by `Log`
+  m_pFileLogOutputter->startWriter();
   CLOG->insert(m_pFileLogOutputter);
 }
 
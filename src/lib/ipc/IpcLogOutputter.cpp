@@ -30,33 +30,48 @@
 #include "ipc/IpcServer.h"
 #include "mt/Thread.h"
 
+#include <algorithm>
+#include <cstring>
+
 enum EIpcLogOutputter
 {
   kBufferMaxSize = 1000,
+  kBufferMaxBytes = 512 * 1024,
   kMaxSendLines = 100,
   kBufferRateWriteLimit = 1000, // writes per kBufferRateTime
   kBufferRateTimeLimit = 1      // seconds
 };
 
+// time to wait for more lines before sending a partial chunk.
+static const double kSendDelay = 0.05;
+
+// time to wait before checking for clients again when lines are waiting.
+static const double kNoClientsDelay = 1.0;
+
 IpcLogOutputter::IpcLogOutputter(IpcServer &ipcServer, IpcClientType clientType, bool useThread)
     : m_ipcServer(ipcServer),
       m_bufferMutex(ARCH->newMutex()),
+      m_bufferCond(ARCH->newCondVar()),
       m_sending(false),
       m_bufferThread(nullptr),
       m_running(false),
-      m_notifyCond(ARCH->newCondVar()),
-      m_notifyMutex(ARCH->newMutex()),
       m_bufferThreadId(0),
-      m_bufferWaiting(false),
+      m_ring(kBufferMaxBytes),
+      m_ringStart(0),
+      m_ringUsed(0),
+      m_lineLengths(kBufferMaxSize),
+      m_lineStart(0),
+      m_lineCount(0),
       m_bufferMaxSize(kBufferMaxSize),
       m_bufferRateWriteLimit(kBufferRateWriteLimit),
       m_bufferRateTimeLimit(kBufferRateTimeLimit),
       m_bufferWriteCount(0),
       m_bufferRateStart(ARCH->time()),
-      m_clientType(clientType),
-      m_runningMutex(ARCH->newMutex())
+      m_clientType(clientType)
 {
   if (useThread) {
+    // set before the thread starts, so that an early close() isn't lost.
+    m_running = true;
     m_bufferThread = new Thread(new TMethodJob<IpcLogOutputter>(this, &IpcLogOutputter::bufferThread));
   }
 }
@@ -65,16 +80,14 @@ IpcLogOutputter::~IpcLogOutputter()
 {
   close();
 
-  ARCH->closeMutex(m_bufferMutex);
-
   if (m_bufferThread != nullptr) {
     m_bufferThread->cancel();
     m_bufferThread->wait();
     delete m_bufferThread;
   }
 
-  ARCH->closeCondVar(m_notifyCond);
-  ARCH->closeMutex(m_notifyMutex);
+  ARCH->closeCondVar(m_bufferCond);
+  ARCH->closeMutex(m_bufferMutex);
 }
 
 void IpcLogOutputter::open(const char *title)
@@ -84,9 +97,11 @@ void IpcLogOutputter::open(const char *title)
 void IpcLogOutputter::close()
 {
   if (m_bufferThread != nullptr) {
-    ArchMutexLock lock(m_runningMutex);
-    m_running = false;
-    notifyBuffer();
+    {
+      ArchMutexLock lock(m_bufferMutex);
+      m_running = false;
+      ARCH->broadcastCondVar(m_bufferCond);
+    }
     m_bufferThread->wait(5);
   }
 }
@@ -102,55 +117,78 @@ bool IpcLogOutputter::write(ELevel, const char *text)
     return true;
   }
 
-  appendBuffer(text);
-  notifyBuffer();
+  if (appendBuffer(text, strlen(text))) {
+    notifyBuffer();
+  }
 
   return true;
 }
 
-void IpcLogOutputter::appendBuffer(const String &text)
+bool IpcLogOutputter::appendBuffer(const char *text, size_t length)
 {
   ArchMutexLock lock(m_bufferMutex);
 
-  double elapsed = ARCH->time() - m_bufferRateStart;
-  if (elapsed < m_bufferRateTimeLimit) {
+  const double now = ARCH->time();
+  if (now - m_bufferRateStart < m_bufferRateTimeLimit) {
     if (m_bufferWriteCount >= m_bufferRateWriteLimit) {
       // discard the log line if we've logged too much.
-      return;
+      return false;
     }
   } else {
     m_bufferWriteCount = 0;
-    m_bufferRateStart = ARCH->time();
+    m_bufferRateStart = now;
   }
 
-  if (m_buffer.size() >= m_bufferMaxSize) {
-    // if the queue is exceeds size limit,
-    // throw away the oldest item
-    m_buffer.pop_front();
+  if (m_lineLengths.empty()) {
+    return false;
   }
 
-  m_buffer.push_back(text);
+  // lines longer than the whole ring are truncated, keeping the newline.
+  const size_t size = std::min(length + 1, m_ring.size());
+
+  // if the ring exceeds the line or byte limit, throw away the oldest lines.
+  while (m_lineCount > 0 && (m_lineCount >= m_lineLengths.size() || m_ringUsed + size > m_ring.size())) {
+    popLine();
+  }
+
+  const size_t end = (m_ringStart + m_ringUsed) % m_ring.size();
+  const size_t firstPart = std::min(size - 1, m_ring.size() - end);
+  memcpy(&m_ring[end], text, firstPart);
+  memcpy(m_ring.data(), text + firstPart, size - 1 - firstPart);
+  m_ring[(end + size - 1) % m_ring.size()] = '\n';
+
+  m_lineLengths[(m_lineStart + m_lineCount) % m_lineLengths.size()] = size;
+  m_lineCount++;
+  m_ringUsed += size;
   m_bufferWriteCount++;
+
+  // only wake the buffer thread when there's something new for it to do;
+  // partial chunks are picked up when its send delay expires.
+  return m_lineCount == 1 || m_lineCount == kMaxSendLines;
+}
+
+void IpcLogOutputter::popLine()
+{
+  const size_t length = m_lineLengths[m_lineStart];
+  m_ringStart = (m_ringStart + length) % m_ring.size();
+  m_ringUsed -= length;
+  m_lineStart = (m_lineStart + 1) % m_lineLengths.size();
+  m_lineCount--;
 }
 
 bool IpcLogOutputter::isRunning()
 {
-  ArchMutexLock lock(m_runningMutex);
+  ArchMutexLock lock(m_bufferMutex);
   return m_running;
 }
 
 void IpcLogOutputter::bufferThread(void *)
 {
   m_bufferThreadId = m_bufferThread->getID();
-  m_running = true;
 
   try {
     while (isRunning()) {
-      if (m_buffer.empty() || !m_ipcServer.hasClients(m_clientType)) {
-        ArchMutexLock lock(m_notifyMutex);
-        ARCH->waitCondVar(m_notifyCond, m_notifyMutex, -1);
-      }
-
+      waitForBuffer();
       sendBuffer();
     }
   } catch (XArch &e) {
@@ -160,36 +198,67 @@ void IpcLogOutputter::bufferThread(void *)
   LOG((CLOG_DEBUG "ipc log buffer thread finished"));
 }
 
+void IpcLogOutputter::waitForBuffer()
+{
+  const bool hasClients = m_ipcServer.hasClients(m_clientType);
+
+  ArchMutexLock lock(m_bufferMutex);
+  if (!m_running) {
+    return;
+  }
+
+  if (m_lineCount == 0) {
+    ARCH->waitCondVar(m_bufferCond, m_bufferMutex, -1);
+  } else if (!hasClients) {
+    ARCH->waitCondVar(m_bufferCond, m_bufferMutex, kNoClientsDelay);
+  } else if (m_lineCount < kMaxSendLines) {
+    // give the log a moment to fill the chunk before sending it.
+    ARCH->waitCondVar(m_bufferCond, m_bufferMutex, kSendDelay);
+  }
+}
+
 void IpcLogOutputter::notifyBuffer()
 {
-  ArchMutexLock lock(m_notifyMutex);
-  ARCH->broadcastCondVar(m_notifyCond);
+  ArchMutexLock lock(m_bufferMutex);
+  ARCH->broadcastCondVar(m_bufferCond);
 }
 
 String IpcLogOutputter::getChunk(size_t count)
 {
   ArchMutexLock lock(m_bufferMutex);
 
-  if (m_buffer.size() < count) {
-    count = m_buffer.size();
+  count = std::min(count, m_lineCount);
+
+  size_t size = 0;
+  for (size_t i = 0; i < count; i++) {
+    size += m_lineLengths[(m_lineStart + i) % m_lineLengths.size()];
   }
 
+  // the lines are contiguous in the ring, apart from where it wraps.
   String chunk;
+  chunk.reserve(size);
+  const size_t firstPart = std::min(size, m_ring.size() - m_ringStart);
+  chunk.append(&m_ring[m_ringStart], firstPart);
+  chunk.append(m_ring.data(), size - firstPart);
+
   for (size_t i = 0; i < count; i++) {
-    chunk.append(m_buffer.front());
-    chunk.append("\n");
-    m_buffer.pop_front();
+    popLine();
   }
   return chunk;
 }
 
 void IpcLogOutputter::sendBuffer()
 {
-  if (m_buffer.empty() || !m_ipcServer.hasClients(m_clientType)) {
+  if (!m_ipcServer.hasClients(m_clientType)) {
     return;
   }
 
-  IpcLogLineMessage message(getChunk(kMaxSendLines));
+  String chunk = getChunk(kMaxSendLines);
+  if (chunk.empty()) {
+    return;
+  }
+
+  IpcLogLineMessage message(std::move(chunk));
   m_sending = true;
   m_ipcServer.send(message, IpcClientType::GUI);
   m_sending = false;
@@ -197,6 +266,19 @@ void IpcLogOutputter::sendBuffer()
 
 void IpcLogOutputter::bufferMaxSize(UInt16 bufferMaxSize)
 {
+  ArchMutexLock lock(m_bufferMutex);
+
+  while (m_lineCount > bufferMaxSize) {
+    popLine();
+  }
+
+  // keep the remaining lines in order, starting from the first index.
+  std::vector<size_t> lineLengths(bufferMaxSize);
+  for (size_t i = 0; i < m_lineCount; i++) {
+    lineLengths[i] = m_lineLengths[(m_lineStart + i) % m_lineLengths.size()];
+  }
+  m_lineLengths.swap(lineLengths);
+  m_lineStart = 0;
   m_bufferMaxSize = bufferMaxSize;
 }
 
@@ -207,6 +289,7 @@ UInt16 IpcLogOutputter::bufferMaxSize() const
 
 void IpcLogOutputter::bufferRateLimit(UInt16 writeLimit, double timeLimit)
 {
+  ArchMutexLock lock(m_bufferMutex);
   m_bufferRateWriteLimit = writeLimit;
   m_bufferRateTimeLimit = timeLimit;
 }
@@ -23,7 +23,7 @@
 #include "base/ILogOutputter.h"
 #include "common/ipc.h"
 
-#include <deque>
+#include <vector>
 
 class IpcServer;
 class Event;
@@ -31,7 +31,9 @@ class IpcClientProxy;
 
 //! Write log to GUI over IPC
 /*!
-This outputter writes output to the GUI via IPC.
+This outputter writes output to the GUI via IPC.  Lines are buffered in
+a fixed size ring and sent in chunks, so that verbose logging results in
+a few large messages rather than one message and wakeup per line.
 */
 class IpcLogOutputter : public ILogOutputter
 {
@@ -72,8 +74,8 @@ public:
 
   //! Send the buffer
   /*!
-  Sends a chunk of the buffer to the IPC server, normally called
-  when threaded mode is on.
+  Sends a chunk of up to 100 lines of the buffer to the IPC server,
+  normally called when threaded mode is on.
   */
   void sendBuffer();
 
@@ -93,28 +95,36 @@ public:
 private:
   void init();
   void bufferThread(void *);
+  void waitForBuffer();
   String getChunk(size_t count);
-  void appendBuffer(const String &text);
+  bool appendBuffer(const char *text, size_t length);
+  void popLine();
   bool isRunning();
 
 private:
-  typedef std::deque<String> Buffer;
-
   IpcServer &m_ipcServer;
-  Buffer m_buffer;
   ArchMutex m_bufferMutex;
+  ArchCond m_bufferCond;
   bool m_sending;
   Thread *m_bufferThread;
   bool m_running;
-  ArchCond m_notifyCond;
-  ArchMutex m_notifyMutex;
-  bool m_bufferWaiting;
   IArchMultithread::ThreadID m_bufferThreadId;
+
+  // log text, stored as consecutive lines in a fixed size byte ring.
+  std::vector<char> m_ring;
+  size_t m_ringStart;
+  size_t m_ringUsed;
+
+  // length of each line in the ring (including the newline), oldest first,
+  // in a ring with room for m_bufferMaxSize lines.
+  std::vector<size_t> m_lineLengths;
+  size_t m_lineStart;
+  size_t m_lineCount;
+
   UInt16 m_bufferMaxSize;
   UInt16 m_bufferRateWriteLimit;
   double m_bufferRateTimeLimit;
   UInt16 m_bufferWriteCount;
   double m_bufferRateStart;
   IpcClientType m_clientType;
-  ArchMutex m_runningMutex;
 };
@@ -19,6 +19,8 @@
 #include "ipc/IpcMessage.h"
 #include "common/ipc.h"
 
+#include <utility>
+
 IpcMessage::IpcMessage(IpcMessageType type) : m_type(type)
 {
 }
@@ -35,7 +37,9 @@ IpcShutdownMessage::IpcShutdownMessage() : IpcMessage(IpcMessageType::Shutdown)
 {
 }
 
-IpcLogLineMessage::IpcLogLineMessage(const String &logLine) : IpcMessage(IpcMessageType::LogLine), m_logLine(logLine)
+IpcLogLineMessage::IpcLogLineMessage(String logLine)
+    : IpcMessage(IpcMessageType::LogLine),
+      m_logLine(std::move(logLine))
 {
 }
 
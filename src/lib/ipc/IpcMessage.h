@@ -72,7 +72,7 @@ public:
 class IpcLogLineMessage : public IpcMessage
 {
 public:
-  explicit IpcLogLineMessage(const String &logLine);
+  explicit IpcLogLineMessage(String logLine);
   ~IpcLogLineMessage() override = default;
 
   //! Gets the log line.
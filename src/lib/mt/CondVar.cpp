@@ -58,8 +58,8 @@ void CondVarBase::broadcast()
 bool CondVarBase::wait(Stopwatch &timer, double timeout) const
 {
   double remain = timeout - timer.getTime();
-  // Some ARCH wait()s return prematurely, retry until really timed out
-  // In particular, ArchMultithreadPosix::waitCondVar() returns every 100ms
+  // Some ARCH wait()s return prematurely (spurious wakeups), retry until
+  // really timed out
   do {
     // Always call wait at least once, even if remain is 0, to give
     // other thread a chance to grab the mutex to avoid deadlocks on
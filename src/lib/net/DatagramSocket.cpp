@@ -0,0 +1,203 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "net/DatagramSocket.h"
+
+#include "arch/Arch.h"
+#include "arch/XArch.h"
+#include "base/IEventQueue.h"
+#include "base/Log.h"
+#include "io/XIO.h"
+#include "mt/Lock.h"
+#include "mt/Mutex.h"
+#include "net/NetworkAddress.h"
+#include "net/SocketMultiplexer.h"
+#include "net/TSocketMultiplexerMethodJob.h"
+#include "net/XSocket.h"
+
+//
+// DatagramSocket
+//
+
+DatagramSocket::DatagramSocket(
+    IEventQueue *events, SocketMultiplexer *socketMultiplexer, IArchNetwork::EAddressFamily family
+)
+    : m_events(events),
+      m_socketMultiplexer(socketMultiplexer)
+{
+  m_mutex = new Mutex;
+  try {
+    m_socket = ARCH->newSocket(family, IArchNetwork::kDGRAM);
+  } catch (XArchNetwork &e) {
+    delete m_mutex;
+    throw XSocketCreate(e.what());
+  }
+}
+
+DatagramSocket::~DatagramSocket()
+{
+  try {
+    if (m_socket != NULL) {
+      m_socketMultiplexer->removeSocket(this);
+      ARCH->closeSocket(m_socket);
+    }
+  } catch (...) {
+    // ignore
+    LOG((CLOG_WARN "error while closing UDP socket"));
+  }
+  delete m_mutex;
+}
+
+void DatagramSocket::bind(const NetworkAddress &addr)
+{
+  LOG_DEBUG("binding udp socket to address: %s:%d", addr.getHostname().c_str(), addr.getPort());
+  try {
+    Lock lock(m_mutex);
+    ARCH->bindSocket(m_socket, addr.getAddress());
+    setReadableJob();
+  } catch (XArchNetworkAddressInUse &e) {
+    throw XSocketAddressInUse(e.what());
+  } catch (XArchNetwork &e) {
+    throw XSocketBind(e.what());
+  }
+}
+
+void DatagramSocket::connect(const NetworkAddress &addr)
+{
+  try {
+    Lock lock(m_mutex);
+    ARCH->connectSocket(m_socket, addr.getAddress());
+    setReadableJob();
+  } catch (XArchNetwork &e) {
+    throw XSocketConnect(e.what());
+  }
+}
+
+void DatagramSocket::close()
+{
+  Lock lock(m_mutex);
+  if (m_socket == NULL) {
+    throw XIOClosed();
+  }
+  try {
+    m_socketMultiplexer->removeSocket(this);
+    ARCH->closeSocket(m_socket);
+    m_socket = NULL;
+  } catch (XArchNetwork &e) {
+    throw XSocketIOClose(e.what());
+  }
+}
+
+void *DatagramSocket::getEventTarget() const
+{
+  return const_cast<void *>(static_cast<const void *>(this));
+}
+
+bool DatagramSocket::read(String &datagram, NetworkAddress *sender)
+{
+  Lock lock(m_mutex);
+  if (m_socket == NULL) {
+    return false;
+  }
+
+  char buffer[kMaxDatagramSize];
+  ArchNetAddress from = NULL;
+  size_t n = 0;
+  try {
+    n = ARCH->readSocketFrom(m_socket, buffer, sizeof(buffer), &from);
+  } catch (XArchNetwork &e) {
+    // an error on a datagram socket only affects that datagram, e.g. an
+    // earlier send to a port nobody was listening on.
+    LOG((CLOG_DEBUG1 "error reading udp socket: %s", e.what()));
+  }
+
+  if (from == NULL) {
+    // nothing left, wait for the next datagram
+    setReadableJob();
+    return false;
+  }
+
+  NetworkAddress address(from);
+  datagram.assign(buffer, n);
+  if (sender != nullptr) {
+    *sender = address;
+  }
+  return true;
+}
+
+bool DatagramSocket::write(const String &datagram)
+{
+  Lock lock(m_mutex);
+  if (m_socket == NULL) {
+    return false;
+  }
+
+  try {
+    return ARCH->writeSocket(m_socket, datagram.data(), datagram.size()) == datagram.size();
+  } catch (XArchNetwork &e) {
+    LOG((CLOG_DEBUG1 "error writing udp socket: %s", e.what()));
+    return false;
+  }
+}
+
+bool DatagramSocket::writeTo(const String &datagram, const NetworkAddress &address)
+{
+  Lock lock(m_mutex);
+  if (m_socket == NULL) {
+    return false;
+  }
+
+  try {
+    return ARCH->writeSocketTo(m_socket, datagram.data(), datagram.size(), address.getAddress()) == datagram.size();
+  } catch (XArchNetwork &e) {
+    LOG((CLOG_DEBUG1 "error writing udp socket: %s", e.what()));
+    return false;
+  }
+}
+
+NetworkAddress DatagramSocket::getLocalAddress() const
+{
+  Lock lock(m_mutex);
+  if (m_socket == NULL) {
+    return NetworkAddress();
+  }
+
+  try {
+    return NetworkAddress(ARCH->getSocketAddr(m_socket));
+  } catch (XArchNetwork &e) {
+    LOG((CLOG_DEBUG1 "cannot get local address of udp socket: %s", e.what()));
+    return NetworkAddress();
+  }
+}
+
+void DatagramSocket::setReadableJob()
+{
+  m_socketMultiplexer->addSocket(
+      this,
+      new TSocketMultiplexerMethodJob<DatagramSocket>(this, &DatagramSocket::serviceReadable, m_socket, true, false)
+  );
+}
+
+ISocketMultiplexerJob *DatagramSocket::serviceReadable(ISocketMultiplexerJob *job, bool read, bool, bool error)
+{
+  if (read || error) {
+    m_events->addEvent(Event(m_events->forIStream().inputReady(), this));
+    // stop polling on this socket until the datagrams have been read
+    return NULL;
+  }
+  return job;
+}
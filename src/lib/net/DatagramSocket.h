@@ -0,0 +1,108 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "arch/IArchNetwork.h"
+#include "base/String.h"
+#include "net/ISocket.h"
+
+class Mutex;
+class ISocketMultiplexerJob;
+class IEventQueue;
+class NetworkAddress;
+class SocketMultiplexer;
+
+//! UDP socket
+/*!
+A datagram socket using UDP.  Sends \c IStreamEvents::inputReady when
+datagrams arrive and then stops polling until they've all been read
+with \c read(), so a busy sender can't flood the event queue.  Writes
+never block; a datagram that can't be sent is dropped.
+*/
+class DatagramSocket : public ISocket
+{
+public:
+  DatagramSocket(IEventQueue *events, SocketMultiplexer *socketMultiplexer, IArchNetwork::EAddressFamily family);
+  DatagramSocket(DatagramSocket const &) = delete;
+  DatagramSocket(DatagramSocket &&) = delete;
+  ~DatagramSocket() override;
+
+  DatagramSocket &operator=(DatagramSocket const &) = delete;
+  DatagramSocket &operator=(DatagramSocket &&) = delete;
+
+  //! @name manipulators
+  //@{
+
+  //! Connect socket
+  /*!
+  Sets the only address datagrams are sent to and received from, which
+  binds the socket to an unused port if it isn't bound.
+  */
+  void connect(const NetworkAddress &);
+
+  //! Read a datagram
+  /*!
+  Reads the next queued datagram into \p datagram and its sender into
+  \p sender, if not NULL.  Returns false if there are none, after which
+  \c IStreamEvents::inputReady is sent again when the next one arrives.
+  */
+  bool read(String &datagram, NetworkAddress *sender = nullptr);
+
+  //! Send a datagram to the connected address
+  /*!
+  Returns false if the datagram was dropped.
+  */
+  bool write(const String &datagram);
+
+  //! Send a datagram
+  /*!
+  Sends \p datagram to \p address.  Returns false if it was dropped.
+  */
+  bool writeTo(const String &datagram, const NetworkAddress &address);
+
+  //@}
+  //! @name accessors
+  //@{
+
+  //! Get the local address
+  /*!
+  Returns the address the socket is bound to, or an invalid address if
+  it isn't bound.
+  */
+  NetworkAddress getLocalAddress() const;
+
+  //@}
+
+  // ISocket overrides
+  void bind(const NetworkAddress &) override;
+  void close() override;
+  void *getEventTarget() const override;
+
+  //! Largest datagram that can be read
+  static const size_t kMaxDatagramSize = 1024;
+
+private:
+  void setReadableJob();
+  ISocketMultiplexerJob *serviceReadable(ISocketMultiplexerJob *, bool, bool, bool);
+
+private:
+  ArchSocket m_socket;
+  Mutex *m_mutex;
+  IEventQueue *m_events;
+  SocketMultiplexer *m_socketMultiplexer;
+};
@@ -56,6 +56,18 @@ public:
   */
   virtual void connect(const NetworkAddress &) = 0;
 
+  //@}
+  //! @name accessors
+  //@{
+
+  //! Get the local address
+  /*!
+  Returns the local address of the connection, which for an accepted
+  connection is the address the peer connected to.  Returns an invalid
+  address if the socket isn't connected.
+  */
+  virtual NetworkAddress getLocalAddress() const = 0;
+
   //@}
 
   // ISocket overrides
@@ -19,6 +19,7 @@
 #pragma once
 
 #include "base/EventTypes.h"
+#include "base/String.h"
 #include "net/ISocket.h"
 
 class IDataSocket;
@@ -38,9 +39,11 @@ public:
   /*!
   Accept a connection, returning a socket representing the full-duplex
   data stream.  Returns NULL if no socket is waiting to be accepted.
+  If \p peerAddress isn't NULL it's set to the address the connection
+  came from, without the port, or left empty if that isn't known.
   This is only valid after a call to \c bind().
   */
-  virtual IDataSocket *accept() = 0;
+  virtual IDataSocket *accept(String *peerAddress = NULL) = 0;
 
   //@}
 
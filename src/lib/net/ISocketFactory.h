@@ -21,6 +21,7 @@
 #include "arch/IArchNetwork.h"
 #include "common/IInterface.h"
 
+class DatagramSocket;
 class IDataSocket;
 class IListenSocket;
 
@@ -41,5 +42,8 @@ public:
   //! Create listen socket
   virtual IListenSocket *createListen(bool secure, IArchNetwork::EAddressFamily family = IArchNetwork::kINET) const = 0;
 
+  //! Create datagram socket
+  virtual DatagramSocket *createDatagram(IArchNetwork::EAddressFamily family = IArchNetwork::kINET) const = 0;
+
   //@}
 };
@@ -210,6 +210,21 @@ void InverseClientSocket::connect(const NetworkAddress &addr)
   setJob(newJob(m_listener.getRawSocket()));
 }
 
+NetworkAddress InverseClientSocket::getLocalAddress() const
+{
+  Lock lock(&m_mutex);
+  if (!m_socket.isValid()) {
+    return NetworkAddress();
+  }
+
+  try {
+    return NetworkAddress(ARCH->getSocketAddr(m_socket.getRawSocket()));
+  } catch (XArchNetwork &e) {
+    LOG((CLOG_DEBUG1 "cannot get local address: %s", e.what()));
+    return NetworkAddress();
+  }
+}
+
 InverseClientSocket::EJobResult InverseClientSocket::doRead()
 {
   UInt8 buffer[4096] = {0};
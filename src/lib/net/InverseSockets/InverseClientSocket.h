@@ -60,6 +60,7 @@ public:
 
   // IDataSocket overrides
   void connect(const NetworkAddress &) override;
+  NetworkAddress getLocalAddress() const override;
 
   virtual ISocketMultiplexerJob *newJob(ArchSocket socket);
 
@@ -69,7 +69,7 @@ void *InverseServerSocket::getEventTarget() const
   return const_cast<void *>(static_cast<const void *>(this));
 }
 
-IDataSocket *InverseServerSocket::accept()
+IDataSocket *InverseServerSocket::accept(String *)
 {
   IDataSocket *socket = nullptr;
   try {
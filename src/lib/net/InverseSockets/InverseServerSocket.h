@@ -44,7 +44,7 @@ public:
   void *getEventTarget() const override;
 
   // IListenSocket overrides
-  IDataSocket *accept() override;
+  IDataSocket *accept(String *peerAddress = nullptr) override;
 
 protected:
   void setListeningJob(bool read = false);
@@ -15,6 +15,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "InverseSocketFactory.h"
+#include "net/DatagramSocket.h"
 #include "net/InverseSockets/InverseClientSocket.h"
 #include "net/InverseSockets/InverseServerSocket.h"
 #include "net/InverseSockets/SecureClientSocket.h"
@@ -52,3 +53,8 @@ IListenSocket *InverseSocketFactory::createListen(bool secure, IArchNetwork::EAd
 
   return socket;
 }
+
+DatagramSocket *InverseSocketFactory::createDatagram(IArchNetwork::EAddressFamily family) const
+{
+  return new DatagramSocket(m_events, m_socketMultiplexer, family);
+}
@@ -28,6 +28,7 @@ public:
   // ISocketFactory overrides
   IDataSocket *create(bool secure, IArchNetwork::EAddressFamily family = IArchNetwork::kINET) const override;
   IListenSocket *createListen(bool secure, IArchNetwork::EAddressFamily family = IArchNetwork::kINET) const override;
+  DatagramSocket *createDatagram(IArchNetwork::EAddressFamily family = IArchNetwork::kINET) const override;
 
 private:
   IEventQueue *m_events = nullptr;
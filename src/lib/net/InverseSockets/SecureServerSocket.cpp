@@ -33,7 +33,7 @@ SecureServerSocket::SecureServerSocket(
 {
 }
 
-IDataSocket *SecureServerSocket::accept()
+IDataSocket *SecureServerSocket::accept(String *)
 {
   SecureSocket *socket = nullptr;
 
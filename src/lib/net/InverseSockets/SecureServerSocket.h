@@ -23,7 +23,7 @@ public:
   SecureServerSocket(IEventQueue *events, SocketMultiplexer *socketMultiplexer, IArchNetwork::EAddressFamily family);
 
   // IListenSocket overrides
-  IDataSocket *accept() override;
+  IDataSocket *accept(String *peerAddress = nullptr) override;
 
 private:
   std::string getCertificateFileName() const;
@@ -98,6 +98,14 @@ NetworkAddress::NetworkAddress(const String &hostname, int port) : m_hostname(ho
   checkPort();
 }
 
+NetworkAddress::NetworkAddress(ArchNetAddress address)
+    : m_address(address),
+      m_hostname(ARCH->addrToString(address)),
+      m_port(ARCH->getAddrPort(address))
+{
+  // nothing
+}
+
 NetworkAddress::~NetworkAddress()
 {
   if (m_address != nullptr) {
@@ -133,48 +141,38 @@ size_t NetworkAddress::resolve(size_t index)
     m_address = nullptr;
   }
 
-  try {
-    // if hostname is empty then use wildcard address otherwise look
-    // up the name.
-    if (m_hostname.empty()) {
-      m_address = ARCH->newAnyAddr(IArchNetwork::kINET);
-      resolvedAddressesCount = 1;
-    } else {
-      // Logic for temporary filtring only ipv4 addresses
-      std::vector<ArchNetAddress> ipv4OnlyAddresses;
-      {
-        auto addresses = ARCH->nameToAddr(m_hostname);
-        for (auto address : addresses) {
-          if (ARCH->getAddrFamily(address) == IArchNetwork::kINET) {
-            ipv4OnlyAddresses.emplace_back(address);
-          } else {
-            ARCH->closeAddr(address);
-          }
+  // if hostname is empty then use wildcard address otherwise look
+  // up the name.
+  if (m_hostname.empty()) {
+    m_address = ARCH->newAnyAddr(IArchNetwork::kINET);
+    resolvedAddressesCount = 1;
+  } else {
+    // Logic for temporary filtring only ipv4 addresses
+    std::vector<ArchNetAddress> ipv4OnlyAddresses;
+    {
+      auto addresses = lookupHostname();
+      for (auto address : addresses) {
+        if (ARCH->getAddrFamily(address) == IArchNetwork::kINET) {
+          ipv4OnlyAddresses.emplace_back(address);
+        } else {
+          ARCH->closeAddr(address);
         }
       }
+    }
 
-      resolvedAddressesCount = ipv4OnlyAddresses.size();
-      assert(resolvedAddressesCount > 0);
-      if (index < resolvedAddressesCount - 1) {
-        m_address = ipv4OnlyAddresses[index];
-      } else {
-        m_address = ipv4OnlyAddresses[resolvedAddressesCount - 1];
-      }
+    resolvedAddressesCount = ipv4OnlyAddresses.size();
+    assert(resolvedAddressesCount > 0);
+    if (index < resolvedAddressesCount - 1) {
+      m_address = ipv4OnlyAddresses[index];
+    } else {
+      m_address = ipv4OnlyAddresses[resolvedAddressesCount - 1];
+    }
 
-      for (auto address : ipv4OnlyAddresses) {
-        if (m_address != address) {
-          ARCH->closeAddr(address);
-        }
+    for (auto address : ipv4OnlyAddresses) {
+      if (m_address != address) {
+        ARCH->closeAddr(address);
       }
     }
-  } catch (XArchNetworkNameUnknown &) {
-    throw XSocketAddress(XSocketAddress::kNotFound, m_hostname, m_port);
-  } catch (XArchNetworkNameNoAddress &) {
-    throw XSocketAddress(XSocketAddress::kNoAddress, m_hostname, m_port);
-  } catch (XArchNetworkNameUnsupported &) {
-    throw XSocketAddress(XSocketAddress::kUnsupported, m_hostname, m_port);
-  } catch (XArchNetworkName &) {
-    throw XSocketAddress(XSocketAddress::kUnknown, m_hostname, m_port);
   }
 
   // set port in address
@@ -213,6 +211,35 @@ String NetworkAddress::getHostname() const
   return m_hostname;
 }
 
+std::vector<NetworkAddress> NetworkAddress::resolveAll() const
+{
+  std::vector<NetworkAddress> addresses;
+  for (auto address : lookupHostname()) {
+    NetworkAddress resolved;
+    resolved.m_address = address;
+    resolved.m_hostname = m_hostname;
+    resolved.m_port = m_port;
+    ARCH->setAddrPort(address, m_port);
+    addresses.push_back(resolved);
+  }
+  return addresses;
+}
+
+std::vector<ArchNetAddress> NetworkAddress::lookupHostname() const
+{
+  try {
+    return ARCH->nameToAddr(m_hostname);
+  } catch (XArchNetworkNameUnknown &) {
+    throw XSocketAddress(XSocketAddress::kNotFound, m_hostname, m_port);
+  } catch (XArchNetworkNameNoAddress &) {
+    throw XSocketAddress(XSocketAddress::kNoAddress, m_hostname, m_port);
+  } catch (XArchNetworkNameUnsupported &) {
+    throw XSocketAddress(XSocketAddress::kUnsupported, m_hostname, m_port);
+  } catch (XArchNetworkName &) {
+    throw XSocketAddress(XSocketAddress::kUnknown, m_hostname, m_port);
+  }
+}
+
 void NetworkAddress::checkPort()
 {
   // check port number
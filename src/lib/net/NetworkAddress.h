@@ -52,6 +52,12 @@ public:
   */
   NetworkAddress(const String &hostname, int port = 0);
 
+  /*!
+  Construct the network address for a native address, taking ownership
+  of \c address.  The hostname is the numerical form of the address.
+  */
+  explicit NetworkAddress(ArchNetAddress address);
+
   NetworkAddress(const NetworkAddress &);
 
   ~NetworkAddress();
@@ -114,10 +120,21 @@ public:
   */
   String getHostname() const;
 
+  //! Resolve all addresses
+  /*!
+  Resolves the hostname and returns an address for each result, of any
+  address family, in the order the resolver returned them.  Throws
+  XSocketAddress if resolution is unsuccessful.  Unlike \c resolve()
+  this doesn't change the address, so it can be called on a copy from
+  another thread.
+  */
+  std::vector<NetworkAddress> resolveAll() const;
+
   //@}
 
 private:
   void checkPort();
+  std::vector<ArchNetAddress> lookupHostname() const;
 
 private:
   ArchNetAddress m_address = nullptr;
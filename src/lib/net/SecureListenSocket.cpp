@@ -39,11 +39,17 @@ SecureListenSocket::SecureListenSocket(
 {
 }
 
-IDataSocket *SecureListenSocket::accept()
+IDataSocket *SecureListenSocket::accept(String *peerAddress)
 {
   SecureSocket *socket = NULL;
   try {
-    socket = new SecureSocket(m_events, m_socketMultiplexer, ARCH->acceptSocket(m_socket, NULL));
+    ArchSocket accepted = acceptSocket(peerAddress);
+    if (accepted == NULL) {
+      // nothing left to accept, wait for the next connection
+      setListeningJob();
+      return NULL;
+    }
+    socket = new SecureSocket(m_events, m_socketMultiplexer, accepted);
     socket->initSsl(true);
 
     if (socket != NULL) {
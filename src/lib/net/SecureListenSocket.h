@@ -30,5 +30,5 @@ public:
   SecureListenSocket(IEventQueue *events, SocketMultiplexer *socketMultiplexer, IArchNetwork::EAddressFamily family);
 
   // IListenSocket overrides
-  virtual IDataSocket *accept();
+  virtual IDataSocket *accept(String *peerAddress = NULL);
 };
@@ -0,0 +1,259 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "net/SecureSession.h"
+
+#include "arch/Arch.h"
+#include "base/Log.h"
+#include "mt/Lock.h"
+#include "mt/Mutex.h"
+
+#include <cstring>
+#include <map>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include <openssl/core_names.h>
+#else
+#include <openssl/hmac.h>
+#endif
+
+namespace {
+
+struct TicketKey
+{
+  unsigned char m_name[16];
+  unsigned char m_aesKey[32];
+  unsigned char m_hmacKey[32];
+  double m_created;
+};
+
+// guards everything below, used by the socket multiplexer threads
+Mutex &getMutex()
+{
+  static Mutex s_mutex;
+  return s_mutex;
+}
+
+std::map<String, SSL_SESSION *> s_sessions;
+
+// the current key, then the previous one, which is only used to decrypt
+TicketKey s_ticketKeys[2];
+int s_ticketKeyCount = 0;
+
+int getPeerIndex()
+{
+  static const int s_index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+  return s_index;
+}
+
+bool newTicketKey(TicketKey &key)
+{
+  if (RAND_bytes(key.m_name, sizeof(key.m_name)) <= 0 || RAND_bytes(key.m_aesKey, sizeof(key.m_aesKey)) <= 0 ||
+      RAND_bytes(key.m_hmacKey, sizeof(key.m_hmacKey)) <= 0) {
+    LOG((CLOG_ERR "failed to generate tls session ticket key"));
+    return false;
+  }
+  key.m_created = ARCH->time();
+  return true;
+}
+
+// note -- the mutex must be locked on entry
+bool addTicketKey()
+{
+  TicketKey key;
+  if (!newTicketKey(key)) {
+    return false;
+  }
+
+  LOG((CLOG_DEBUG "rotating tls session ticket key"));
+  s_ticketKeys[1] = s_ticketKeys[0];
+  s_ticketKeys[0] = key;
+  s_ticketKeyCount = (s_ticketKeyCount == 0) ? 1 : 2;
+  OPENSSL_cleanse(&key, sizeof(key));
+  return true;
+}
+
+// note -- the mutex must be locked on entry
+bool rotateTicketKeys()
+{
+  if (s_ticketKeyCount > 0 && ARCH->time() - s_ticketKeys[0].m_created < SecureSession::kLifetime) {
+    return true;
+  }
+  return addTicketKey();
+}
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+using TicketMac = EVP_MAC_CTX;
+
+bool initTicketMac(EVP_MAC_CTX *mac, const TicketKey &key)
+{
+  unsigned char hmacKey[sizeof(key.m_hmacKey)];
+  char digest[] = "SHA256";
+  memcpy(hmacKey, key.m_hmacKey, sizeof(hmacKey));
+
+  OSSL_PARAM params[] = {
+      OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY, hmacKey, sizeof(hmacKey)),
+      OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, digest, 0), OSSL_PARAM_construct_end()
+  };
+  return EVP_MAC_CTX_set_params(mac, params) > 0;
+}
+#else
+using TicketMac = HMAC_CTX;
+
+bool initTicketMac(HMAC_CTX *mac, const TicketKey &key)
+{
+  return HMAC_Init_ex(mac, key.m_hmacKey, sizeof(key.m_hmacKey), EVP_sha256(), nullptr) > 0;
+}
+#endif
+
+// encrypts new tickets with the current key, and decrypts tickets made
+// with either key.  tickets are always renewed, otherwise openssl doesn't
+// send a tls 1.3 client a new ticket after it resumes, and the client
+// would need a full handshake the time after.
+int ticketKeyCallback(
+    SSL *, unsigned char *keyName, unsigned char *iv, EVP_CIPHER_CTX *cipher, TicketMac *mac, int encrypt
+)
+{
+  Lock lock(&getMutex());
+  if (!rotateTicketKeys()) {
+    return -1;
+  }
+
+  if (encrypt) {
+    const TicketKey &key = s_ticketKeys[0];
+    if (RAND_bytes(iv, EVP_CIPHER_iv_length(EVP_aes_256_cbc())) <= 0) {
+      return -1;
+    }
+    memcpy(keyName, key.m_name, sizeof(key.m_name));
+    if (EVP_EncryptInit_ex(cipher, EVP_aes_256_cbc(), nullptr, key.m_aesKey, iv) <= 0 || !initTicketMac(mac, key)) {
+      return -1;
+    }
+    return 1;
+  }
+
+  for (int i = 0; i < s_ticketKeyCount; ++i) {
+    const TicketKey &key = s_ticketKeys[i];
+    if (memcmp(keyName, key.m_name, sizeof(key.m_name)) == 0) {
+      if (EVP_DecryptInit_ex(cipher, EVP_aes_256_cbc(), nullptr, key.m_aesKey, iv) <= 0 || !initTicketMac(mac, key)) {
+        return -1;
+      }
+      return 2;
+    }
+  }
+
+  // unknown or expired key, do a full handshake
+  return 0;
+}
+
+int newSessionCallback(SSL *ssl, SSL_SESSION *session)
+{
+  const auto peer = static_cast<const String *>(SSL_get_ex_data(ssl, getPeerIndex()));
+  if (peer == nullptr || peer->empty()) {
+    return 0;
+  }
+
+  // store a copy, openssl marks the connection's own session as not
+  // resumable if the connection isn't shut down cleanly, which is the
+  // usual way for a client to lose its connection.
+  SSL_SESSION *copy = SSL_SESSION_dup(session);
+  if (copy == nullptr) {
+    return 0;
+  }
+
+  // keep only the newest session, tls 1.3 tickets shouldn't be reused
+  Lock lock(&getMutex());
+  SSL_SESSION *&stored = s_sessions[*peer];
+  if (stored != nullptr) {
+    SSL_SESSION_free(stored);
+  }
+  stored = copy;
+  LOG((CLOG_DEBUG1 "stored tls session for %s", peer->c_str()));
+  return 0;
+}
+
+} // namespace
+
+//
+// SecureSession
+//
+
+void SecureSession::setupClientContext(SSL_CTX *context)
+{
+  SSL_CTX_set_session_cache_mode(context, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+  SSL_CTX_sess_set_new_cb(context, &newSessionCallback);
+  SSL_CTX_set_timeout(context, kLifetime);
+}
+
+void SecureSession::setupServerContext(SSL_CTX *context)
+{
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+  SSL_CTX_set_tlsext_ticket_key_evp_cb(context, &ticketKeyCallback);
+#else
+  SSL_CTX_set_tlsext_ticket_key_cb(context, &ticketKeyCallback);
+#endif
+  SSL_CTX_set_timeout(context, kLifetime);
+}
+
+void SecureSession::resume(SSL *ssl, const String *peer)
+{
+  SSL_set_ex_data(ssl, getPeerIndex(), const_cast<String *>(peer));
+
+  Lock lock(&getMutex());
+  auto it = s_sessions.find(*peer);
+  if (it == s_sessions.end()) {
+    return;
+  }
+
+  // each session is offered once, the server sends new ones
+  SSL_SESSION *session = it->second;
+  s_sessions.erase(it);
+
+  if (SSL_SESSION_is_resumable(session) && SSL_set_session(ssl, session) == 1) {
+    LOG((CLOG_DEBUG1 "offering tls session for %s", peer->c_str()));
+  }
+  SSL_SESSION_free(session);
+}
+
+void SecureSession::forget(const String &peer)
+{
+  Lock lock(&getMutex());
+  auto it = s_sessions.find(peer);
+  if (it != s_sessions.end()) {
+    SSL_SESSION_free(it->second);
+    s_sessions.erase(it);
+  }
+}
+
+void SecureSession::rotateTicketKey()
+{
+  Lock lock(&getMutex());
+  addTicketKey();
+}
+
+void SecureSession::cleanup()
+{
+  Lock lock(&getMutex());
+  for (const auto &it : s_sessions) {
+    SSL_SESSION_free(it.second);
+  }
+  s_sessions.clear();
+
+  OPENSSL_cleanse(s_ticketKeys, sizeof(s_ticketKeys));
+  s_ticketKeyCount = 0;
+}
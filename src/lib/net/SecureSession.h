@@ -0,0 +1,87 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "base/String.h"
+
+#include <openssl/ssl.h>
+
+//! TLS session resumption
+/*!
+Lets a client that reconnects to the same server skip the full TLS
+handshake.  Every secure socket has its own SSL context, so the state
+needed for resumption is kept here for the whole process: the client's
+sessions, keyed by the server it connected to, and the server's session
+ticket keys, which are rotated periodically.
+
+Resuming a session doesn't skip the fingerprint check, because the
+session holds the server's certificate.
+*/
+class SecureSession
+{
+public:
+  //! @name manipulators
+  //@{
+
+  //! Set up a client context
+  /*!
+  Makes \p context store the sessions that servers send to it.
+  */
+  static void setupClientContext(SSL_CTX *context);
+
+  //! Set up a server context
+  /*!
+  Makes \p context issue session tickets that any server context in
+  this process can decrypt.
+  */
+  static void setupServerContext(SSL_CTX *context);
+
+  //! Offer a stored session
+  /*!
+  Must be called before the handshake starts.  Offers the last session
+  from \p peer to the server if there is one, and stores sessions
+  received on \p ssl under \p peer.  \p peer must outlive \p ssl.
+  */
+  static void resume(SSL *ssl, const String *peer);
+
+  //! Forget the session for a peer
+  /*!
+  Call this if the server fails verification, so the session isn't
+  offered again.
+  */
+  static void forget(const String &peer);
+
+  //! Rotate the session ticket key now
+  /*!
+  Tickets made with the key before this one are still accepted, older
+  ones need a full handshake.  The key is also rotated every
+  kLifetime seconds without calling this.
+  */
+  static void rotateTicketKey();
+
+  //! Free all sessions and ticket keys
+  /*!
+  Call this on shutdown, once no secure sockets are left.
+  */
+  static void cleanup();
+
+  //@}
+
+  //! How long sessions and ticket keys are valid for, in seconds
+  static const long kLifetime = 24 * 60 * 60;
+};
@@ -21,7 +21,10 @@
 #include "base/Log.h"
 #include "base/Path.h"
 #include "base/TMethodEventJob.h"
+#include "base/Trace.h"
 #include "mt/Lock.h"
+#include "net/NetworkAddress.h"
+#include "net/SecureSession.h"
 #include "net/TCPSocket.h"
 #include "net/TSocketMultiplexerMethodJob.h"
 #include <net/InverseSockets/SslLogger.h>
@@ -88,6 +91,14 @@ void SecureSocket::close()
 
 void SecureSocket::connect(const NetworkAddress &addr)
 {
+  // sessions are stored by the name the user gave for the server, so
+  // that any of its addresses can resume them
+  String host = addr.getHostname();
+  if (host.empty() && addr.getAddress() != nullptr) {
+    host = ARCH->addrToString(addr.getAddress());
+  }
+  m_sessionPeer = deskflow::string::sprintf("%s:%d", host.c_str(), addr.getPort());
+
   m_events->adoptHandler(
       m_events->forIDataSocket().connected(), getEventTarget(),
       new TMethodEventJob<SecureSocket>(this, &SecureSocket::handleTCPConnected)
@@ -145,6 +156,7 @@ TCPSocket::EJobResult SecureSocket::doRead()
     // slurp up as much as possible
     do {
       m_inputBuffer.write(buffer, bytesRead);
+      TRACE(TraceEvent::kSocketRead, bytesRead);
 
       status = secureRead(buffer, sizeof(buffer), bytesRead);
       if (status < 0) {
@@ -203,6 +215,7 @@ TCPSocket::EJobResult SecureSocket::doWrite()
 
   if (isSecureReady()) {
     status = secureWrite(s_staticBuffer, bufferSize, bytesWrote);
+    TRACE(TraceEvent::kSocketWrite, bytesWrote, bufferSize - bytesWrote);
     if (status > 0) {
       s_retry = false;
       bufferSize = 0;
@@ -362,6 +375,14 @@ void SecureSocket::initContext(bool server)
 
   if (m_ssl->m_context == NULL) {
     SslLogger::logError();
+    return;
+  }
+
+  // allow reconnecting clients to resume their session
+  if (server) {
+    SecureSession::setupServerContext(m_ssl->m_context);
+  } else {
+    SecureSession::setupClientContext(m_ssl->m_context);
   }
 }
 
@@ -425,6 +446,9 @@ int SecureSocket::secureAccept(int socket)
   if (retry == 0) {
     m_secureReady = true;
     LOG((CLOG_INFO "accepted secure socket"));
+    if (SSL_session_reused(m_ssl->m_ssl)) {
+      LOG((CLOG_DEBUG "resumed tls session"));
+    }
     SslLogger::logSecureCipherInfo(m_ssl->m_ssl);
     SslLogger::logSecureConnectInfo(m_ssl->m_ssl);
     return 1;
@@ -450,6 +474,11 @@ int SecureSocket::secureConnect(int socket)
   // attach the socket descriptor
   SSL_set_fd(m_ssl->m_ssl, socket);
 
+  // the session is only set before the first attempt of the handshake
+  if (SSL_get_session(m_ssl->m_ssl) == NULL) {
+    SecureSession::resume(m_ssl->m_ssl, &m_sessionPeer);
+  }
+
   LOG((CLOG_DEBUG2 "connecting secure socket"));
 
   // TODO: S1-1766, enable hostname verification.
@@ -481,14 +510,19 @@ int SecureSocket::secureConnect(int socket)
   if (verifyCertFingerprint()) {
     LOG((CLOG_INFO "connected to secure socket"));
     if (!showCertificate()) {
+      SecureSession::forget(m_sessionPeer);
       disconnect();
       return -1; // Cert fail, error
     }
   } else {
     LOG((CLOG_ERR "failed to verify server certificate fingerprint"));
+    SecureSession::forget(m_sessionPeer);
     disconnect();
     return -1; // Fingerprint failed, error
   }
+  if (SSL_session_reused(m_ssl->m_ssl)) {
+    LOG((CLOG_INFO "resumed tls session"));
+  }
   LOG((CLOG_DEBUG2 "connected secure socket"));
   SslLogger::logSecureCipherInfo(m_ssl->m_ssl);
   SslLogger::logSecureConnectInfo(m_ssl->m_ssl);
@@ -90,4 +90,5 @@ private:
   Ssl *m_ssl;
   bool m_secureReady;
   bool m_fatal;
+  String m_sessionPeer;
 };
@@ -110,11 +110,17 @@ void *TCPListenSocket::getEventTarget() const
   return const_cast<void *>(static_cast<const void *>(this));
 }
 
-IDataSocket *TCPListenSocket::accept()
+IDataSocket *TCPListenSocket::accept(String *peerAddress)
 {
   IDataSocket *socket = NULL;
   try {
-    socket = new TCPSocket(m_events, m_socketMultiplexer, ARCH->acceptSocket(m_socket, NULL));
+    ArchSocket accepted = acceptSocket(peerAddress);
+    if (accepted == NULL) {
+      // nothing left to accept, wait for the next connection
+      setListeningJob();
+      return NULL;
+    }
+    socket = new TCPSocket(m_events, m_socketMultiplexer, accepted);
     if (socket != NULL) {
       setListeningJob();
     }
@@ -134,6 +140,19 @@ IDataSocket *TCPListenSocket::accept()
   }
 }
 
+ArchSocket TCPListenSocket::acceptSocket(String *peerAddress)
+{
+  ArchNetAddress address = NULL;
+  ArchSocket socket = ARCH->acceptSocket(m_socket, &address);
+  if (address != NULL) {
+    if (peerAddress != NULL) {
+      *peerAddress = ARCH->addrToString(address);
+    }
+    ARCH->closeAddr(address);
+  }
+  return socket;
+}
+
 void TCPListenSocket::setListeningJob()
 {
   m_socketMultiplexer->addSocket(
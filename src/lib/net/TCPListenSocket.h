@@ -47,11 +47,18 @@ public:
   virtual void *getEventTarget() const;
 
   // IListenSocket overrides
-  virtual IDataSocket *accept();
+  virtual IDataSocket *accept(String *peerAddress = NULL);
 
 protected:
   void setListeningJob();
 
+  //! Accept a connection on the listen socket
+  /*!
+  Returns NULL if no connection is waiting, otherwise stores the peer's
+  address in \p peerAddress if that isn't NULL.
+  */
+  ArchSocket acceptSocket(String *peerAddress);
+
 public:
   ISocketMultiplexerJob *serviceListening(ISocketMultiplexerJob *, bool, bool, bool);
 
@@ -23,6 +23,7 @@
 #include "base/IEventJob.h"
 #include "base/IEventQueue.h"
 #include "base/Log.h"
+#include "base/Trace.h"
 #include "mt/Lock.h"
 #include "net/NetworkAddress.h"
 #include "net/SocketMultiplexer.h"
@@ -285,6 +286,21 @@ void TCPSocket::connect(const NetworkAddress &addr)
   setJob(newJob());
 }
 
+NetworkAddress TCPSocket::getLocalAddress() const
+{
+  Lock lock(&m_mutex);
+  if (m_socket == nullptr) {
+    return NetworkAddress();
+  }
+
+  try {
+    return NetworkAddress(ARCH->getSocketAddr(m_socket));
+  } catch (XArchNetwork &e) {
+    LOG((CLOG_DEBUG1 "cannot get local address: %s", e.what()));
+    return NetworkAddress();
+  }
+}
+
 void TCPSocket::init()
 {
   // default state
@@ -323,6 +339,7 @@ TCPSocket::EJobResult TCPSocket::doRead()
     // slurp up as much as possible
     do {
       m_inputBuffer.write(buffer, static_cast<UInt32>(bytesRead));
+      TRACE(TraceEvent::kSocketRead, static_cast<std::int32_t>(bytesRead));
 
       bytesRead = ARCH->readSocket(m_socket, buffer, sizeof(buffer));
     } while (bytesRead > 0);
@@ -356,6 +373,7 @@ TCPSocket::EJobResult TCPSocket::doWrite()
   bufferSize = m_outputBuffer.getSize();
   const void *buffer = m_outputBuffer.peek(bufferSize);
   bytesWrote = (UInt32)ARCH->writeSocket(m_socket, buffer, bufferSize);
+  TRACE(TraceEvent::kSocketWrite, bytesWrote, static_cast<std::int32_t>(bufferSize) - bytesWrote);
 
   if (bytesWrote > 0) {
     discardWrittenData(bytesWrote);
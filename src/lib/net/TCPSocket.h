@@ -66,6 +66,7 @@ public:
 
   // IDataSocket overrides
   virtual void connect(const NetworkAddress &);
+  virtual NetworkAddress getLocalAddress() const;
 
   virtual ISocketMultiplexerJob *newJob();
 
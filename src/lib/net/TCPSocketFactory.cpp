@@ -19,6 +19,7 @@
 #include "net/TCPSocketFactory.h"
 #include "arch/Arch.h"
 #include "base/Log.h"
+#include "net/DatagramSocket.h"
 #include "net/SecureListenSocket.h"
 #include "net/SecureSocket.h"
 #include "net/TCPListenSocket.h"
@@ -62,3 +63,8 @@ IListenSocket *TCPSocketFactory::createListen(bool secure, IArchNetwork::EAddres
 
   return socket;
 }
+
+DatagramSocket *TCPSocketFactory::createDatagram(IArchNetwork::EAddressFamily family) const
+{
+  return new DatagramSocket(m_events, m_socketMultiplexer, family);
+}
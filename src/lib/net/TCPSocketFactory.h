@@ -34,6 +34,7 @@ public:
   // ISocketFactory overrides
   virtual IDataSocket *create(bool secure, IArchNetwork::EAddressFamily family = IArchNetwork::kINET) const;
   virtual IListenSocket *createListen(bool secure, IArchNetwork::EAddressFamily family = IArchNetwork::kINET) const;
+  virtual DatagramSocket *createDatagram(IArchNetwork::EAddressFamily family = IArchNetwork::kINET) const;
 
 private:
   IEventQueue *m_events;
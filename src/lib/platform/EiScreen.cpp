@@ -24,6 +24,7 @@
 #include "base/Log.h"
 #include "base/Stopwatch.h"
 #include "base/TMethodEventJob.h"
+#include "base/Trace.h"
 #include "deskflow/App.h"
 #include "deskflow/Clipboard.h"
 #include "deskflow/KeyMap.h"
@@ -301,6 +302,7 @@ void EiScreen::fakeMouseButton(ButtonID button, bool press)
 
 void EiScreen::fakeMouseMove(int32_t x, int32_t y)
 {
+  TRACE(TraceEvent::kFakeMouseMove, x, y);
   // We get one motion event before enter() with the target position
   if (!is_on_screen_) {
     cursor_x_ = x;
@@ -25,6 +25,7 @@
 #include "base/String.h"
 #include "base/TMethodEventJob.h"
 #include "base/TMethodJob.h"
+#include "base/Trace.h"
 #include "client/Client.h"
 #include "deskflow/App.h"
 #include "deskflow/ArgsBase.h"
@@ -766,6 +767,7 @@ void MSWindowsScreen::fakeMouseButton(ButtonID id, bool press)
 
 void MSWindowsScreen::fakeMouseMove(SInt32 x, SInt32 y)
 {
+  TRACE(TraceEvent::kFakeMouseMove, x, y);
   m_desks->fakeMouseMove(x, y);
   if (m_buttons[kButtonLeft]) {
     m_draggingStarted = true;
@@ -24,6 +24,7 @@
 #include "base/Log.h"
 #include "base/TMethodEventJob.h"
 #include "base/TMethodJob.h"
+#include "base/Trace.h"
 #include "client/Client.h"
 #include "deskflow/ClientApp.h"
 #include "deskflow/Clipboard.h"
@@ -612,6 +613,7 @@ void OSXScreen::getDropTargetThread(void *)
 
 void OSXScreen::fakeMouseMove(SInt32 x, SInt32 y)
 {
+  TRACE(TraceEvent::kFakeMouseMove, x, y);
   if (m_fakeDraggingStarted) {
     m_buttonState.set(0, kMouseButtonDown);
   }
@@ -34,6 +34,22 @@
 #include <algorithm>
 #include <cstdio>
 #include <cstring>
+#include <poll.h>
+
+namespace {
+
+// wait until the X server sends something or the timeout (in seconds)
+// expires, so that a selection transfer doesn't wait for a sleep to end.
+void waitForXEvent(Display *display, double timeout)
+{
+  pollfd pfd;
+  pfd.fd = ConnectionNumber(display);
+  pfd.events = POLLIN;
+  pfd.revents = 0;
+  poll(&pfd, 1, std::max(0, static_cast<int>(timeout * 1000.0)) + 1);
+}
+
+} // namespace
 
 //
 // XWindowsClipboard
@@ -47,7 +63,8 @@ XWindowsClipboard::XWindowsClipboard(Display *display, Window window, ClipboardI
       m_time(0),
       m_owner(false),
       m_timeOwned(0),
-      m_timeLost(0)
+      m_timeLost(0),
+      m_requested(0)
 {
   // get some atoms
   m_atomTargets = XInternAtom(m_display, "TARGETS", False);
@@ -103,6 +120,7 @@ void XWindowsClipboard::lost(Time time)
     m_owner = false;
     m_timeLost = time;
     clearCache();
+    pushReplies();
   }
 }
 
@@ -164,16 +182,17 @@ bool XWindowsClipboard::addSimpleRequest(Window requestor, Atom target, ::Time t
     IXWindowsClipboardConverter *converter = getConverter(target);
     if (converter != nullptr) {
       IClipboard::EFormat clipboardFormat = converter->getFormat();
-      if (m_added[clipboardFormat]) {
-        try {
-          data = converter->fromIClipboard(m_data[clipboardFormat]);
-          format = converter->getDataSize();
-          type = converter->getAtom();
-        } catch (...) {
-          // ignore -- cannot convert
-          LOG((CLOG_WARN "error while converting clipboard data"));
-        }
+      if (m_deferred[clipboardFormat]) {
+        // answered by resolve() when the data arrives
+        LOG((CLOG_DEBUG1 "waiting for format %d", clipboardFormat));
+        Reply *reply = new Reply(requestor, target, time, property, String(), None, 0);
+        reply->m_waiting = true;
+        reply->m_waitStart = ARCH->time();
+        insertReply(reply);
+        m_requested |= 1u << clipboardFormat;
+        return true;
       }
+      type = convertData(converter, data, &format);
     }
   }
 
@@ -190,6 +209,24 @@ bool XWindowsClipboard::addSimpleRequest(Window requestor, Atom target, ::Time t
   }
 }
 
+Atom XWindowsClipboard::convertData(IXWindowsClipboardConverter *converter, String &data, int *format) const
+{
+  IClipboard::EFormat clipboardFormat = converter->getFormat();
+  if (!m_added[clipboardFormat]) {
+    return None;
+  }
+
+  try {
+    data = converter->fromIClipboard(m_data[clipboardFormat]);
+    *format = converter->getDataSize();
+    return converter->getAtom();
+  } catch (...) {
+    // ignore -- cannot convert
+    LOG((CLOG_WARN "error while converting clipboard data"));
+    return None;
+  }
+}
+
 bool XWindowsClipboard::processRequest(Window requestor, ::Time /*time*/, Atom property)
 {
   ReplyMap::iterator index = m_replies.find(requestor);
@@ -236,6 +273,93 @@ bool XWindowsClipboard::destroyRequest(Window requestor)
   return true;
 }
 
+void XWindowsClipboard::resolve(const IClipboard *source)
+{
+  // note the deferred formats we now know the answer for
+  UInt32 resolved = 0;
+  if (source->open(m_timeOwned)) {
+    for (SInt32 index = 0; index < kNumFormats; ++index) {
+      const auto format = static_cast<EFormat>(index);
+      if (!m_deferred[index] || (source->has(format) && source->isDeferred(format))) {
+        continue;
+      }
+      if (source->has(format)) {
+        m_data[index] = source->get(format);
+        m_added[index] = true;
+      }
+      m_deferred[index] = false;
+      resolved |= 1u << index;
+    }
+    source->close();
+  }
+  m_requested &= ~resolved;
+
+  // answer the requests waiting for those formats
+  for (ReplyMap::iterator index = m_replies.begin(); index != m_replies.end(); ++index) {
+    for (Reply *reply : index->second) {
+      if (!reply->m_waiting) {
+        continue;
+      }
+      IXWindowsClipboardConverter *converter = getConverter(reply->m_target);
+      if ((resolved & (1u << converter->getFormat())) == 0) {
+        continue;
+      }
+      reply->m_waiting = false;
+      reply->m_type = convertData(converter, reply->m_data, &reply->m_format);
+      if (reply->m_type == None) {
+        // a reply without a property is sent as a failure
+        reply->m_property = None;
+      }
+      LOG(
+          (CLOG_DEBUG1 "resolved request for format %d by 0x%08x: %s", converter->getFormat(), reply->m_requestor,
+           reply->m_type == None ? "failed" : "success")
+      );
+    }
+  }
+
+  pushReplies();
+}
+
+UInt32 XWindowsClipboard::takeRequestedFormats()
+{
+  const UInt32 formats = m_requested;
+  m_requested = 0;
+  return formats;
+}
+
+bool XWindowsClipboard::expireRequests(double timeout)
+{
+  const double now = ARCH->time();
+  bool waiting = false;
+  bool expired = false;
+  for (ReplyMap::iterator index = m_replies.begin(); index != m_replies.end(); ++index) {
+    for (Reply *reply : index->second) {
+      if (!reply->m_waiting) {
+        continue;
+      }
+      if (now - reply->m_waitStart < timeout) {
+        waiting = true;
+        continue;
+      }
+
+      // a reply without a property is sent as a failure.  the format
+      // stays deferred in case the data turns up for a later request.
+      LOG(
+          (CLOG_DEBUG1 "request for %s by 0x%08x timed out",
+           XWindowsUtil::atomToString(m_display, reply->m_target).c_str(), reply->m_requestor)
+      );
+      reply->m_waiting = false;
+      reply->m_property = None;
+      expired = true;
+    }
+  }
+
+  if (expired) {
+    pushReplies();
+  }
+  return waiting;
+}
+
 Window XWindowsClipboard::getWindow() const
 {
   return m_window;
@@ -263,6 +387,7 @@ bool XWindowsClipboard::empty()
   // to date.
   clearCache();
   m_cached = true;
+  pushReplies();
 
   // FIXME -- actually delete motif clipboard items?
   // FIXME -- do anything to motif clipboard properties?
@@ -287,10 +412,24 @@ void XWindowsClipboard::add(EFormat format, const String &data)
 
   m_data[format] = data;
   m_added[format] = true;
+  m_deferred[format] = false;
 
   // FIXME -- set motif clipboard item?
 }
 
+bool XWindowsClipboard::addDeferred(EFormat format, Time)
+{
+  assert(m_open);
+  assert(m_owner);
+
+  LOG((CLOG_DEBUG "defer clipboard %d format: %d", m_id, format));
+
+  m_data[format] = "";
+  m_added[format] = false;
+  m_deferred[format] = true;
+  return true;
+}
+
 bool XWindowsClipboard::open(Time time) const
 {
   if (m_open) {
@@ -354,7 +493,7 @@ bool XWindowsClipboard::has(EFormat format) const
   assert(m_open);
 
   fillCache();
-  return m_added[format];
+  return m_added[format] || m_deferred[format] || !m_pending[format].empty();
 }
 
 String XWindowsClipboard::get(EFormat format) const
@@ -362,9 +501,18 @@ String XWindowsClipboard::get(EFormat format) const
   assert(m_open);
 
   fillCache();
+  fetchFormat(format);
   return m_data[format];
 }
 
+bool XWindowsClipboard::isDeferred(EFormat format) const
+{
+  assert(m_open);
+
+  fillCache();
+  return !m_added[format] && (m_deferred[format] || !m_pending[format].empty());
+}
+
 void XWindowsClipboard::clearConverters()
 {
   for (ConverterList::iterator index = m_converters.begin(); index != m_converters.end(); ++index) {
@@ -434,7 +582,13 @@ void XWindowsClipboard::doClearCache()
   for (SInt32 index = 0; index < kNumFormats; ++index) {
     m_data[index] = "";
     m_added[index] = false;
+    m_deferred[index] = false;
+    m_pending[index].clear();
   }
+  m_requested = 0;
+
+  // the data requests are waiting for won't be given to us any more
+  failWaitingReplies();
 }
 
 void XWindowsClipboard::fillCache() const
@@ -458,21 +612,50 @@ void XWindowsClipboard::doFillCache()
   m_cacheTime = m_timeOwned;
 }
 
+void XWindowsClipboard::fetchFormat(EFormat format) const
+{
+  if (!m_pending[format].empty()) {
+    const_cast<XWindowsClipboard *>(this)->doFetchFormat(format);
+  }
+}
+
+void XWindowsClipboard::doFetchFormat(EFormat format)
+{
+  // try each advertised target until one converts
+  for (Atom target : m_pending[format]) {
+    Atom actualTarget;
+    String targetData;
+    if (!icccmGetSelection(target, &actualTarget, &targetData)) {
+      LOG((CLOG_DEBUG1 "  no data for target %s", XWindowsUtil::atomToString(m_display, target).c_str()));
+      continue;
+    }
+
+    m_data[format] = getConverter(target)->toIClipboard(targetData);
+    m_added[format] = true;
+    LOG(
+        (CLOG_DEBUG "fetched format %d for target %s (%u %s)", format,
+         XWindowsUtil::atomToString(m_display, target).c_str(), targetData.size(),
+         targetData.size() == 1 ? "byte" : "bytes")
+    );
+    break;
+  }
+  m_pending[format].clear();
+}
+
 void XWindowsClipboard::icccmFillCache()
 {
   LOG((CLOG_DEBUG "icccm fill clipboard %d", m_id));
 
-  // see if we can get the list of available formats from the selection.
-  // if not then use a default list of formats.  note that some clipboard
-  // owners are broken and report TARGETS as the type of the TARGETS data
-  // instead of the correct type ATOM;  allow either.
+  // get the list of available formats from the selection.  note that
+  // some clipboard owners are broken and report TARGETS as the type of
+  // the TARGETS data instead of the correct type ATOM;  allow either.
   const Atom atomTargets = m_atomTargets;
   Atom target;
   String data;
   if (!icccmGetSelection(atomTargets, &target, &data) || (target != m_atomAtom && target != m_atomTargets)) {
     LOG((CLOG_DEBUG1 "selection doesn't support TARGETS"));
-    data = "";
-    XWindowsUtil::appendAtomData(data, XA_STRING);
+    icccmProbeFormats();
+    return;
   }
 
   XWindowsUtil::convertAtomProperty(data);
@@ -480,8 +663,21 @@ void XWindowsClipboard::icccmFillCache()
   const UInt32 numTargets = data.size() / sizeof(Atom);
   LOG((CLOG_DEBUG "  available targets: %s", XWindowsUtil::atomsToString(m_display, targets, numTargets).c_str()));
 
-  // try each converter in order (because they're in order of
-  // preference).
+  // note the advertised targets for each format in converter order
+  // (because they're in order of preference) and leave getting the
+  // data until it's asked for, since some targets can be very large.
+  for (ConverterList::const_iterator index = m_converters.begin(); index != m_converters.end(); ++index) {
+    IXWindowsClipboardConverter *converter = *index;
+    if (std::find(targets, targets + numTargets, converter->getAtom()) != targets + numTargets) {
+      m_pending[converter->getFormat()].push_back(converter->getAtom());
+    }
+  }
+}
+
+void XWindowsClipboard::icccmProbeFormats()
+{
+  // without a list of targets just ask for each converter's target to
+  // see if it's available.
   for (ConverterList::const_iterator index = m_converters.begin(); index != m_converters.end(); ++index) {
     IXWindowsClipboardConverter *converter = *index;
 
@@ -490,25 +686,8 @@ void XWindowsClipboard::icccmFillCache()
       continue;
     }
 
-    // see if atom is in target list
-    Atom target = None;
-    // XXX -- just ask for the converter's target to see if it's
-    // available rather than checking TARGETS.  i've seen clipboard
-    // owners that don't report all the targets they support.
-    target = converter->getAtom();
-    /*
-    for (UInt32 i = 0; i < numTargets; ++i) {
-        if (converter->getAtom() == targets[i]) {
-            target = targets[i];
-            break;
-        }
-    }
-    */
-    if (target == None) {
-      continue;
-    }
-
     // get the data
+    const Atom target = converter->getAtom();
     Atom actualTarget;
     String targetData;
     if (!icccmGetSelection(target, &actualTarget, &targetData)) {
@@ -912,6 +1091,11 @@ bool XWindowsClipboard::sendReply(Reply *reply)
 {
   assert(reply != nullptr);
 
+  // wait until resolve() or failWaitingReplies()
+  if (reply->m_waiting) {
+    return false;
+  }
+
   // bail out immediately if reply is done
   if (reply->m_done) {
     LOG((
@@ -1082,6 +1266,19 @@ void XWindowsClipboard::clearReplies(ReplyList &replies)
   replies.clear();
 }
 
+void XWindowsClipboard::failWaitingReplies()
+{
+  for (ReplyMap::iterator index = m_replies.begin(); index != m_replies.end(); ++index) {
+    for (Reply *reply : index->second) {
+      if (reply->m_waiting) {
+        // a reply without a property is sent as a failure
+        reply->m_waiting = false;
+        reply->m_property = None;
+      }
+    }
+  }
+}
+
 void XWindowsClipboard::sendNotify(Window requestor, Atom selection, Atom target, Atom property, Time time)
 {
   XEvent event;
@@ -1141,7 +1338,7 @@ Atom XWindowsClipboard::getTargetsData(String &data, int *format) const
     IXWindowsClipboardConverter *converter = *index;
 
     // skip formats we don't have
-    if (m_added[converter->getFormat()]) {
+    if (m_added[converter->getFormat()] || m_deferred[converter->getFormat()]) {
       XWindowsUtil::appendAtomData(data, converter->getAtom());
     }
   }
@@ -1209,10 +1406,9 @@ bool XWindowsClipboard::CICCCMGetClipboard::readClipboard(
   XSync(display, False);
 
   // Xlib inexplicably omits the ability to wait for an event with
-  // a timeout.  (it's inexplicable because there's no portable way
-  // to do it.)  we'll poll until we have what we're looking for or
-  // a timeout expires.  we use a timeout so we don't get locked up
-  // by badly behaved selection owners.
+  // a timeout, so we wait on the connection ourselves until we have
+  // what we're looking for or a timeout expires.  we use a timeout so
+  // we don't get locked up by badly behaved selection owners.
   XEvent xevent;
   std::vector<XEvent> events;
   Stopwatch timeout(false);             // timer not stopped, not triggered
@@ -1250,7 +1446,7 @@ bool XWindowsClipboard::CICCCMGetClipboard::readClipboard(
         }
       }
     } else {
-      ARCH->sleep(0.01);
+      waitForXEvent(display, s_timeout - timeout.getTime());
     }
   }
 
@@ -1388,6 +1584,8 @@ XWindowsClipboard::Reply::Reply(Window requestor, Atom target, ::Time time)
       m_property(None),
       m_replied(false),
       m_done(false),
+      m_waiting(false),
+      m_waitStart(0.0),
       m_data(),
       m_type(None),
       m_format(32),
@@ -1405,6 +1603,8 @@ XWindowsClipboard::Reply::Reply(
       m_property(property),
       m_replied(false),
       m_done(false),
+      m_waiting(false),
+      m_waitStart(0.0),
       m_data(data),
       m_type(type),
       m_format(format),
@@ -76,6 +76,30 @@ public:
   */
   bool destroyRequest(Window requestor);
 
+  //! Resolve deferred formats
+  /*!
+  Fills in the formats that were deferred when the clipboard was set
+  from \c source's data and answers the requests waiting for them.
+  Requests for formats \c source doesn't have fail.  Formats
+  \c source still defers stay deferred.
+  */
+  void resolve(const IClipboard *source);
+
+  //! Take requested formats
+  /*!
+  Returns the deferred formats (bit \c 1 << format) that requests
+  have had to wait for since the last call.
+  */
+  UInt32 takeRequestedFormats();
+
+  //! Fail overdue requests
+  /*!
+  Fails the requests that have waited \c timeout seconds or more for
+  deferred data, which the data's source may never send.  Returns true
+  iff any requests are still waiting.
+  */
+  bool expireRequests(double timeout);
+
   //! Get window
   /*!
   Returns the clipboard's window (passed the c'tor).
@@ -92,11 +116,13 @@ public:
   // IClipboard overrides
   virtual bool empty();
   virtual void add(EFormat, const String &data);
+  virtual bool addDeferred(EFormat, Time owned);
   virtual bool open(Time) const;
   virtual void close() const;
   virtual Time getTime() const;
   virtual bool has(EFormat) const;
   virtual String get(EFormat) const;
+  virtual bool isDeferred(EFormat) const;
 
 private:
   // remove all converters from our list
@@ -113,10 +139,14 @@ private:
 
   // add a non-MULTIPLE request.  does not verify that the selection
   // was owned at the given time.  returns true if the conversion
-  // could be performed, false otherwise.  in either case, the
-  // reply is inserted.
+  // could be performed or has to wait for deferred data, false
+  // otherwise.  in either case, the reply is inserted.
   bool addSimpleRequest(Window requestor, Atom target, ::Time time, Atom property);
 
+  // convert the data of the converter's format.  returns the type of
+  // the converted data or None if it can't be converted.
+  Atom convertData(IXWindowsClipboardConverter *, String &data, int *format) const;
+
   // if not already checked then see if the cache is stale and, if so,
   // clear it.  this has the side effect of updating m_timeOwned.
   void checkCache() const;
@@ -126,10 +156,15 @@ private:
   void clearCache() const;
   void doClearCache();
 
-  // cache all formats of the selection
+  // cache the formats available from the selection.  the data of
+  // each format is fetched by fetchFormat().
   void fillCache() const;
   void doFillCache();
 
+  // get the data for a format that's available but not yet fetched
+  void fetchFormat(EFormat) const;
+  void doFetchFormat(EFormat);
+
 protected:
   //
   // helper classes
@@ -250,6 +285,13 @@ protected:
     // true iff the reply has sent its last message
     bool m_done;
 
+    // true iff the reply is waiting for deferred data.  a waiting
+    // reply holds up the replies after it to the same requestor.
+    bool m_waiting;
+
+    // when the reply started waiting for deferred data
+    double m_waitStart;
+
     // the data to send and its type and format
     String m_data;
     Atom m_type;
@@ -264,6 +306,7 @@ protected:
 
   // ICCCM interoperability methods
   void icccmFillCache();
+  void icccmProbeFormats();
   bool icccmGetSelection(Atom target, Atom *actualTarget, String *data) const;
   Time icccmGetTime() const;
 
@@ -283,6 +326,7 @@ protected:
   bool sendReply(Reply *);
   void clearReplies();
   void clearReplies(ReplyList &);
+  void failWaitingReplies();
   void sendNotify(Window requestor, Atom selection, Atom target, Atom property, Time time);
   bool wasOwnedAtTime(::Time) const;
 
@@ -313,6 +357,18 @@ private:
   bool m_added[kNumFormats];
   String m_data[kNumFormats];
 
+  // targets the selection owner advertised for each format that
+  // haven't been fetched yet, most desired first.  has() reports these
+  // formats but get() returns an empty string if the owner then fails
+  // to convert all of them.
+  std::vector<Atom> m_pending[kNumFormats];
+
+  // formats we own but whose data hasn't been given to us yet, and
+  // those that requests are waiting for that haven't been taken by
+  // takeRequestedFormats()
+  bool m_deferred[kNumFormats];
+  UInt32 m_requested;
+
   // conversion request replies
   ReplyMap m_replies;
   ReplyEventMask m_eventMasks;
@@ -23,6 +23,7 @@
 #include "base/IEventQueue.h"
 #include "base/Log.h"
 #include "base/Stopwatch.h"
+#include "base/Trace.h"
 #include "base/String.h"
 #include "base/TMethodEventJob.h"
 #include "deskflow/App.h"
@@ -80,6 +81,11 @@ extern "C"
 
 static int xi_opcode;
 
+// how long a selection request waits for clipboard data the server
+// hasn't sent yet, and how often that's checked
+static const double s_clipboardRequestTimeout = 5.0;
+static const double s_clipboardRequestCheck = 1.0;
+
 //
 // XWindowsScreen
 //
@@ -123,6 +129,7 @@ XWindowsScreen::XWindowsScreen(
       m_ic(NULL),
       m_lastKeycode(0),
       m_sequenceNumber(0),
+      m_clipboardRequestTimer(NULL),
       m_screensaver(NULL),
       m_screensaverNotify(false),
       m_xtestIsXineramaUnaware(true),
@@ -212,6 +219,7 @@ XWindowsScreen::~XWindowsScreen()
 
   m_events->adoptBuffer(NULL);
   m_events->removeHandler(Event::kSystem, m_events->getSystemTarget());
+  cleanupClipboardRequestTimer();
   for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
     delete m_clipboard[id];
   }
@@ -414,6 +422,13 @@ bool XWindowsScreen::setClipboard(ClipboardID id, const IClipboard *clipboard)
   }
 }
 
+void XWindowsScreen::resolveClipboard(ClipboardID id, const IClipboard *clipboard)
+{
+  if (m_clipboard[id] != NULL) {
+    m_clipboard[id]->resolve(clipboard);
+  }
+}
+
 void XWindowsScreen::checkClipboards()
 {
   // do nothing, we're always up to date
@@ -472,6 +487,12 @@ bool XWindowsScreen::isPrimary() const
   return m_isPrimary;
 }
 
+UInt32 XWindowsScreen::getDeferrableClipboardFormats() const
+{
+  // we answer selection requests ourselves so any format can wait
+  return IClipboard::kAllFormats;
+}
+
 String XWindowsScreen::getSecureInputApp() const
 {
   // ignore on Linux
@@ -806,6 +827,7 @@ void XWindowsScreen::fakeMouseButton(ButtonID button, bool press)
 
 void XWindowsScreen::fakeMouseMove(SInt32 x, SInt32 y)
 {
+  TRACE(TraceEvent::kFakeMouseMove, x, y);
   if (m_xinerama && m_xtestIsXineramaUnaware) {
     XWarpPointer(m_display, None, m_root, 0, 0, 0, 0, x, y);
   } else {
@@ -1135,6 +1157,36 @@ void XWindowsScreen::sendClipboardEvent(Event::Type type, ClipboardID id)
   sendEvent(type, info);
 }
 
+void XWindowsScreen::handleClipboardRequestTimer(const Event &, void *)
+{
+  bool waiting = false;
+  for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+    if (m_clipboard[id] != NULL && m_clipboard[id]->expireRequests(s_clipboardRequestTimeout)) {
+      waiting = true;
+    }
+  }
+  if (!waiting) {
+    cleanupClipboardRequestTimer();
+  }
+}
+
+void XWindowsScreen::cleanupClipboardRequestTimer()
+{
+  if (m_clipboardRequestTimer != NULL) {
+    m_events->removeHandler(Event::kTimer, m_clipboardRequestTimer);
+    m_events->deleteTimer(m_clipboardRequestTimer);
+    m_clipboardRequestTimer = NULL;
+  }
+}
+
+void XWindowsScreen::sendClipboardRequestEvent(ClipboardID id, UInt32 formats)
+{
+  ClipboardRequestInfo *info = (ClipboardRequestInfo *)malloc(sizeof(ClipboardRequestInfo));
+  info->m_id = id;
+  info->m_formats = formats;
+  sendEvent(m_events->forClipboard().clipboardRequested(), info);
+}
+
 IKeyState *XWindowsScreen::getKeyState() const
 {
   return m_keyState;
@@ -1307,6 +1359,21 @@ void XWindowsScreen::handleSystemEvent(const Event &event, void *)
           xevent->xselectionrequest.owner, xevent->xselectionrequest.requestor, xevent->xselectionrequest.target,
           xevent->xselectionrequest.time, xevent->xselectionrequest.property
       );
+
+      // ask for deferred data the request has to wait for
+      const UInt32 formats = m_clipboard[id]->takeRequestedFormats();
+      if (formats != 0) {
+        sendClipboardRequestEvent(id, formats);
+      }
+
+      // refuse the request if the data never arrives
+      if (m_clipboardRequestTimer == NULL && m_clipboard[id]->expireRequests(s_clipboardRequestTimeout)) {
+        m_clipboardRequestTimer = m_events->newTimer(s_clipboardRequestCheck, NULL);
+        m_events->adoptHandler(
+            Event::kTimer, m_clipboardRequestTimer,
+            new TMethodEventJob<XWindowsScreen>(this, &XWindowsScreen::handleClipboardRequestTimer)
+        );
+      }
       return;
     }
   } break;
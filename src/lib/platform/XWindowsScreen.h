@@ -32,6 +32,7 @@
 #include <X11/Xlib.h>
 #endif
 
+class EventQueueTimer;
 class XWindowsClipboard;
 class XWindowsKeyState;
 class XWindowsScreenSaver;
@@ -81,6 +82,7 @@ public:
   bool canLeave() override;
   void leave() override;
   bool setClipboard(ClipboardID, const IClipboard *) override;
+  void resolveClipboard(ClipboardID, const IClipboard *) override;
   void checkClipboards() override;
   void openScreensaver(bool notify) override;
   void closeScreensaver() override;
@@ -89,6 +91,7 @@ public:
   void setOptions(const OptionsList &options) override;
   void setSequenceNumber(UInt32) override;
   bool isPrimary() const override;
+  UInt32 getDeferrableClipboardFormats() const override;
   String getSecureInputApp() const override;
 
 protected:
@@ -101,6 +104,7 @@ private:
   // event sending
   void sendEvent(Event::Type, void * = NULL);
   void sendClipboardEvent(Event::Type, ClipboardID);
+  void sendClipboardRequestEvent(ClipboardID, UInt32 formats);
 
   // create the transparent cursor
   Cursor createBlankCursor() const;
@@ -115,6 +119,10 @@ private:
   // terminate a selection request
   void destroyClipboardRequest(Window window);
 
+  // fail selection requests that have waited too long for deferred data
+  void handleClipboardRequestTimer(const Event &, void *);
+  void cleanupClipboardRequestTimer();
+
   // X I/O error handler
   void onError();
   static int ioErrorHandler(Display *);
@@ -218,6 +226,7 @@ private:
   // clipboards
   XWindowsClipboard *m_clipboard[kClipboardEnd];
   UInt32 m_sequenceNumber;
+  EventQueueTimer *m_clipboardRequestTimer;
 
   // screen saver stuff
   XWindowsScreenSaver *m_screensaver;
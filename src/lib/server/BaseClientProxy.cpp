@@ -22,7 +22,7 @@
 // BaseClientProxy
 //
 
-BaseClientProxy::BaseClientProxy(const String &name) : m_name(name), m_x(0), m_y(0)
+BaseClientProxy::BaseClientProxy(const String &name) : m_name(name), m_id(ScreenNames::kNoScreen), m_x(0), m_y(0)
 {
   // do nothing
 }
@@ -38,13 +38,18 @@ void BaseClientProxy::setJumpCursorPos(SInt32 x, SInt32 y)
   m_y = y;
 }
 
+void BaseClientProxy::setId(ScreenID id)
+{
+  m_id = id;
+}
+
 void BaseClientProxy::getJumpCursorPos(SInt32 &x, SInt32 &y) const
 {
   x = m_x;
   y = m_y;
 }
 
-String BaseClientProxy::getName() const
+const String &BaseClientProxy::getName() const
 {
   return m_name;
 }
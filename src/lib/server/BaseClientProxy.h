@@ -20,6 +20,7 @@
 
 #include "base/String.h"
 #include "deskflow/IClient.h"
+#include "server/ScreenNames.h"
 
 namespace deskflow {
 class IStream;
@@ -44,6 +45,12 @@ public:
   */
   void setJumpCursorPos(SInt32 x, SInt32 y);
 
+  //! Set screen id
+  /*!
+  Set the id of the screen the server found this client's name under.
+  */
+  void setId(ScreenID id);
+
   //@}
   //! @name accessors
   //@{
@@ -54,6 +61,27 @@ public:
   */
   void getJumpCursorPos(SInt32 &x, SInt32 &y) const;
 
+  //! Get screen id
+  /*!
+  Returns the id set by setId(), or ScreenNames::kNoScreen if the
+  server hasn't accepted the client yet.
+  */
+  ScreenID getId() const
+  {
+    return m_id;
+  }
+
+  //! Check for on demand clipboard data
+  /*!
+  Return true if the client asks for the clipboard data it needs, so
+  setClipboard() may be given a clipboard with deferred formats.  Other
+  clients must be given every format's data.
+  */
+  virtual bool requestsClipboardData() const
+  {
+    return false;
+  }
+
   //! Get cursor position
   /*!
   Return if this proxy is for client or primary.
@@ -92,10 +120,11 @@ public:
   virtual void fileChunkSending(UInt8 mark, char *data, size_t dataSize) = 0;
   virtual String getSecureInputApp() const = 0;
   virtual void secureInputNotification(const String &app) const = 0;
-  virtual String getName() const;
+  virtual const String &getName() const;
   virtual deskflow::IStream *getStream() const = 0;
 
 private:
   String m_name;
+  ScreenID m_id;
   SInt32 m_x, m_y;
 };
@@ -19,16 +19,34 @@
 #include "server/ClientListener.h"
 #include "server/Server.h"
 
+#include "arch/Arch.h"
 #include "base/IEventQueue.h"
 #include "base/Log.h"
 #include "base/TMethodEventJob.h"
 #include "deskflow/PacketStreamFilter.h"
+#include "deskflow/protocol_types.h"
 #include "net/IDataSocket.h"
 #include "net/IListenSocket.h"
 #include "net/ISocketFactory.h"
 #include "net/XSocket.h"
 #include "server/ClientProxy.h"
 #include "server/ClientProxyUnknown.h"
+#include "server/ServerMotionChannel.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+// stops a single host from using up all of the handshakes.  this caps
+// the handshakes in progress at once, not how often a host connects,
+// and clients sharing an address behind nat share the cap too.
+const size_t kMaxHandshakesPerAddress = 4;
+
+// how soon to look at the listen backlog again when it isn't drained
+const double kRetryAcceptDelay = 1.0;
+
+} // namespace
 
 //
 // ClientListener
@@ -41,7 +59,8 @@ ClientListener::ClientListener(
       m_server(NULL),
       m_events(events),
       m_useSecureNetwork(enableCrypto),
-      m_address(address)
+      m_address(address),
+      m_handshakeTimeout(kDefaultHandshakeTimeout)
 {
   assert(m_socketFactory != NULL);
 
@@ -62,6 +81,7 @@ ClientListener::ClientListener(
 ClientListener::~ClientListener()
 {
   stop();
+  delete m_motionChannel;
   delete m_socketFactory;
 }
 
@@ -71,6 +91,20 @@ void ClientListener::setServer(Server *server)
   m_server = server;
 }
 
+void ClientListener::setMaxHandshakes(int maxHandshakes)
+{
+  if (maxHandshakes <= 0) {
+    m_maxHandshakes = std::numeric_limits<size_t>::max();
+  } else {
+    m_maxHandshakes = static_cast<size_t>(maxHandshakes);
+  }
+}
+
+void ClientListener::setHandshakeTimeout(double seconds)
+{
+  m_handshakeTimeout = seconds;
+}
+
 ClientProxy *ClientListener::getNextClient()
 {
   ClientProxy *client = NULL;
@@ -103,7 +137,7 @@ void ClientListener::stop()
 
   // discard already connected clients
   for (NewClients::iterator index = m_newClients.begin(); index != m_newClients.end(); ++index) {
-    ClientProxyUnknown *client = *index;
+    ClientProxyUnknown *client = index->first;
     m_events->removeHandler(m_events->forClientProxyUnknown().success(), client);
     m_events->removeHandler(m_events->forClientProxyUnknown().failure(), client);
     m_events->removeHandler(m_events->forClientProxy().disconnected(), client);
@@ -117,6 +151,19 @@ void ClientListener::stop()
     client = getNextClient();
   }
 
+  m_newClients.clear();
+
+  // discard connections still in the tls handshake
+  if (m_retryTimer != nullptr) {
+    m_events->removeHandler(Event::kTimer, m_retryTimer);
+    m_events->deleteTimer(m_retryTimer);
+    m_retryTimer = nullptr;
+  }
+  for (Handshakes::iterator index = m_handshakes.begin(); index != m_handshakes.end(); ++index) {
+    removeHandshakeHandlers(index->first);
+  }
+  m_handshakes.clear();
+
   m_events->removeHandler(m_events->forIListenSocket().connecting(), m_listen);
   cleanupListenSocket();
   cleanupClientSockets();
@@ -127,7 +174,11 @@ void ClientListener::removeUnknownClient(ClientProxyUnknown *unknownClient)
   if (unknownClient) {
     m_events->removeHandler(m_events->forClientProxyUnknown().success(), unknownClient);
     m_events->removeHandler(m_events->forClientProxyUnknown().failure(), unknownClient);
-    m_newClients.erase(unknownClient);
+    NewClients::iterator index = m_newClients.find(unknownClient);
+    if (index != m_newClients.end()) {
+      m_handshakes.erase(index->second);
+      m_newClients.erase(index);
+    }
     delete unknownClient;
   }
 }
@@ -140,26 +191,137 @@ void ClientListener::restart()
   }
 }
 
-void ClientListener::handleClientConnecting(const Event &, void *)
+ServerMotionChannel *ClientListener::getMotionChannel()
 {
-  // accept client connection
-  IDataSocket *socket = m_listen->accept();
+  if (m_motionChannel == nullptr && !m_motionChannelFailed) {
+    // in client mode the listen address is the client's, not ours
+    m_motionChannelFailed = true;
+    if (m_server == nullptr || m_server->isClientMode()) {
+      return nullptr;
+    }
+
+    try {
+      m_motionChannel = new ServerMotionChannel(m_events, m_socketFactory, m_address, kKeepAliveRate);
+      m_motionChannelFailed = false;
+      LOG((CLOG_DEBUG "motion channel listening on udp port %d", m_motionChannel->getPort()));
+    } catch (XBase &e) {
+      LOG((CLOG_WARN "cannot open motion channel: %s", e.what()));
+    }
+  }
+  return m_motionChannel;
+}
 
-  if (socket == NULL) {
+void ClientListener::handleClientConnecting(const Event &, void *)
+{
+  // in client mode the listen socket makes a new connection on every
+  // call, so only accept the one we've been told about
+  if (m_server != NULL && m_server->isClientMode()) {
+    IDataSocket *socket = m_listen->accept();
+    if (socket != NULL) {
+      m_clientSockets.insert(socket);
+      m_events->adoptHandler(
+          m_events->forClientListener().accepted(), socket->getEventTarget(),
+          new TMethodEventJob<ClientListener>(this, &ClientListener::handleClientAccepted, socket)
+      );
+      if (!m_useSecureNetwork) {
+        m_events->addEvent(Event(m_events->forClientListener().accepted(), socket->getEventTarget()));
+      }
+    }
     return;
   }
 
-  m_clientSockets.insert(socket);
+  acceptClients();
+}
+
+void ClientListener::handleRetryAccept(const Event &, void *)
+{
+  m_events->removeHandler(Event::kTimer, m_retryTimer);
+  m_events->deleteTimer(m_retryTimer);
+  m_retryTimer = nullptr;
+  acceptClients();
+}
 
-  m_events->adoptHandler(
-      m_events->forClientListener().accepted(), socket->getEventTarget(),
-      new TMethodEventJob<ClientListener>(this, &ClientListener::handleClientAccepted, socket)
-  );
+void ClientListener::acceptClients()
+{
+  expireHandshakes();
+
+  // take every waiting connection in one go rather than one per event,
+  // so a burst of connections doesn't wait on the event queue.  when
+  // the limit is reached the rest stay in the listen backlog.
+  while (m_handshakes.size() < m_maxHandshakes) {
+    String address;
+    IDataSocket *socket = m_listen->accept(&address);
+    if (socket == NULL) {
+      return;
+    }
+
+    if (!address.empty()) {
+      size_t fromAddress = 0;
+      for (Handshakes::const_iterator index = m_handshakes.begin(); index != m_handshakes.end(); ++index) {
+        if (index->second.m_address == address) {
+          ++fromAddress;
+        }
+      }
+      if (fromAddress >= kMaxHandshakesPerAddress) {
+        LOG((CLOG_WARN "too many connections from %s, dropping connection", address.c_str()));
+        delete socket;
+        continue;
+      }
+    }
 
-  // When using non SSL, server accepts clients immediately, while SSL
-  // has to call secure accept which may require retry
-  if (!m_useSecureNetwork) {
-    m_events->addEvent(Event(m_events->forClientListener().accepted(), socket->getEventTarget()));
+    Handshake &handshake = m_handshakes[socket];
+    handshake.m_address = address;
+    handshake.m_started = ARCH->time();
+    handshake.m_accepted = false;
+    m_clientSockets.insert(socket);
+
+    m_events->adoptHandler(
+        m_events->forClientListener().accepted(), socket->getEventTarget(),
+        new TMethodEventJob<ClientListener>(this, &ClientListener::handleClientAccepted, socket)
+    );
+
+    // a failed tls handshake gives up its slot straight away
+    m_events->adoptHandler(
+        m_events->forISocket().disconnected(), socket->getEventTarget(),
+        new TMethodEventJob<ClientListener>(this, &ClientListener::handleHandshakeFailed, socket)
+    );
+
+    // When using non SSL, server accepts clients immediately, while SSL
+    // has to call secure accept which may require retry
+    if (!m_useSecureNetwork) {
+      m_events->addEvent(Event(m_events->forClientListener().accepted(), socket->getEventTarget()));
+    }
+  }
+
+  // a handshake finishing normally drains the backlog again, the timer
+  // is in case none do
+  LOG((CLOG_DEBUG1 "%d handshakes in progress, deferring new connections", static_cast<int>(m_handshakes.size())));
+  if (m_retryTimer == nullptr) {
+    m_retryTimer = m_events->newOneShotTimer(kRetryAcceptDelay, NULL);
+    m_events->adoptHandler(
+        Event::kTimer, m_retryTimer, new TMethodEventJob<ClientListener>(this, &ClientListener::handleRetryAccept)
+    );
+  }
+}
+
+void ClientListener::expireHandshakes()
+{
+  // connections that identify themselves are timed out by their
+  // ClientProxyUnknown, this catches the ones that never finish tls
+  const double now = ARCH->time();
+  Handshakes::iterator index = m_handshakes.begin();
+  while (index != m_handshakes.end()) {
+    if (index->second.m_accepted || now - index->second.m_started < m_handshakeTimeout) {
+      ++index;
+      continue;
+    }
+
+    IDataSocket *socket = index->first;
+    LOG((CLOG_WARN "tls handshake with %s timed out", index->second.m_address.c_str()));
+    removeHandshakeHandlers(socket);
+    m_clientSockets.erase(socket);
+    delete socket;
+    index = m_handshakes.erase(index);
   }
 }
 
@@ -173,10 +335,19 @@ void ClientListener::handleClientAccepted(const Event &, void *vsocket)
   deskflow::IStream *stream = new PacketStreamFilter(m_events, socket, false);
   assert(m_server != NULL);
 
-  // create proxy for unknown client
-  ClientProxyUnknown *client = new ClientProxyUnknown(stream, 30.0, m_server, m_events);
+  // the tls handshake comes out of the time the client has to identify
+  // itself, and from here on the proxy watches for it going away
+  double timeout = m_handshakeTimeout;
+  Handshakes::iterator handshake = m_handshakes.find(socket);
+  if (handshake != m_handshakes.end()) {
+    handshake->second.m_accepted = true;
+    timeout = std::max(0.0, timeout - (ARCH->time() - handshake->second.m_started));
+    m_events->removeHandler(m_events->forISocket().disconnected(), socket->getEventTarget());
+  }
 
-  m_newClients.insert(client);
+  // create proxy for unknown client
+  ClientProxyUnknown *client = new ClientProxyUnknown(stream, timeout, m_server, m_events);
+  m_newClients[client] = socket;
 
   // watch for events from unknown client
   m_events->adoptHandler(
@@ -189,6 +360,24 @@ void ClientListener::handleClientAccepted(const Event &, void *vsocket)
   );
 }
 
+void ClientListener::handleHandshakeFailed(const Event &, void *vsocket)
+{
+  IDataSocket *socket = static_cast<IDataSocket *>(vsocket);
+
+  Handshakes::iterator handshake = m_handshakes.find(socket);
+  if (handshake == m_handshakes.end() || handshake->second.m_accepted) {
+    return;
+  }
+
+  LOG((CLOG_DEBUG "connection from %s closed during tls handshake", handshake->second.m_address.c_str()));
+  removeHandshakeHandlers(socket);
+  m_handshakes.erase(handshake);
+  m_clientSockets.erase(socket);
+  delete socket;
+
+  acceptClients();
+}
+
 void ClientListener::handleUnknownClient(const Event &, void *vclient)
 {
   auto unknownClient = static_cast<ClientProxyUnknown *>(vclient);
@@ -200,6 +389,7 @@ void ClientListener::handleUnknownClient(const Event &, void *vclient)
   auto client = unknownClient->orphanClientProxy();
   if (client) {
     // handshake was successful
+    client->setLocalAddress(m_newClients[unknownClient]->getLocalAddress());
     m_waitingClients.push_back(client);
     m_events->addEvent(Event(m_events->forClientListener().connected(), this));
 
@@ -212,13 +402,20 @@ void ClientListener::handleUnknownClient(const Event &, void *vclient)
 
   // now finished with unknown client
   removeUnknownClient(unknownClient);
+  if (!m_server->isClientMode()) {
+    acceptClients();
+  }
 }
 
 void ClientListener::handleUnknownClientFailure(const Event &, void *vclient)
 {
   auto unknownClient = static_cast<ClientProxyUnknown *>(vclient);
   removeUnknownClient(unknownClient);
-  restart();
+  if (m_server->isClientMode()) {
+    restart();
+  } else {
+    acceptClients();
+  }
 }
 
 void ClientListener::handleClientDisconnected(const Event &, void *vclient)
@@ -243,6 +440,12 @@ void ClientListener::handleClientDisconnected(const Event &, void *vclient)
   }
 }
 
+void ClientListener::removeHandshakeHandlers(IDataSocket *socket)
+{
+  m_events->removeHandler(m_events->forClientListener().accepted(), socket->getEventTarget());
+  m_events->removeHandler(m_events->forISocket().disconnected(), socket->getEventTarget());
+}
+
 void ClientListener::cleanupListenSocket()
 {
   delete m_listen;
@@ -20,7 +20,9 @@
 
 #include "base/Event.h"
 #include "base/EventTypes.h"
+#include "base/String.h"
 #include "common/stddeque.h"
+#include "common/stdmap.h"
 #include "common/stdset.h"
 #include "server/Config.h"
 
@@ -30,8 +32,10 @@ class NetworkAddress;
 class IListenSocket;
 class ISocketFactory;
 class Server;
+class ServerMotionChannel;
 class IEventQueue;
 class IDataSocket;
+class EventQueueTimer;
 
 class ClientListener
 {
@@ -50,6 +54,22 @@ public:
 
   void setServer(Server *server);
 
+  //! Limit the number of handshakes in progress
+  /*!
+  At most \p maxHandshakes connections are accepted but not yet
+  identified as clients at any one time.  Further connections wait in
+  the listen backlog until a handshake finishes.  Zero or less means no
+  limit.
+  */
+  void setMaxHandshakes(int maxHandshakes);
+
+  //! Set the handshake timeout
+  /*!
+  Connections that haven't finished tls and identified themselves as a
+  client within \p seconds of being accepted are dropped.
+  */
+  void setHandshakeTimeout(double seconds);
+
   //@}
 
   //! @name accessors
@@ -72,8 +92,22 @@ public:
   //! This method restarts the listener
   void restart();
 
+  //! Get the motion channel
+  /*!
+  Returns the UDP motion channel for the listen address, binding it the
+  first time it's asked for.  Returns NULL if it can't be bound, or if
+  the server connects to its clients.
+  */
+  ServerMotionChannel *getMotionChannel();
+
   //@}
 
+  //! Default for \c setMaxHandshakes()
+  static const int kDefaultMaxHandshakes = 16;
+
+  //! Default for \c setHandshakeTimeout()
+  static constexpr double kDefaultHandshakeTimeout = 10.0;
+
 private:
   // client connection event handlers
   void handleClientConnecting(const Event &, void *);
@@ -81,6 +115,12 @@ private:
   void handleUnknownClient(const Event &, void *);
   void handleUnknownClientFailure(const Event &, void *);
   void handleClientDisconnected(const Event &, void *);
+  void handleRetryAccept(const Event &, void *);
+  void handleHandshakeFailed(const Event &, void *);
+
+  void acceptClients();
+  void expireHandshakes();
+  void removeHandshakeHandlers(IDataSocket *socket);
 
   void cleanupListenSocket();
   void cleanupClientSockets();
@@ -89,9 +129,18 @@ private:
   void removeUnknownClient(ClientProxyUnknown *unknownClient);
 
 private:
-  typedef std::set<ClientProxyUnknown *> NewClients;
+  // a connection that hasn't been identified as a client yet
+  struct Handshake
+  {
+    String m_address;
+    double m_started;
+    bool m_accepted;
+  };
+
+  typedef std::map<ClientProxyUnknown *, IDataSocket *> NewClients;
   typedef std::deque<ClientProxy *> WaitingClients;
   typedef std::set<IDataSocket *> ClientSockets;
+  typedef std::map<IDataSocket *, Handshake> Handshakes;
 
   IListenSocket *m_listen;
   ISocketFactory *m_socketFactory;
@@ -102,4 +151,10 @@ private:
   bool m_useSecureNetwork;
   ClientSockets m_clientSockets;
   NetworkAddress m_address;
+  ServerMotionChannel *m_motionChannel = nullptr;
+  bool m_motionChannelFailed = false;
+  Handshakes m_handshakes;
+  size_t m_maxHandshakes = kDefaultMaxHandshakes;
+  double m_handshakeTimeout;
+  EventQueueTimer *m_retryTimer = nullptr;
 };
@@ -20,6 +20,7 @@
 
 #include "base/EventQueue.h"
 #include "base/Log.h"
+#include "deskflow/IClipboard.h"
 #include "deskflow/ProtocolUtil.h"
 #include "io/IStream.h"
 
@@ -27,6 +28,8 @@
 // ClientProxy
 //
 
+ClientProxy::Broadcast *ClientProxy::s_broadcast = NULL;
+
 ClientProxy::ClientProxy(const String &name, deskflow::IStream *stream) : BaseClientProxy(name), m_stream(stream)
 {
 }
@@ -45,12 +48,96 @@ void ClientProxy::close(const char *msg)
   getStream()->flush();
 }
 
+void ClientProxy::writeShared(const char *fmt, ...)
+{
+  const Broadcast::Message *message = NULL;
+  Broadcast::Message formatted;
+  if (s_broadcast != NULL) {
+    for (const auto &shared : s_broadcast->m_messages) {
+      if (shared.first == fmt) {
+        message = &shared.second;
+        break;
+      }
+    }
+  }
+
+  if (message == NULL) {
+    va_list args;
+    va_start(args, fmt);
+    ProtocolUtil::vformatf(formatted, fmt, args);
+    va_end(args);
+
+    if (s_broadcast != NULL) {
+      s_broadcast->m_messages.push_back(std::make_pair(fmt, std::move(formatted)));
+      message = &s_broadcast->m_messages.back().second;
+    } else {
+      message = &formatted;
+    }
+  }
+#ifndef NDEBUG
+  else {
+    // the cache is keyed on the format alone, so catch a proxy that
+    // shares a message with different arguments
+    va_list args;
+    va_start(args, fmt);
+    ProtocolUtil::vformatf(formatted, fmt, args);
+    va_end(args);
+    assert(formatted == *message);
+  }
+#endif
+
+  if (!message->empty()) {
+    getStream()->write(message->data(), static_cast<UInt32>(message->size()));
+  }
+}
+
+const String &ClientProxy::marshallShared(const IClipboard *clipboard, String &buffer)
+{
+  if (s_broadcast == NULL) {
+    buffer = IClipboard::marshall(clipboard);
+    return buffer;
+  }
+
+  for (const auto &shared : s_broadcast->m_clipboards) {
+    if (shared.first == clipboard) {
+      return shared.second;
+    }
+  }
+  s_broadcast->m_clipboards.push_back(std::make_pair(clipboard, IClipboard::marshall(clipboard)));
+  return s_broadcast->m_clipboards.back().second;
+}
+
+void ClientProxy::setLocalAddress(const NetworkAddress &address)
+{
+  m_localAddress = address;
+}
+
 deskflow::IStream *ClientProxy::getStream() const
 {
   return m_stream;
 }
 
+const NetworkAddress &ClientProxy::getLocalAddress() const
+{
+  return m_localAddress;
+}
+
 void *ClientProxy::getEventTarget() const
 {
   return static_cast<IScreen *>(const_cast<ClientProxy *>(this));
 }
+
+//
+// ClientProxy::Broadcast
+//
+
+ClientProxy::Broadcast::Broadcast()
+{
+  assert(s_broadcast == NULL);
+  s_broadcast = this;
+}
+
+ClientProxy::Broadcast::~Broadcast()
+{
+  s_broadcast = NULL;
+}
@@ -21,8 +21,11 @@
 #include "base/Event.h"
 #include "base/EventTypes.h"
 #include "base/String.h"
+#include "net/NetworkAddress.h"
 #include "server/BaseClientProxy.h"
 
+#include <vector>
+
 namespace deskflow {
 class IStream;
 }
@@ -31,6 +34,34 @@ class IStream;
 class ClientProxy : public BaseClientProxy
 {
 public:
+  //! Message sent to many clients
+  /*!
+  While a Broadcast exists, a message written with writeShared() is only
+  formatted by the first proxy that writes it and the other proxies
+  write the same bytes.  Every proxy must be sending the same event,
+  though proxies for different protocol versions can use different
+  message formats.  Clipboards marshalled with marshallShared() are
+  likewise marshalled once and freed with the Broadcast.  Broadcasts
+  can't be nested.
+  */
+  class Broadcast
+  {
+  public:
+    Broadcast();
+    Broadcast(Broadcast const &) = delete;
+    ~Broadcast();
+
+    Broadcast &operator=(Broadcast const &) = delete;
+
+  private:
+    friend class ClientProxy;
+    typedef std::vector<UInt8> Message;
+
+    // a broadcast uses few formats, so this is searched linearly
+    std::vector<std::pair<const char *, Message>> m_messages;
+    std::vector<std::pair<const IClipboard *, String>> m_clipboards;
+  };
+
   /*!
   \c name is the name of the client.
   */
@@ -51,6 +82,12 @@ public:
   */
   void close(const char *msg);
 
+  //! Set the local address
+  /*!
+  Sets the address the client connected to.
+  */
+  void setLocalAddress(const NetworkAddress &address);
+
   //@}
   //! @name accessors
   //@{
@@ -61,6 +98,13 @@ public:
   */
   deskflow::IStream *getStream() const override;
 
+  //! Get the local address
+  /*!
+  Returns the address the client connected to, or an invalid address
+  if it isn't known.
+  */
+  const NetworkAddress &getLocalAddress() const;
+
   //@}
 
   // IScreen
@@ -90,6 +134,28 @@ public:
   void fileChunkSending(UInt8 mark, char *data, size_t dataSize) override = 0;
   void secureInputNotification(const String &app) const override = 0;
 
+protected:
+  //! Write a message that may be shared
+  /*!
+  Same as ProtocolUtil::writef() to our stream, except during a
+  Broadcast, when the message is only formatted once for all proxies.
+  Use it only for messages that are the same for every client; debug
+  builds assert that they are.
+  */
+  void writeShared(const char *fmt, ...);
+
+  //! Marshall a clipboard that may be shared
+  /*!
+  Returns \c IClipboard::marshall(clipboard), stored in \p buffer.
+  During a Broadcast the clipboard is only marshalled by the first proxy
+  and the Broadcast's copy is returned instead.  The reference is valid
+  until \p buffer or the Broadcast is destroyed.
+  */
+  const String &marshallShared(const IClipboard *clipboard, String &buffer);
+
 private:
   deskflow::IStream *m_stream;
+  NetworkAddress m_localAddress;
+
+  static Broadcast *s_broadcast;
 };
@@ -18,12 +18,15 @@
 
 #include "server/ClientProxy1_0.h"
 
+#include "arch/Arch.h"
 #include "base/IEventQueue.h"
 #include "base/Log.h"
 #include "base/TMethodEventJob.h"
+#include "base/Trace.h"
 #include "deskflow/ProtocolUtil.h"
 #include "deskflow/XDeskflow.h"
 #include "io/IStream.h"
+#include "server/HeartbeatTicker.h"
 
 #include <cstring>
 
@@ -33,7 +36,10 @@
 
 ClientProxy1_0::ClientProxy1_0(const String &name, deskflow::IStream *stream, IEventQueue *events)
     : ClientProxy(name, stream),
-      m_heartbeatTimer(NULL),
+      m_heartbeatAlarm(0.0),
+      m_lastHeartbeat(0.0),
+      m_heartbeatAdded(false),
+      m_heartbeatTicker(NULL),
       m_parser(&ClientProxy1_0::parseHandshakeMessage),
       m_events(events)
 {
@@ -54,14 +60,8 @@ ClientProxy1_0::ClientProxy1_0(const String &name, deskflow::IStream *stream, IE
       m_events->forIStream().outputShutdown(), stream->getEventTarget(),
       new TMethodEventJob<ClientProxy1_0>(this, &ClientProxy1_0::handleWriteError, NULL)
   );
-  m_events->adoptHandler(
-      Event::kTimer, this, new TMethodEventJob<ClientProxy1_0>(this, &ClientProxy1_0::handleFlatline, NULL)
-  );
 
   setHeartbeatRate(kHeartRate, kHeartRate * kHeartBeatsUntilDeath);
-
-  LOG((CLOG_DEBUG1 "querying client \"%s\" info", getName().c_str()));
-  ProtocolUtil::writef(getStream(), kMsgQInfo);
 }
 
 ClientProxy1_0::~ClientProxy1_0()
@@ -69,6 +69,17 @@ ClientProxy1_0::~ClientProxy1_0()
   removeHandlers();
 }
 
+void ClientProxy1_0::setHeartbeatTicker(HeartbeatTicker *ticker)
+{
+  // move the heartbeat timer to the new ticker
+  const bool added = m_heartbeatAdded;
+  removeHeartbeatTimer();
+  m_heartbeatTicker = ticker;
+  if (added) {
+    addHeartbeatTimer();
+  }
+}
+
 void ClientProxy1_0::disconnect()
 {
   removeHandlers();
@@ -83,7 +94,6 @@ void ClientProxy1_0::removeHandlers()
   m_events->removeHandler(m_events->forIStream().outputError(), getStream()->getEventTarget());
   m_events->removeHandler(m_events->forIStream().inputShutdown(), getStream()->getEventTarget());
   m_events->removeHandler(m_events->forIStream().outputShutdown(), getStream()->getEventTarget());
-  m_events->removeHandler(Event::kTimer, this);
 
   // remove timer
   removeHeartbeatTimer();
@@ -91,24 +101,41 @@ void ClientProxy1_0::removeHandlers()
 
 void ClientProxy1_0::addHeartbeatTimer()
 {
-  if (m_heartbeatAlarm > 0.0) {
-    m_heartbeatTimer = m_events->newOneShotTimer(m_heartbeatAlarm, this);
+  if (m_heartbeatAlarm > 0.0 && !m_heartbeatAdded) {
+    m_heartbeatAdded = true;
+    m_lastHeartbeat = ARCH->time();
+    if (m_heartbeatTicker != NULL) {
+      m_heartbeatTicker->add(this);
+    }
   }
 }
 
 void ClientProxy1_0::removeHeartbeatTimer()
 {
-  if (m_heartbeatTimer != NULL) {
-    m_events->deleteTimer(m_heartbeatTimer);
-    m_heartbeatTimer = NULL;
+  if (m_heartbeatAdded) {
+    m_heartbeatAdded = false;
+    if (m_heartbeatTicker != NULL) {
+      m_heartbeatTicker->remove(this);
+    }
   }
 }
 
 void ClientProxy1_0::resetHeartbeatTimer()
 {
-  // reset the alarm
-  removeHeartbeatTimer();
-  addHeartbeatTimer();
+  // reset the alarm.  the shared timer checks it, so this is cheap
+  // enough to do whenever data arrives.
+  m_lastHeartbeat = ARCH->time();
+}
+
+bool ClientProxy1_0::heartbeat(double now)
+{
+  if (m_heartbeatAdded && now - m_lastHeartbeat >= m_heartbeatAlarm) {
+    // didn't get a heartbeat fast enough.  assume client is dead.
+    LOG((CLOG_NOTE "client \"%s\" is dead", getName().c_str()));
+    disconnect();
+    return false;
+  }
+  return true;
 }
 
 void ClientProxy1_0::resetHeartbeatRate()
@@ -204,13 +231,6 @@ void ClientProxy1_0::handleWriteError(const Event &, void *)
   disconnect();
 }
 
-void ClientProxy1_0::handleFlatline(const Event &, void *)
-{
-  // didn't get a heartbeat fast enough.  assume client is dead.
-  LOG((CLOG_NOTE "client \"%s\" is dead", getName().c_str()));
-  disconnect();
-}
-
 bool ClientProxy1_0::getClipboard(ClipboardID id, IClipboard *clipboard) const
 {
   Clipboard::copy(clipboard, &m_clipboard[id].m_clipboard);
@@ -252,13 +272,39 @@ void ClientProxy1_0::setClipboard(ClipboardID id, const IClipboard *clipboard)
   // ignore -- deprecated in protocol 1.0
 }
 
+bool ClientProxy1_0::updateClipboard(ClipboardID id, const IClipboard *clipboard)
+{
+  ClientClipboard &sent = m_clipboard[id];
+
+  // the server's clipboards keep their generation while their content
+  // doesn't change, so there's no need to copy and compare them
+  const Clipboard *source = dynamic_cast<const Clipboard *>(clipboard);
+  if (source != NULL && source == sent.m_source && source->getGeneration() == sent.m_sourceGeneration &&
+      sent.m_sentGeneration != 0) {
+    return false;
+  }
+
+  Clipboard::copy(&sent.m_clipboard, clipboard);
+  sent.m_source = source;
+  sent.m_sourceGeneration = (source != NULL) ? source->getGeneration() : 0;
+
+  // the copy keeps its generation if the content is the same
+  const UInt32 generation = sent.m_clipboard.getGeneration();
+  if (generation == sent.m_sentGeneration) {
+    return false;
+  }
+  sent.m_sentGeneration = generation;
+  return true;
+}
+
 void ClientProxy1_0::grabClipboard(ClipboardID id)
 {
   LOG((CLOG_DEBUG "send grab clipboard %d to \"%s\"", id, getName().c_str()));
-  ProtocolUtil::writef(getStream(), kMsgCClipboard, id, 0);
+  writeShared(kMsgCClipboard, id, 0);
 
-  // this clipboard is now dirty
+  // this clipboard is now dirty, and the client no longer has its data
   m_clipboard[id].m_dirty = true;
+  m_clipboard[id].m_sentGeneration = 0;
 }
 
 void ClientProxy1_0::setClipboardDirty(ClipboardID id, bool dirty)
@@ -269,7 +315,7 @@ void ClientProxy1_0::setClipboardDirty(ClipboardID id, bool dirty)
 void ClientProxy1_0::keyDown(KeyID key, KeyModifierMask mask, KeyButton, const String &)
 {
   LOG((CLOG_DEBUG1 "send key down to \"%s\" id=%d, mask=0x%04x", getName().c_str(), key, mask));
-  ProtocolUtil::writef(getStream(), kMsgDKeyDown1_0, key, mask);
+  writeShared(kMsgDKeyDown1_0, key, mask);
 }
 
 void ClientProxy1_0::keyRepeat(KeyID key, KeyModifierMask mask, SInt32 count, KeyButton, const String &)
@@ -281,7 +327,7 @@ void ClientProxy1_0::keyRepeat(KeyID key, KeyModifierMask mask, SInt32 count, Ke
 void ClientProxy1_0::keyUp(KeyID key, KeyModifierMask mask, KeyButton)
 {
   LOG((CLOG_DEBUG1 "send key up to \"%s\" id=%d, mask=0x%04x", getName().c_str(), key, mask));
-  ProtocolUtil::writef(getStream(), kMsgDKeyUp1_0, key, mask);
+  writeShared(kMsgDKeyUp1_0, key, mask);
 }
 
 void ClientProxy1_0::mouseDown(ButtonID button)
@@ -298,6 +344,7 @@ void ClientProxy1_0::mouseUp(ButtonID button)
 
 void ClientProxy1_0::mouseMove(SInt32 xAbs, SInt32 yAbs)
 {
+  TRACE(TraceEvent::kClientProxyMouseMove, xAbs, yAbs);
   LOG((CLOG_DEBUG2 "send mouse move to \"%s\" %d,%d", getName().c_str(), xAbs, yAbs));
   ProtocolUtil::writef(getStream(), kMsgDMouseMove, xAbs, yAbs);
 }
@@ -342,13 +389,13 @@ void ClientProxy1_0::secureInputNotification(const String &app) const
 void ClientProxy1_0::screensaver(bool on)
 {
   LOG((CLOG_DEBUG1 "send screen saver to \"%s\" on=%d", getName().c_str(), on ? 1 : 0));
-  ProtocolUtil::writef(getStream(), kMsgCScreenSaver, on ? 1 : 0);
+  writeShared(kMsgCScreenSaver, on ? 1 : 0);
 }
 
 void ClientProxy1_0::resetOptions()
 {
   LOG((CLOG_DEBUG1 "send reset options to \"%s\"", getName().c_str()));
-  ProtocolUtil::writef(getStream(), kMsgCResetOptions);
+  writeShared(kMsgCResetOptions);
 
   // reset heart rate and death
   resetHeartbeatRate();
@@ -359,7 +406,7 @@ void ClientProxy1_0::resetOptions()
 void ClientProxy1_0::setOptions(const OptionsList &options)
 {
   LOG((CLOG_DEBUG1 "send set options to \"%s\" size=%d", getName().c_str(), options.size()));
-  ProtocolUtil::writef(getStream(), kMsgDSetOptions, &options);
+  writeShared(kMsgDSetOptions, &options);
 
   // check options
   for (UInt32 i = 0, n = (UInt32)options.size(); i < n; i += 2) {
@@ -402,9 +449,14 @@ bool ClientProxy1_0::recvInfo()
   m_info.m_my = my;
 
   // acknowledge receipt
+  sendInfoAck();
+  return true;
+}
+
+void ClientProxy1_0::sendInfoAck()
+{
   LOG((CLOG_DEBUG1 "send info ack to \"%s\"", getName().c_str()));
   ProtocolUtil::writef(getStream(), kMsgCInfoAck);
-  return true;
 }
 
 bool ClientProxy1_0::recvClipboard()
@@ -441,7 +493,13 @@ bool ClientProxy1_0::recvGrabClipboard()
 // ClientProxy1_0::ClientClipboard
 //
 
-ClientProxy1_0::ClientClipboard::ClientClipboard() : m_clipboard(), m_sequenceNumber(0), m_dirty(true)
+ClientProxy1_0::ClientClipboard::ClientClipboard()
+    : m_clipboard(),
+      m_sequenceNumber(0),
+      m_dirty(true),
+      m_sentGeneration(0),
+      m_source(NULL),
+      m_sourceGeneration(0)
 {
   // do nothing
 }
@@ -23,7 +23,7 @@
 #include "server/ClientProxy.h"
 
 class Event;
-class EventQueueTimer;
+class HeartbeatTicker;
 class IEventQueue;
 
 //! Proxy for client implementing protocol version 1.0
@@ -38,6 +38,18 @@ public:
   ClientProxy1_0 &operator=(ClientProxy1_0 const &) = delete;
   ClientProxy1_0 &operator=(ClientProxy1_0 &&) = delete;
 
+  //! @name manipulators
+  //@{
+
+  //! Set the heartbeat ticker
+  /*!
+  Uses \p ticker to check the client's heartbeat.  Without a ticker the
+  heartbeat isn't checked.
+  */
+  void setHeartbeatTicker(HeartbeatTicker *ticker);
+
+  //@}
+
   // IScreen
   bool getClipboard(ClipboardID id, IClipboard *) const override;
   void getShape(SInt32 &x, SInt32 &y, SInt32 &width, SInt32 &height) const override;
@@ -75,15 +87,34 @@ protected:
   virtual void addHeartbeatTimer();
   virtual void removeHeartbeatTimer();
   virtual bool recvClipboard();
+  virtual void sendInfoAck();
+
+  //! Check the heartbeat
+  /*!
+  Called by the heartbeat ticker while the heartbeat timer is added, at
+  least once per heartbeat.  \p now is from ARCH->time().  Returns false
+  if the client is dead and has been disconnected.
+  */
+  virtual bool heartbeat(double now);
+
+  //! Update the client's clipboard
+  /*!
+  Copies \p clipboard to the clipboard kept for the client, and returns
+  true if the client doesn't have its content yet.  Returns false
+  without copying if it's a \c Clipboard whose generation hasn't
+  changed since it was last sent.
+  */
+  bool updateClipboard(ClipboardID id, const IClipboard *clipboard);
 
 private:
+  friend class HeartbeatTicker;
+
   void disconnect();
   void removeHandlers();
 
   void handleData(const Event &, void *);
   void handleDisconnect(const Event &, void *);
   void handleWriteError(const Event &, void *);
-  void handleFlatline(const Event &, void *);
 
   bool recvInfo();
   bool recvGrabClipboard();
@@ -98,6 +129,14 @@ protected:
     Clipboard m_clipboard;
     UInt32 m_sequenceNumber;
     bool m_dirty;
+
+    // generation of m_clipboard the client is known to have, 0 if unknown
+    UInt32 m_sentGeneration;
+
+    // clipboard m_clipboard was last copied from and its generation then,
+    // NULL if m_clipboard has changed since
+    const Clipboard *m_source;
+    UInt32 m_sourceGeneration;
   };
 
   ClientClipboard m_clipboard[kClipboardEnd];
@@ -107,7 +146,9 @@ private:
 
   ClientInfo m_info;
   double m_heartbeatAlarm;
-  EventQueueTimer *m_heartbeatTimer;
+  double m_lastHeartbeat;
+  bool m_heartbeatAdded;
+  HeartbeatTicker *m_heartbeatTicker;
   MessageParser m_parser;
   IEventQueue *m_events;
 };
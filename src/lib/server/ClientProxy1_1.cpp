@@ -42,7 +42,7 @@ ClientProxy1_1::~ClientProxy1_1()
 void ClientProxy1_1::keyDown(KeyID key, KeyModifierMask mask, KeyButton button, const String &)
 {
   LOG((CLOG_DEBUG1 "send key down to \"%s\" id=%d, mask=0x%04x, button=0x%04x", getName().c_str(), key, mask, button));
-  ProtocolUtil::writef(getStream(), kMsgDKeyDown, key, mask, button);
+  writeShared(kMsgDKeyDown, key, mask, button);
 }
 
 void ClientProxy1_1::keyRepeat(KeyID key, KeyModifierMask mask, SInt32 count, KeyButton button, const String &lang)
@@ -58,5 +58,5 @@ void ClientProxy1_1::keyRepeat(KeyID key, KeyModifierMask mask, SInt32 count, Ke
 void ClientProxy1_1::keyUp(KeyID key, KeyModifierMask mask, KeyButton button)
 {
   LOG((CLOG_DEBUG1 "send key up to \"%s\" id=%d, mask=0x%04x, button=0x%04x", getName().c_str(), key, mask, button));
-  ProtocolUtil::writef(getStream(), kMsgDKeyUp, key, mask, button);
+  writeShared(kMsgDKeyUp, key, mask, button);
 }
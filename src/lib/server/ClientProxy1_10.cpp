@@ -0,0 +1,47 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "server/ClientProxy1_10.h"
+
+#include "base/IEventQueue.h"
+#include "base/TMethodEventJob.h"
+#include "deskflow/ClipboardChunk.h"
+#include "deskflow/FileChunk.h"
+
+//
+// ClientProxy1_10
+//
+
+ClientProxy1_10::ClientProxy1_10(const String &name, deskflow::IStream *stream, Server *server, IEventQueue *events)
+    : ClientProxy1_9(name, stream, server, events)
+{
+  // replaces the handler installed by ClientProxy1_6, which removes it
+  events->adoptHandler(
+      events->forClipboard().clipboardSending(), this,
+      new TMethodEventJob<ClientProxy1_10>(this, &ClientProxy1_10::handleClipboardSendingEvent)
+  );
+}
+
+void ClientProxy1_10::fileChunkSending(UInt8 mark, char *data, size_t dataSize)
+{
+  FileChunk::send(getStream(), mark, data, dataSize, &m_fileCompression);
+}
+
+void ClientProxy1_10::handleClipboardSendingEvent(const Event &event, void *)
+{
+  ClipboardChunk::send(getStream(), event.getDataObject(), true);
+}
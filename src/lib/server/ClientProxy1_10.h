@@ -0,0 +1,40 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "deskflow/FileChunk.h"
+#include "server/ClientProxy1_9.h"
+
+//! Proxy for client implementing protocol version 1.10
+/*!
+Compresses the clipboard and file chunks it sends to the client.
+*/
+class ClientProxy1_10 : public ClientProxy1_9
+{
+public:
+  ClientProxy1_10(const String &name, deskflow::IStream *adoptedStream, Server *server, IEventQueue *events);
+  ~ClientProxy1_10() override = default;
+
+  void fileChunkSending(UInt8 mark, char *data, size_t dataSize) override;
+
+private:
+  void handleClipboardSendingEvent(const Event &, void *);
+
+private:
+  FileChunk::Compression m_fileCompression;
+};
@@ -0,0 +1,60 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "server/ClientProxy1_11.h"
+
+#include "base/IEventQueue.h"
+#include "io/IStream.h"
+
+//
+// ClientProxy1_11
+//
+
+ClientProxy1_11::ClientProxy1_11(const String &name, deskflow::IStream *stream, Server *server, IEventQueue *events)
+    : ClientProxy1_10(name, stream, server, events),
+      m_handshaking(true),
+      m_infoAckPending(false)
+{
+  // the info may have arrived with the hello reply, in which case we
+  // won't get another event for it so we fake one.
+  if (stream->isReady()) {
+    events->addEvent(Event(events->forIStream().inputReady(), stream->getEventTarget()));
+  }
+}
+
+void ClientProxy1_11::resetOptions()
+{
+  // the options are the first thing the server sends once the client is
+  // accepted, so send the info ack with them in one flight.
+  m_handshaking = false;
+  if (m_infoAckPending) {
+    m_infoAckPending = false;
+    ClientProxy1_10::sendInfoAck();
+  }
+
+  ClientProxy1_10::resetOptions();
+}
+
+void ClientProxy1_11::sendInfoAck()
+{
+  if (m_handshaking) {
+    m_infoAckPending = true;
+    return;
+  }
+
+  ClientProxy1_10::sendInfoAck();
+}
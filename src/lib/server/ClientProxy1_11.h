@@ -0,0 +1,43 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "server/ClientProxy1_10.h"
+
+//! Proxy for client implementing protocol version 1.11
+/*!
+The client sends its screen info with the hello reply instead of waiting
+to be asked for it, and the acknowledgment is sent along with the
+options, so the handshake takes one round trip after the hello.
+*/
+class ClientProxy1_11 : public ClientProxy1_10
+{
+public:
+  ClientProxy1_11(const String &name, deskflow::IStream *adoptedStream, Server *server, IEventQueue *events);
+  ~ClientProxy1_11() override = default;
+
+  void resetOptions() override;
+
+protected:
+  void sendInfoAck() override;
+
+private:
+  // true until the server sends the first options
+  bool m_handshaking;
+  bool m_infoAckPending;
+};
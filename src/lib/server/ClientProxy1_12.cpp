@@ -0,0 +1,197 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "server/ClientProxy1_12.h"
+
+#include "base/Log.h"
+#include "base/Trace.h"
+#include "deskflow/ProtocolUtil.h"
+#include "server/Server.h"
+#include "server/ServerMotionChannel.h"
+
+//
+// ClientProxy1_12
+//
+
+ClientProxy1_12::ClientProxy1_12(const String &name, deskflow::IStream *stream, Server *server, IEventQueue *events)
+    : ClientProxy1_11(name, stream, server, events),
+      m_motionChannel(nullptr),
+      m_channel(0),
+      m_motionSeq(0),
+      m_xRelTotal(0),
+      m_yRelTotal(0),
+      m_fencePending(false),
+      m_fences(0),
+      m_messageSent(false)
+{
+  // do nothing
+}
+
+ClientProxy1_12::~ClientProxy1_12()
+{
+  if (m_motionChannel != nullptr) {
+    m_motionChannel->close(m_channel);
+  }
+}
+
+void ClientProxy1_12::enter(SInt32 xAbs, SInt32 yAbs, UInt32 seqNum, KeyModifierMask mask, bool forScreensaver)
+{
+  fenceMotion();
+  ClientProxy1_11::enter(xAbs, yAbs, seqNum, mask, forScreensaver);
+}
+
+bool ClientProxy1_12::leave()
+{
+  fenceMotion();
+  return ClientProxy1_11::leave();
+}
+
+void ClientProxy1_12::keyDown(KeyID key, KeyModifierMask mask, KeyButton button, const String &lang)
+{
+  fenceMotion();
+  ClientProxy1_11::keyDown(key, mask, button, lang);
+}
+
+void ClientProxy1_12::keyRepeat(KeyID key, KeyModifierMask mask, SInt32 count, KeyButton button, const String &lang)
+{
+  fenceMotion();
+  ClientProxy1_11::keyRepeat(key, mask, count, button, lang);
+}
+
+void ClientProxy1_12::keyUp(KeyID key, KeyModifierMask mask, KeyButton button)
+{
+  fenceMotion();
+  ClientProxy1_11::keyUp(key, mask, button);
+}
+
+void ClientProxy1_12::mouseDown(ButtonID button)
+{
+  fenceMotion();
+  ClientProxy1_11::mouseDown(button);
+}
+
+void ClientProxy1_12::mouseUp(ButtonID button)
+{
+  fenceMotion();
+  ClientProxy1_11::mouseUp(button);
+}
+
+void ClientProxy1_12::mouseMove(SInt32 xAbs, SInt32 yAbs)
+{
+  if (sendMotion(MotionDatagram::kAbsolute, xAbs, yAbs)) {
+    TRACE(TraceEvent::kClientProxyMouseMove, xAbs, yAbs);
+    return;
+  }
+
+  fenceMotion();
+  ClientProxy1_11::mouseMove(xAbs, yAbs);
+}
+
+void ClientProxy1_12::mouseRelativeMove(SInt32 xRel, SInt32 yRel)
+{
+  // the totals wrap, which the client undoes when it takes the difference
+  const auto xTotal = static_cast<SInt32>(static_cast<UInt32>(m_xRelTotal) + static_cast<UInt32>(xRel));
+  const auto yTotal = static_cast<SInt32>(static_cast<UInt32>(m_yRelTotal) + static_cast<UInt32>(yRel));
+  if (sendMotion(MotionDatagram::kRelative, xTotal, yTotal)) {
+    m_xRelTotal = xTotal;
+    m_yRelTotal = yTotal;
+    return;
+  }
+
+  fenceMotion();
+  ClientProxy1_11::mouseRelativeMove(xRel, yRel);
+}
+
+void ClientProxy1_12::mouseWheel(SInt32 xDelta, SInt32 yDelta)
+{
+  fenceMotion();
+  ClientProxy1_11::mouseWheel(xDelta, yDelta);
+}
+
+void ClientProxy1_12::setOptions(const OptionsList &options)
+{
+  ClientProxy1_11::setOptions(options);
+
+  // the options end the handshake, so the client is ready for the offer
+  if (m_motionChannel == nullptr) {
+    offerMotionChannel();
+  }
+}
+
+void ClientProxy1_12::offerMotionChannel()
+{
+  ServerMotionChannel *channel = getServer()->getMotionChannel();
+  if (channel == nullptr) {
+    return;
+  }
+
+  String key;
+  m_channel = channel->open(key, getLocalAddress());
+  if (m_channel == 0) {
+    return;
+  }
+
+  m_motionChannel = channel;
+  LOG((CLOG_DEBUG1 "send motion channel %d to \"%s\"", m_channel, getName().c_str()));
+  ProtocolUtil::writef(getStream(), kMsgDMotionChannel, m_channel, channel->getPort(), &key);
+}
+
+bool ClientProxy1_12::sendMotion(MotionDatagram::EKind kind, SInt32 x, SInt32 y)
+{
+  // stop using the channel rather than reuse a sequence number, and if
+  // the option was turned off
+  if (m_motionChannel == nullptr || m_motionSeq == UINT32_MAX || m_fences == UINT32_MAX ||
+      getServer()->getMotionChannel() == nullptr || !m_motionChannel->isRegistered(m_channel)) {
+    return false;
+  }
+
+  // the datagram could overtake messages sent since the last fence, so
+  // fence them and have the client wait for it
+  if (m_messageSent) {
+    sendFence();
+  }
+
+  MotionDatagram motion(m_channel, m_motionSeq + 1, kind, x, y, m_fences);
+  if (!m_motionChannel->send(motion)) {
+    return false;
+  }
+
+  LOG((CLOG_DEBUG2 "send motion %d to \"%s\" kind=%d %d,%d", motion.m_seq, getName().c_str(), kind, x, y));
+  m_motionSeq = motion.m_seq;
+  m_lastMotion = motion;
+  m_fencePending = true;
+  return true;
+}
+
+void ClientProxy1_12::fenceMotion()
+{
+  if (m_fencePending) {
+    sendFence();
+  }
+  m_messageSent = true;
+}
+
+void ClientProxy1_12::sendFence()
+{
+  m_fencePending = false;
+  m_messageSent = false;
+  ++m_fences;
+  LOG((CLOG_DEBUG2 "send motion fence %d to \"%s\"", m_lastMotion.m_seq, getName().c_str()));
+  ProtocolUtil::writef(
+      getStream(), kMsgDMotionFence, m_lastMotion.m_seq, m_lastMotion.m_kind, m_lastMotion.m_x, m_lastMotion.m_y
+  );
+}
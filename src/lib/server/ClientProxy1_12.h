@@ -0,0 +1,82 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "deskflow/MotionDatagram.h"
+#include "server/ClientProxy1_11.h"
+
+class ServerMotionChannel;
+
+//! Proxy for client implementing protocol version 1.12
+/*!
+Offers the client the UDP motion channel if the server has one, and
+sends mouse motion on it once the client has registered, so that a lost
+or late packet never holds up newer motion behind it.  Everything else
+is sent over TCP as before, preceded by a motion fence if motion was
+sent on the channel since the last one, and motion sent after any of it
+is preceded by another so that the client doesn't apply it too early.
+*/
+class ClientProxy1_12 : public ClientProxy1_11
+{
+public:
+  ClientProxy1_12(const String &name, deskflow::IStream *adoptedStream, Server *server, IEventQueue *events);
+  ClientProxy1_12(ClientProxy1_12 const &) = delete;
+  ClientProxy1_12(ClientProxy1_12 &&) = delete;
+  ~ClientProxy1_12() override;
+
+  ClientProxy1_12 &operator=(ClientProxy1_12 const &) = delete;
+  ClientProxy1_12 &operator=(ClientProxy1_12 &&) = delete;
+
+  // IClient overrides
+  void enter(SInt32 xAbs, SInt32 yAbs, UInt32 seqNum, KeyModifierMask mask, bool forScreensaver) override;
+  bool leave() override;
+  void keyDown(KeyID, KeyModifierMask, KeyButton, const String &) override;
+  void keyRepeat(KeyID, KeyModifierMask, SInt32 count, KeyButton, const String &) override;
+  void keyUp(KeyID, KeyModifierMask, KeyButton) override;
+  void mouseDown(ButtonID) override;
+  void mouseUp(ButtonID) override;
+  void mouseMove(SInt32 xAbs, SInt32 yAbs) override;
+  void mouseRelativeMove(SInt32 xRel, SInt32 yRel) override;
+  void mouseWheel(SInt32 xDelta, SInt32 yDelta) override;
+  void setOptions(const OptionsList &options) override;
+
+private:
+  // offer the motion channel if the server has one
+  void offerMotionChannel();
+
+  // send motion on the motion channel, returns false if it can't be used
+  bool sendMotion(MotionDatagram::EKind kind, SInt32 x, SInt32 y);
+
+  // send a fence if motion was sent on the channel since the last one,
+  // called before every message motion must not overtake
+  void fenceMotion();
+
+  // send a fence with the last motion sent on the channel
+  void sendFence();
+
+private:
+  ServerMotionChannel *m_motionChannel;
+  UInt32 m_channel;
+  UInt32 m_motionSeq;
+  SInt32 m_xRelTotal;
+  SInt32 m_yRelTotal;
+  MotionDatagram m_lastMotion;
+  bool m_fencePending;
+  UInt32 m_fences;
+  bool m_messageSent;
+};
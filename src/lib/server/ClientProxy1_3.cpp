@@ -18,9 +18,8 @@
 
 #include "server/ClientProxy1_3.h"
 
-#include "base/IEventQueue.h"
+#include "arch/Arch.h"
 #include "base/Log.h"
-#include "base/TMethodEventJob.h"
 #include "deskflow/ProtocolUtil.h"
 
 #include <cstring>
@@ -33,16 +32,13 @@
 ClientProxy1_3::ClientProxy1_3(const String &name, deskflow::IStream *stream, IEventQueue *events)
     : ClientProxy1_2(name, stream, events),
       m_keepAliveRate(kKeepAliveRate),
-      m_keepAliveTimer(NULL),
-      m_events(events)
+      m_lastKeepAlive(0.0)
 {
   setHeartbeatRate(kKeepAliveRate, kKeepAliveRate * kKeepAlivesUntilDeath);
 }
 
 ClientProxy1_3::~ClientProxy1_3()
 {
-  // cannot do this in superclass or our override wouldn't get called
-  removeHeartbeatTimer();
 }
 
 void ClientProxy1_3::mouseWheel(SInt32 xDelta, SInt32 yDelta)
@@ -74,47 +70,33 @@ void ClientProxy1_3::setHeartbeatRate(double rate, double)
   ClientProxy1_2::setHeartbeatRate(rate, rate * kKeepAlivesUntilDeath);
 }
 
-void ClientProxy1_3::resetHeartbeatTimer()
+bool ClientProxy1_3::heartbeat(double now)
 {
-  // reset the alarm but not the keep alive timer
-  ClientProxy1_2::removeHeartbeatTimer();
-  ClientProxy1_2::addHeartbeatTimer();
-}
-
-void ClientProxy1_3::addHeartbeatTimer()
-{
-  // create and install a timer to periodically send keep alives
-  if (m_keepAliveRate > 0.0) {
-    m_keepAliveTimer = m_events->newTimer(m_keepAliveRate, NULL);
-    m_events->adoptHandler(
-        Event::kTimer, m_keepAliveTimer,
-        new TMethodEventJob<ClientProxy1_3>(this, &ClientProxy1_3::handleKeepAlive, NULL)
-    );
+  // superclass does the alarm.  a dead client gets no keep alive.
+  if (!ClientProxy1_2::heartbeat(now)) {
+    return false;
   }
 
-  // superclass does the alarm
-  ClientProxy1_2::addHeartbeatTimer();
-}
-
-void ClientProxy1_3::removeHeartbeatTimer()
-{
-  // remove the timer that sends keep alives periodically
-  if (m_keepAliveTimer != NULL) {
-    m_events->removeHandler(Event::kTimer, m_keepAliveTimer);
-    m_events->deleteTimer(m_keepAliveTimer);
-    m_keepAliveTimer = NULL;
+  // send keep alives periodically.  a keep alive sent while streaming
+  // clipboard or file chunks counts, so skip this one if that was less
+  // than half a period ago.
+  if (m_keepAliveRate > 0.0 && now - m_lastKeepAlive >= 0.5 * m_keepAliveRate) {
+    keepAlive();
   }
-
-  // superclass does the alarm
-  ClientProxy1_2::removeHeartbeatTimer();
+  return true;
 }
 
 void ClientProxy1_3::handleKeepAlive(const Event &, void *)
 {
-  keepAlive();
+  // chunk streams ask for a keep alive before every chunk, but the client
+  // only needs one every so often to know we're alive
+  if (m_keepAliveRate <= 0.0 || ARCH->time() - m_lastKeepAlive >= 0.5 * m_keepAliveRate) {
+    keepAlive();
+  }
 }
 
 void ClientProxy1_3::keepAlive()
 {
-  ProtocolUtil::writef(getStream(), kMsgCKeepAlive);
+  m_lastKeepAlive = ARCH->time();
+  writeShared(kMsgCKeepAlive);
 }
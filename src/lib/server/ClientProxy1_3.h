@@ -42,13 +42,10 @@ protected:
   virtual bool parseMessage(const UInt8 *code);
   virtual void resetHeartbeatRate();
   virtual void setHeartbeatRate(double rate, double alarm);
-  virtual void resetHeartbeatTimer();
-  virtual void addHeartbeatTimer();
-  virtual void removeHeartbeatTimer();
+  virtual bool heartbeat(double now);
   virtual void keepAlive();
 
 private:
   double m_keepAliveRate;
-  EventQueueTimer *m_keepAliveTimer;
-  IEventQueue *m_events;
+  double m_lastKeepAlive;
 };
@@ -49,9 +49,16 @@ void ClientProxy1_6::setClipboard(ClipboardID id, const IClipboard *clipboard)
   if (m_clipboard[id].m_dirty) {
     // this clipboard is now clean
     m_clipboard[id].m_dirty = false;
-    Clipboard::copy(&m_clipboard[id].m_clipboard, clipboard);
 
-    String data = m_clipboard[id].m_clipboard.marshall();
+    // the client already has this data
+    if (!updateClipboard(id, clipboard)) {
+      LOG((CLOG_DEBUG "clipboard %d unchanged for \"%s\"", id, getName().c_str()));
+      return;
+    }
+
+    // the chunks are copies, so the marshalled data is freed once sent
+    String buffer;
+    const String &data = marshallShared(clipboard, buffer);
 
     size_t size = data.size();
     LOG((CLOG_DEBUG "sending clipboard %d to \"%s\"", id, getName().c_str()));
@@ -85,6 +92,8 @@ bool ClientProxy1_6::recvClipboard()
     // save clipboard
     m_clipboard[id].m_clipboard.unmarshall(dataCached, 0);
     m_clipboard[id].m_sequenceNumber = seq;
+    m_clipboard[id].m_sentGeneration = m_clipboard[id].m_clipboard.getGeneration();
+    m_clipboard[id].m_source = NULL;
 
     // notify
     ClipboardInfo *info = new ClipboardInfo;
@@ -46,5 +46,5 @@ void ClientProxy1_8::keyDown(KeyID key, KeyModifierMask mask, KeyButton button,
       (CLOG_DEBUG1 "send key down to \"%s\" id=%d, mask=0x%04x, button=0x%04x, language=%s", getName().c_str(), key,
        mask, button, language.c_str())
   );
-  ProtocolUtil::writef(getStream(), kMsgDKeyDownLang, key, mask, button, &language);
+  writeShared(kMsgDKeyDownLang, key, mask, button, &language);
 }
@@ -0,0 +1,118 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "server/ClientProxy1_9.h"
+
+#include "base/Log.h"
+#include "deskflow/ProtocolUtil.h"
+#include "deskflow/StreamChunker.h"
+#include "server/Server.h"
+
+#include <cstring>
+
+//
+// ClientProxy1_9
+//
+
+ClientProxy1_9::ClientProxy1_9(const String &name, deskflow::IStream *stream, Server *server, IEventQueue *events)
+    : ClientProxy1_8(name, stream, server, events),
+      m_events(events)
+{
+  for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+    m_advertisedSeqNum[id] = 0;
+
+    // formats the server hasn't read yet are read when the client asks
+    m_clipboard[id].m_clipboard.setDeferrableFormats(IClipboard::kAllFormats);
+  }
+}
+
+void ClientProxy1_9::setClipboard(ClipboardID id, const IClipboard *clipboard)
+{
+  // ignore if this clipboard is already clean
+  if (!m_clipboard[id].m_dirty) {
+    return;
+  }
+
+  // this clipboard is now clean
+  m_clipboard[id].m_dirty = false;
+
+  // the client already has this data
+  if (!updateClipboard(id, clipboard)) {
+    LOG((CLOG_DEBUG "clipboard %d unchanged for \"%s\"", id, getName().c_str()));
+    return;
+  }
+
+  // never 0, so the client can tell replies from pushed clipboards
+  if (++m_advertisedSeqNum[id] == 0) {
+    m_advertisedSeqNum[id] = 1;
+  }
+
+  std::vector<UInt32> formats;
+  for (const auto &info : m_clipboard[id].m_clipboard.getFormatInfo()) {
+    formats.push_back(info.m_format);
+    formats.push_back(info.m_size);
+    formats.push_back(static_cast<UInt32>(info.m_hash >> 32));
+    formats.push_back(static_cast<UInt32>(info.m_hash));
+  }
+
+  LOG(
+      (CLOG_DEBUG "sending clipboard %d formats to \"%s\" seqnum=%d", id, getName().c_str(), m_advertisedSeqNum[id])
+  );
+  ProtocolUtil::writef(getStream(), kMsgDClipboardFormats, id, m_advertisedSeqNum[id], &formats);
+}
+
+bool ClientProxy1_9::parseMessage(const UInt8 *code)
+{
+  if (memcmp(code, kMsgQClipboard, 4) == 0) {
+    recvClipboardQuery();
+  } else {
+    return ClientProxy1_8::parseMessage(code);
+  }
+
+  return true;
+}
+
+void ClientProxy1_9::recvClipboardQuery()
+{
+  ClipboardID id;
+  UInt32 seqNum;
+  UInt32 formats;
+  if (!ProtocolUtil::readf(getStream(), kMsgQClipboard + 4, &id, &seqNum, &formats) || id >= kClipboardEnd) {
+    LOG((CLOG_WARN "invalid clipboard query from \"%s\"", getName().c_str()));
+    return;
+  }
+
+  // the clipboard has changed since, the client will get the new formats
+  if (seqNum != m_advertisedSeqNum[id]) {
+    LOG((CLOG_DEBUG "ignored old clipboard %d query from \"%s\" seqnum=%d", id, getName().c_str(), seqNum));
+    return;
+  }
+
+  // read the requested formats the server hasn't yet.  if the clipboard
+  // is dirty the server has newer data and they're left out.
+  Clipboard &clipboard = m_clipboard[id].m_clipboard;
+  const UInt32 deferred = formats & clipboard.getDeferredFormats();
+  if (deferred != 0 && !m_clipboard[id].m_dirty) {
+    clipboard.resolve(getServer()->fetchClipboard(id, deferred), deferred);
+  }
+
+  String data = clipboard.marshall(formats);
+  LOG(
+      (CLOG_DEBUG "sending clipboard %d to \"%s\" formats=0x%x size=%d", id, getName().c_str(), formats, data.size())
+  );
+  StreamChunker::sendClipboard(data, data.size(), id, seqNum, m_events, this);
+}
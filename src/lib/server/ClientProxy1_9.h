@@ -0,0 +1,50 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "server/ClientProxy1_8.h"
+
+//! Proxy for client implementing protocol version 1.9
+/*!
+Instead of pushing the whole clipboard to the client, advertises the
+formats it has and sends only the formats the client asks for.
+*/
+class ClientProxy1_9 : public ClientProxy1_8
+{
+public:
+  ClientProxy1_9(const String &name, deskflow::IStream *adoptedStream, Server *server, IEventQueue *events);
+  ~ClientProxy1_9() override = default;
+
+  void setClipboard(ClipboardID id, const IClipboard *clipboard) override;
+  bool requestsClipboardData() const override
+  {
+    return true;
+  }
+
+protected:
+  bool parseMessage(const UInt8 *code) override;
+
+private:
+  void recvClipboardQuery();
+
+private:
+  IEventQueue *m_events;
+
+  // sequence number of the last formats advertised for each clipboard
+  UInt32 m_advertisedSeqNum[kClipboardEnd];
+};
@@ -29,6 +29,9 @@
 #include "io/XIO.h"
 #include "server/ClientProxy1_0.h"
 #include "server/ClientProxy1_1.h"
+#include "server/ClientProxy1_10.h"
+#include "server/ClientProxy1_11.h"
+#include "server/ClientProxy1_12.h"
 #include "server/ClientProxy1_2.h"
 #include "server/ClientProxy1_3.h"
 #include "server/ClientProxy1_4.h"
@@ -36,6 +39,7 @@
 #include "server/ClientProxy1_6.h"
 #include "server/ClientProxy1_7.h"
 #include "server/ClientProxy1_8.h"
+#include "server/ClientProxy1_9.h"
 #include "server/Server.h"
 
 #include <iterator>
@@ -162,50 +166,73 @@ void ClientProxyUnknown::removeTimer()
 
 void ClientProxyUnknown::initProxy(const String &name, int major, int minor)
 {
+  ClientProxy1_0 *proxy = NULL;
   if (major == 1) {
     switch (minor) {
     case 0:
-      m_proxy = new ClientProxy1_0(name, m_stream, m_events);
+      proxy = new ClientProxy1_0(name, m_stream, m_events);
       break;
 
     case 1:
-      m_proxy = new ClientProxy1_1(name, m_stream, m_events);
+      proxy = new ClientProxy1_1(name, m_stream, m_events);
       break;
 
     case 2:
-      m_proxy = new ClientProxy1_2(name, m_stream, m_events);
+      proxy = new ClientProxy1_2(name, m_stream, m_events);
       break;
 
     case 3:
-      m_proxy = new ClientProxy1_3(name, m_stream, m_events);
+      proxy = new ClientProxy1_3(name, m_stream, m_events);
       break;
 
     case 4:
-      m_proxy = new ClientProxy1_4(name, m_stream, m_server, m_events);
+      proxy = new ClientProxy1_4(name, m_stream, m_server, m_events);
       break;
 
     case 5:
-      m_proxy = new ClientProxy1_5(name, m_stream, m_server, m_events);
+      proxy = new ClientProxy1_5(name, m_stream, m_server, m_events);
       break;
 
     case 6:
-      m_proxy = new ClientProxy1_6(name, m_stream, m_server, m_events);
+      proxy = new ClientProxy1_6(name, m_stream, m_server, m_events);
       break;
 
     case 7:
-      m_proxy = new ClientProxy1_7(name, m_stream, m_server, m_events);
+      proxy = new ClientProxy1_7(name, m_stream, m_server, m_events);
       break;
 
     case 8:
-      m_proxy = new ClientProxy1_8(name, m_stream, m_server, m_events);
+      proxy = new ClientProxy1_8(name, m_stream, m_server, m_events);
+      break;
+
+    case 9:
+      proxy = new ClientProxy1_9(name, m_stream, m_server, m_events);
+      break;
+
+    case 10:
+      proxy = new ClientProxy1_10(name, m_stream, m_server, m_events);
+      break;
+
+    case 11:
+      proxy = new ClientProxy1_11(name, m_stream, m_server, m_events);
+      break;
+
+    case 12:
+      proxy = new ClientProxy1_12(name, m_stream, m_server, m_events);
       break;
     }
   }
 
   // hangup (with error) if version isn't supported
-  if (m_proxy == NULL) {
+  if (proxy == NULL) {
     throw XIncompatibleClient(major, minor);
   }
+
+  // the server checks the heartbeats of all its clients on one timer
+  if (m_server != NULL) {
+    proxy->setHeartbeatTicker(m_server->getHeartbeatTicker());
+  }
+  m_proxy = proxy;
 }
 
 void ClientProxyUnknown::handleData(const Event &, void *)
@@ -243,6 +270,13 @@ void ClientProxyUnknown::handleData(const Event &, void *)
 
     // the proxy is created and now proxy now owns the stream
     LOG((CLOG_DEBUG1 "created proxy for client \"%s\" version %d.%d", name.c_str(), major, minor));
+
+    // from 1.11 the client sends its info with the hello reply,
+    // older clients wait to be asked for it.
+    if (major == 1 && minor < 11) {
+      LOG((CLOG_DEBUG1 "querying client \"%s\" info", name.c_str()));
+      ProtocolUtil::writef(m_stream, kMsgQInfo);
+    }
     m_stream = NULL;
 
     // wait until the proxy signals that it's ready or has disconnected
@@ -36,16 +36,50 @@ namespace deskflow::server {
 // Config
 //
 
-Config::Config(IEventQueue *events) : m_inputFilter(events), m_hasLockToScreenAction(false), m_events(events)
+Config::Config(IEventQueue *events)
+    : m_inputFilter(events),
+      m_hasLockToScreenAction(false),
+      m_events(events),
+      m_indexed(false)
 {
   // do nothing
 }
 
+Config::Config(const Config &config)
+    : m_map(config.m_map),
+      m_nameToCanonicalName(config.m_nameToCanonicalName),
+      m_deskflowAddress(config.m_deskflowAddress),
+      m_globalOptions(config.m_globalOptions),
+      m_inputFilter(config.m_inputFilter),
+      m_hasLockToScreenAction(config.m_hasLockToScreenAction),
+      m_events(config.m_events),
+      m_ClientAddress(config.m_ClientAddress),
+      m_indexed(false)
+{
+  // don't copy the index, it points into the other config
+}
+
 Config::~Config()
 {
   // do nothing
 }
 
+Config &Config::operator=(const Config &config)
+{
+  if (this != &config) {
+    m_map = config.m_map;
+    m_nameToCanonicalName = config.m_nameToCanonicalName;
+    m_deskflowAddress = config.m_deskflowAddress;
+    m_globalOptions = config.m_globalOptions;
+    m_inputFilter = config.m_inputFilter;
+    m_hasLockToScreenAction = config.m_hasLockToScreenAction;
+    m_events = config.m_events;
+    m_ClientAddress = config.m_ClientAddress;
+    invalidateIndex();
+  }
+  return *this;
+}
+
 bool Config::addScreen(const String &name)
 {
   // alias name must not exist
@@ -58,6 +92,8 @@ bool Config::addScreen(const String &name)
 
   // add name
   m_nameToCanonicalName.insert(std::make_pair(name, name));
+  ScreenNames::intern(name);
+  invalidateIndex();
 
   return true;
 }
@@ -85,6 +121,8 @@ bool Config::renameScreen(const String &oldName, const String &newName)
   // update name
   m_nameToCanonicalName.erase(oldCanonical);
   m_nameToCanonicalName.insert(std::make_pair(newName, newName));
+  ScreenNames::intern(newName);
+  invalidateIndex();
 
   // update connections
   Name oldNameObj(this, oldName);
@@ -115,6 +153,7 @@ void Config::removeScreen(const String &name)
 
   // remove from map
   m_map.erase(index);
+  invalidateIndex();
 
   // disconnect
   Name nameObj(this, name);
@@ -136,6 +175,7 @@ void Config::removeAllScreens()
 {
   m_map.clear();
   m_nameToCanonicalName.clear();
+  invalidateIndex();
 }
 
 bool Config::addAlias(const String &canonical, const String &alias)
@@ -152,6 +192,8 @@ bool Config::addAlias(const String &canonical, const String &alias)
 
   // insert alias
   m_nameToCanonicalName.insert(std::make_pair(alias, canonical));
+  ScreenNames::intern(alias);
+  invalidateIndex();
 
   return true;
 }
@@ -171,6 +213,7 @@ bool Config::removeAlias(const String &alias)
 
   // remove alias
   m_nameToCanonicalName.erase(index);
+  invalidateIndex();
 
   return true;
 }
@@ -190,6 +233,7 @@ bool Config::removeAliases(const String &canonical)
       ++index;
     }
   }
+  invalidateIndex();
 
   return true;
 }
@@ -203,6 +247,7 @@ void Config::removeAllAliases()
   for (CellMap::iterator index = m_map.begin(); index != m_map.end(); ++index) {
     m_nameToCanonicalName.insert(std::make_pair(index->first, index->first));
   }
+  invalidateIndex();
 }
 
 bool Config::connect(
@@ -420,6 +465,24 @@ String Config::getCanonicalName(const String &name) const
   }
 }
 
+ScreenID Config::getScreenId(const String &name) const
+{
+  NameMap::const_iterator index = m_nameToCanonicalName.find(name);
+  if (index == m_nameToCanonicalName.end()) {
+    return ScreenNames::kNoScreen;
+  }
+  return ScreenNames::find(index->second);
+}
+
+const String &Config::getScreenName(ScreenID id) const
+{
+  const IndexEntry *entry = findScreen(id);
+  if (entry == NULL) {
+    return ScreenNames::get(ScreenNames::kNoScreen);
+  }
+  return *entry->m_canonicalName;
+}
+
 String Config::getNeighbor(const String &srcName, EDirection srcSide, float position, float *positionOut) const
 {
   assert(srcSide >= kFirstDirection && srcSide <= kLastDirection);
@@ -446,11 +509,51 @@ String Config::getNeighbor(const String &srcName, EDirection srcSide, float posi
   }
 }
 
+ScreenID Config::getNeighbor(ScreenID srcId, EDirection srcSide, float position, float *positionOut) const
+{
+  assert(srcSide >= kFirstDirection && srcSide <= kLastDirection);
+
+  // find source cell
+  const IndexEntry *src = findScreen(srcId);
+  if (src == NULL) {
+    return ScreenNames::kNoScreen;
+  }
+
+  // find edge
+  const CellEdge *srcEdge, *dstEdge;
+  if (!src->m_cell->getLink(srcSide, position, srcEdge, dstEdge)) {
+    return ScreenNames::kNoScreen;
+  }
+
+  // the link may use an alias
+  const IndexEntry *dst = findScreen(dstEdge->getId());
+  if (dst == NULL) {
+    return ScreenNames::kNoScreen;
+  }
+
+  // compute position on neighbor
+  if (positionOut != NULL) {
+    *positionOut = dstEdge->inverseTransform(srcEdge->transform(position));
+  }
+  return dst->m_canonicalId;
+}
+
 bool Config::hasNeighbor(const String &srcName, EDirection srcSide) const
 {
   return hasNeighbor(srcName, srcSide, 0.0f, 1.0f);
 }
 
+bool Config::hasNeighbor(ScreenID srcId, EDirection srcSide) const
+{
+  assert(srcSide >= kFirstDirection && srcSide <= kLastDirection);
+
+  const IndexEntry *src = findScreen(srcId);
+  if (src == NULL) {
+    return false;
+  }
+  return src->m_cell->overlaps(CellEdge(srcSide, Interval(0.0f, 1.0f)));
+}
+
 bool Config::hasNeighbor(const String &srcName, EDirection srcSide, float start, float end) const
 {
   assert(srcSide >= kFirstDirection && srcSide <= kLastDirection);
@@ -500,6 +603,19 @@ const Config::ScreenOptions *Config::getOptions(const String &name) const
   return options;
 }
 
+const Config::ScreenOptions *Config::getOptions(ScreenID id) const
+{
+  if (id == ScreenNames::kNoScreen) {
+    return &m_globalOptions;
+  }
+
+  const IndexEntry *entry = findScreen(id);
+  if (entry == NULL) {
+    return NULL;
+  }
+  return &entry->m_cell->m_options;
+}
+
 bool Config::hasLockToScreenAction() const
 {
   return m_hasLockToScreenAction;
@@ -601,6 +717,36 @@ bool Config::isClientMode() const
   return (!m_ClientAddress.empty());
 }
 
+const Config::IndexEntry *Config::findScreen(ScreenID id) const
+{
+  if (!m_indexed) {
+    // index every name, including aliases, by its interned id
+    m_index.clear();
+    for (NameMap::const_iterator name = m_nameToCanonicalName.begin(); name != m_nameToCanonicalName.end(); ++name) {
+      CellMap::const_iterator cell = m_map.find(name->second);
+      if (cell == m_map.end()) {
+        continue;
+      }
+      ScreenID nameId = ScreenNames::find(name->first);
+      if (nameId >= m_index.size()) {
+        m_index.resize(nameId + 1, IndexEntry{ScreenNames::kNoScreen, NULL, NULL});
+      }
+      m_index[nameId] = IndexEntry{ScreenNames::find(cell->first), &cell->first, &cell->second};
+    }
+    m_indexed = true;
+  }
+
+  if (id == ScreenNames::kNoScreen || id >= m_index.size() || m_index[id].m_cell == NULL) {
+    return NULL;
+  }
+  return &m_index[id];
+}
+
+void Config::invalidateIndex()
+{
+  m_indexed = false;
+}
+
 void Config::readSection(ConfigReadContext &s)
 {
   static const char s_section[] = "section:";
@@ -697,8 +843,12 @@ void Config::readSectionOptions(ConfigReadContext &s)
       addOption("", kOptionDisableLockToScreen, s.parseBoolean(value));
     } else if (name == "clipboardSharing") {
       addOption("", kOptionClipboardSharing, s.parseBoolean(value));
+    } else if (name == "udpMotion") {
+      addOption("", kOptionMotionChannel, s.parseBoolean(value));
     } else if (name == "clipboardSharingSize") {
       addOption("", kOptionClipboardSharingSize, s.parseInt(value));
+    } else if (name == "maxHandshakes") {
+      addOption("", kOptionMaxHandshakes, s.parseInt(value));
     } else if (name == "clientAddress") {
       m_ClientAddress = value;
     } else {
@@ -1268,6 +1418,12 @@ const char *Config::getOptionName(OptionID id)
   if (id == kOptionClipboardSharingSize) {
     return "clipboardSharingSize";
   }
+  if (id == kOptionMotionChannel) {
+    return "udpMotion";
+  }
+  if (id == kOptionMaxHandshakes) {
+    return "maxHandshakes";
+  }
   return NULL;
 }
 
@@ -1277,7 +1433,7 @@ String Config::getOptionValue(OptionID id, OptionValue value)
       id == kOptionScreenSwitchNeedsShift || id == kOptionScreenSwitchNeedsControl ||
       id == kOptionScreenSwitchNeedsAlt || id == kOptionXTestXineramaUnaware || id == kOptionRelativeMouseMoves ||
       id == kOptionWin32KeepForeground || id == kOptionScreenPreserveFocus || id == kOptionClipboardSharing ||
-      id == kOptionClipboardSharingSize) {
+      id == kOptionClipboardSharingSize || id == kOptionMotionChannel) {
     return (value != 0) ? "true" : "false";
   }
   if (id == kOptionModifierMapForShift || id == kOptionModifierMapForControl || id == kOptionModifierMapForAlt ||
@@ -1306,7 +1462,7 @@ String Config::getOptionValue(OptionID id, OptionValue value)
     }
   }
   if (id == kOptionHeartbeat || id == kOptionScreenSwitchCornerSize || id == kOptionScreenSwitchDelay ||
-      id == kOptionScreenSwitchTwoTap) {
+      id == kOptionScreenSwitchTwoTap || id == kOptionMaxHandshakes) {
     return deskflow::string::sprintf("%d", value);
   }
   if (id == kOptionScreenSwitchCorners) {
@@ -1381,6 +1537,7 @@ void Config::CellEdge::init(const String &name, EDirection side, const Interval
   assert(side != kNoDirection);
 
   m_name = name;
+  m_id = ScreenNames::intern(name);
   m_side = side;
   m_interval = interval;
 }
@@ -1393,6 +1550,7 @@ Config::Interval Config::CellEdge::getInterval() const
 void Config::CellEdge::setName(const String &newName)
 {
   m_name = newName;
+  m_id = ScreenNames::intern(newName);
 }
 
 String Config::CellEdge::getName() const
@@ -1400,6 +1558,11 @@ String Config::CellEdge::getName() const
   return m_name;
 }
 
+ScreenID Config::CellEdge::getId() const
+{
+  return m_id;
+}
+
 EDirection Config::CellEdge::getSide() const
 {
   return m_side;
@@ -27,6 +27,7 @@
 #include "deskflow/protocol_types.h"
 #include "net/NetworkAddress.h"
 #include "server/InputFilter.h"
+#include "server/ScreenNames.h"
 
 #include <iosfwd>
 
@@ -94,11 +95,15 @@ public:
     bool operator==(const CellEdge &) const;
     bool operator!=(const CellEdge &) const;
 
+    // returns the id of the name, which may be an alias
+    ScreenID getId() const;
+
   private:
     void init(const String &name, EDirection side, const Interval &);
 
   private:
     String m_name;
+    ScreenID m_id;
     EDirection m_side;
     Interval m_interval;
   };
@@ -150,6 +155,14 @@ private:
   typedef std::map<String, Cell, deskflow::string::CaselessCmp> CellMap;
   typedef std::map<String, String, deskflow::string::CaselessCmp> NameMap;
 
+  // a screen name, which may be an alias, by id
+  struct IndexEntry
+  {
+    ScreenID m_canonicalId;
+    const String *m_canonicalName;
+    const Cell *m_cell;
+  };
+
 public:
   typedef Cell::const_iterator link_const_iterator;
   typedef CellMap::const_iterator internal_const_iterator;
@@ -211,14 +224,17 @@ public:
   };
 
   Config(IEventQueue *events);
+  Config(const Config &);
   virtual ~Config();
 
 #ifdef TEST_ENV
-  Config() : m_inputFilter(NULL)
+  Config() : m_inputFilter(NULL), m_indexed(false)
   {
   }
 #endif
 
+  Config &operator=(const Config &);
+
   //! @name manipulators
   //@{
 
@@ -391,6 +407,21 @@ public:
   */
   String getCanonicalName(const String &name) const;
 
+  //! Get screen id
+  /*!
+  Returns the id of the screen named \c name, which may be an alias,
+  or ScreenNames::kNoScreen if the name is unknown.  Screens should be
+  passed around by id rather than by name.
+  */
+  ScreenID getScreenId(const String &name) const;
+
+  //! Get screen name
+  /*!
+  Returns the canonical name of the screen with id \c id, or the empty
+  string if the id isn't a screen in this configuration.
+  */
+  const String &getScreenName(ScreenID id) const;
+
   //! Get neighbor
   /*!
   Returns the canonical screen name of the neighbor in the given
@@ -401,6 +432,13 @@ public:
   */
   String getNeighbor(const String &, EDirection, float position, float *positionOut) const;
 
+  //! Get neighbor
+  /*!
+  Same as getNeighbor() but for screen ids, returning
+  ScreenNames::kNoScreen if there is no neighbor.
+  */
+  ScreenID getNeighbor(ScreenID, EDirection, float position, float *positionOut) const;
+
   //! Check for neighbor
   /*!
   Returns \c true if the screen has a neighbor anywhere along the edge
@@ -408,6 +446,12 @@ public:
   */
   bool hasNeighbor(const String &, EDirection) const;
 
+  //! Check for neighbor
+  /*!
+  Same as hasNeighbor() but for a screen id.
+  */
+  bool hasNeighbor(ScreenID, EDirection) const;
+
   //! Check for neighbor
   /*!
   Returns \c true if the screen has a neighbor in the given range along
@@ -431,6 +475,13 @@ public:
   */
   const ScreenOptions *getOptions(const String &name) const;
 
+  //! Get the screen options
+  /*!
+  Same as getOptions() but for a screen id.  Returns the global options
+  for ScreenNames::kNoScreen.
+  */
+  const ScreenOptions *getOptions(ScreenID id) const;
+
   //! Check for lock to screen action
   /*!
   Returns \c true if this configuration has a lock to screen action.
@@ -504,6 +555,10 @@ private:
   static const char *getOptionName(OptionID);
   static String getOptionValue(OptionID, OptionValue);
 
+  // returns the entry for a screen id, or NULL if it's not a screen
+  const IndexEntry *findScreen(ScreenID) const;
+  void invalidateIndex();
+
 private:
   CellMap m_map;
   NameMap m_nameToCanonicalName;
@@ -513,6 +568,10 @@ private:
   bool m_hasLockToScreenAction;
   IEventQueue *m_events;
   String m_ClientAddress;
+
+  // screens by id, built on first use after the screens change
+  mutable bool m_indexed;
+  mutable std::vector<IndexEntry> m_index;
 };
 
 //! Configuration read context
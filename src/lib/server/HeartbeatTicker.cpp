@@ -0,0 +1,106 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "server/HeartbeatTicker.h"
+
+#include "arch/Arch.h"
+#include "base/IEventQueue.h"
+#include "base/TMethodEventJob.h"
+#include "server/ClientProxy1_0.h"
+
+#include <algorithm>
+
+//
+// HeartbeatTicker
+//
+
+HeartbeatTicker::HeartbeatTicker(IEventQueue *events) : m_events(events), m_timer(NULL), m_interval(0.0)
+{
+  // do nothing
+}
+
+HeartbeatTicker::~HeartbeatTicker()
+{
+  // proxies that outlive us stop checking their heartbeat
+  for (ClientProxy1_0 *proxy : m_proxies) {
+    proxy->m_heartbeatTicker = NULL;
+  }
+  m_proxies.clear();
+  update();
+}
+
+void HeartbeatTicker::add(ClientProxy1_0 *proxy)
+{
+  m_proxies.push_back(proxy);
+  update();
+}
+
+void HeartbeatTicker::remove(ClientProxy1_0 *proxy)
+{
+  auto index = std::find(m_proxies.begin(), m_proxies.end(), proxy);
+  if (index != m_proxies.end()) {
+    m_proxies.erase(index);
+    update();
+  }
+}
+
+void HeartbeatTicker::update()
+{
+  double interval = -1.0;
+  for (const ClientProxy1_0 *proxy : m_proxies) {
+    const double beat = proxy->m_heartbeatAlarm / kHeartBeatsUntilDeath;
+    if (interval < 0.0 || beat < interval) {
+      interval = beat;
+    }
+  }
+
+  // only replace the timer if the fastest heartbeat changed
+  if (m_timer != NULL && interval == m_interval) {
+    return;
+  }
+  if (m_timer != NULL) {
+    m_events->removeHandler(Event::kTimer, m_timer);
+    m_events->deleteTimer(m_timer);
+    m_timer = NULL;
+  }
+
+  m_interval = interval;
+  if (m_proxies.empty()) {
+    return;
+  }
+  m_timer = m_events->newTimer(m_interval, NULL);
+  m_events->adoptHandler(
+      Event::kTimer, m_timer, new TMethodEventJob<HeartbeatTicker>(this, &HeartbeatTicker::handleTimer)
+  );
+}
+
+void HeartbeatTicker::handleTimer(const Event &, void *)
+{
+  const double now = ARCH->time();
+
+  // proxies found dead remove themselves, so iterate over a copy and
+  // skip any that were removed earlier in this tick.  every proxy sends
+  // the same keep alive, so format it once.
+  const std::vector<ClientProxy1_0 *> proxies = m_proxies;
+  ClientProxy::Broadcast broadcast;
+  for (ClientProxy1_0 *proxy : proxies) {
+    if (std::find(m_proxies.begin(), m_proxies.end(), proxy) != m_proxies.end()) {
+      proxy->heartbeat(now);
+    }
+  }
+}
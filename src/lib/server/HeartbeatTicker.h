@@ -0,0 +1,72 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <vector>
+
+class ClientProxy1_0;
+class Event;
+class EventQueueTimer;
+class IEventQueue;
+
+//! Heartbeat timer shared by client proxies
+/*!
+One timer checks the heartbeats of all the proxies added to it, so
+receiving data only has to note the time instead of replacing a timer.
+It ticks once per heartbeat of the fastest proxy.  The server owns one
+for the proxies of its clients.
+*/
+class HeartbeatTicker
+{
+public:
+  HeartbeatTicker(IEventQueue *events);
+  HeartbeatTicker(HeartbeatTicker const &) = delete;
+  HeartbeatTicker(HeartbeatTicker &&) = delete;
+  ~HeartbeatTicker();
+
+  HeartbeatTicker &operator=(HeartbeatTicker const &) = delete;
+  HeartbeatTicker &operator=(HeartbeatTicker &&) = delete;
+
+  //! @name manipulators
+  //@{
+
+  //! Add a proxy
+  /*!
+  Checks the heartbeat of \p proxy on every tick until it's removed.
+  */
+  void add(ClientProxy1_0 *proxy);
+
+  //! Remove a proxy
+  /*!
+  Stops checking the heartbeat of \p proxy.  A proxy that's removed
+  during a tick isn't checked in that tick.
+  */
+  void remove(ClientProxy1_0 *proxy);
+
+  //@}
+
+private:
+  void update();
+  void handleTimer(const Event &, void *);
+
+  IEventQueue *m_events;
+  std::vector<ClientProxy1_0 *> m_proxies;
+  EventQueueTimer *m_timer;
+  double m_interval;
+};
@@ -27,6 +27,15 @@
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <map>
+
+namespace {
+
+// modifiers that cannot be combined with a mouse button
+const KeyModifierMask kButtonIgnoreMask =
+    KeyModifierAltGr | KeyModifierCapsLock | KeyModifierNumLock | KeyModifierScrollLock;
+
+} // namespace
 
 // -----------------------------------------------------------------------------
 // Input Filter Condition Classes
@@ -84,6 +93,11 @@ KeyModifierMask InputFilter::KeystrokeCondition::getMask() const
   return m_mask;
 }
 
+UInt32 InputFilter::KeystrokeCondition::getId() const
+{
+  return m_id;
+}
+
 InputFilter::Condition *InputFilter::KeystrokeCondition::clone() const
 {
   return new KeystrokeCondition(m_events, m_key, m_mask);
@@ -175,9 +189,6 @@ String InputFilter::MouseButtonCondition::format() const
 
 InputFilter::EFilterStatus InputFilter::MouseButtonCondition::match(const Event &event)
 {
-  static const KeyModifierMask s_ignoreMask =
-      KeyModifierAltGr | KeyModifierCapsLock | KeyModifierNumLock | KeyModifierScrollLock;
-
   EFilterStatus status;
 
   // check for hotkey events
@@ -193,7 +204,7 @@ InputFilter::EFilterStatus InputFilter::MouseButtonCondition::match(const Event
   // check if it's the right button and modifiers.  ignore modifiers
   // that cannot be combined with a mouse button.
   IPlatformScreen::ButtonInfo *minfo = static_cast<IPlatformScreen::ButtonInfo *>(event.getData());
-  if (minfo->m_button != m_button || (minfo->m_mask & ~s_ignoreMask) != m_mask) {
+  if (minfo->m_button != m_button || (minfo->m_mask & ~kButtonIgnoreMask) != m_mask) {
     return kNoMatch;
   }
 
@@ -202,6 +213,7 @@ InputFilter::EFilterStatus InputFilter::MouseButtonCondition::match(const Event
 
 InputFilter::ScreenConnectedCondition::ScreenConnectedCondition(IEventQueue *events, const String &screen)
     : m_screen(screen),
+      m_id(ScreenNames::intern(screen)),
       m_events(events)
 {
   // do nothing
@@ -226,7 +238,7 @@ InputFilter::EFilterStatus InputFilter::ScreenConnectedCondition::match(const Ev
 {
   if (event.getType() == m_events->forServer().connected()) {
     Server::ScreenConnectedInfo *info = static_cast<Server::ScreenConnectedInfo *>(event.getData());
-    if (m_screen == info->m_screen || m_screen.empty()) {
+    if (m_id == info->m_id || m_id == ScreenNames::kNoScreen) {
       return kActivate;
     }
   }
@@ -596,6 +608,16 @@ InputFilter::Rule::Rule(const Rule &rule) : m_condition(NULL)
   copy(rule);
 }
 
+InputFilter::Rule::Rule(Rule &&rule) noexcept
+    : m_condition(rule.m_condition),
+      m_activateActions(std::move(rule.m_activateActions)),
+      m_deactivateActions(std::move(rule.m_deactivateActions))
+{
+  rule.m_condition = NULL;
+  rule.m_activateActions.clear();
+  rule.m_deactivateActions.clear();
+}
+
 InputFilter::Rule::~Rule()
 {
   clear();
@@ -609,6 +631,21 @@ InputFilter::Rule &InputFilter::Rule::operator=(const Rule &rule)
   return *this;
 }
 
+InputFilter::Rule &InputFilter::Rule::operator=(Rule &&rule) noexcept
+{
+  if (&rule != this) {
+    // moving keeps the condition, so an enabled rule stays enabled
+    clear();
+    m_condition = rule.m_condition;
+    m_activateActions = std::move(rule.m_activateActions);
+    m_deactivateActions = std::move(rule.m_deactivateActions);
+    rule.m_condition = NULL;
+    rule.m_activateActions.clear();
+    rule.m_deactivateActions.clear();
+  }
+  return *this;
+}
+
 void InputFilter::Rule::clear()
 {
   delete m_condition;
@@ -787,12 +824,16 @@ const InputFilter::Action &InputFilter::Rule::getAction(bool onActivation, UInt3
 // -----------------------------------------------------------------------------
 // Input Filter Class
 // -----------------------------------------------------------------------------
-InputFilter::InputFilter(IEventQueue *events) : m_primaryClient(NULL), m_events(events)
+InputFilter::InputFilter(IEventQueue *events) : m_primaryClient(NULL), m_events(events), m_indexed(false)
 {
   // do nothing
 }
 
-InputFilter::InputFilter(const InputFilter &x) : m_ruleList(x.m_ruleList), m_primaryClient(NULL), m_events(x.m_events)
+InputFilter::InputFilter(const InputFilter &x)
+    : m_ruleList(x.m_ruleList),
+      m_primaryClient(NULL),
+      m_events(x.m_events),
+      m_indexed(false)
 {
   setPrimaryClient(x.m_primaryClient);
 }
@@ -804,14 +845,53 @@ InputFilter::~InputFilter()
 
 InputFilter &InputFilter::operator=(const InputFilter &x)
 {
-  if (&x != this) {
-    PrimaryClient *oldClient = m_primaryClient;
-    setPrimaryClient(NULL);
+  if (&x == this) {
+    return *this;
+  }
 
-    m_ruleList = x.m_ruleList;
+  // match each new rule with an identical old one, if any
+  std::multimap<String, UInt32> oldRules;
+  for (UInt32 i = 0; i < m_ruleList.size(); ++i) {
+    oldRules.insert(std::make_pair(m_ruleList[i].format(), i));
+  }
+  std::vector<SInt32> matches;
+  matches.reserve(x.m_ruleList.size());
+  std::vector<bool> kept(m_ruleList.size(), false);
+  for (const Rule &rule : x.m_ruleList) {
+    auto match = oldRules.find(rule.format());
+    if (match == oldRules.end()) {
+      matches.push_back(-1);
+    } else {
+      matches.push_back(static_cast<SInt32>(match->second));
+      kept[match->second] = true;
+      oldRules.erase(match);
+    }
+  }
 
-    setPrimaryClient(oldClient);
+  // disable the removed rules first, so a new rule can register the
+  // same hot key
+  if (m_primaryClient != NULL) {
+    for (UInt32 i = 0; i < m_ruleList.size(); ++i) {
+      if (!kept[i]) {
+        m_ruleList[i].disable(m_primaryClient);
+      }
+    }
   }
+
+  RuleList ruleList;
+  ruleList.reserve(x.m_ruleList.size());
+  for (UInt32 i = 0; i < x.m_ruleList.size(); ++i) {
+    if (matches[i] >= 0) {
+      ruleList.push_back(std::move(m_ruleList[matches[i]]));
+    } else {
+      ruleList.push_back(x.m_ruleList[i]);
+      if (m_primaryClient != NULL) {
+        ruleList.back().enable(m_primaryClient);
+      }
+    }
+  }
+  m_ruleList = std::move(ruleList);
+  m_indexed = false;
   return *this;
 }
 
@@ -821,6 +901,7 @@ void InputFilter::addFilterRule(const Rule &rule)
   if (m_primaryClient != NULL) {
     m_ruleList.back().enable(m_primaryClient);
   }
+  m_indexed = false;
 }
 
 void InputFilter::removeFilterRule(UInt32 index)
@@ -829,10 +910,12 @@ void InputFilter::removeFilterRule(UInt32 index)
     m_ruleList[index].disable(m_primaryClient);
   }
   m_ruleList.erase(m_ruleList.begin() + index);
+  m_indexed = false;
 }
 
 InputFilter::Rule &InputFilter::getRule(UInt32 index)
 {
+  m_indexed = false;
   return m_ruleList[index];
 }
 
@@ -858,6 +941,7 @@ void InputFilter::setPrimaryClient(PrimaryClient *client)
   }
 
   m_primaryClient = client;
+  m_indexed = false;
 
   if (m_primaryClient != NULL) {
     m_events->adoptHandler(
@@ -941,6 +1025,55 @@ bool InputFilter::operator!=(const InputFilter &x) const
   return !operator==(x);
 }
 
+void InputFilter::buildIndex()
+{
+  m_hotKeyRules.clear();
+  m_buttonRules.clear();
+  m_otherRules.clear();
+
+  for (UInt32 i = 0; i < m_ruleList.size(); ++i) {
+    const Condition *condition = m_ruleList[i].getCondition();
+    if (condition == NULL) {
+      // never matches
+      continue;
+    }
+
+    if (auto keystroke = dynamic_cast<const KeystrokeCondition *>(condition); keystroke != NULL) {
+      m_hotKeyRules[keystroke->getId()].push_back(i);
+    } else if (auto button = dynamic_cast<const MouseButtonCondition *>(condition); button != NULL) {
+      m_buttonRules[std::make_pair(button->getButton(), button->getMask())].push_back(i);
+    } else {
+      m_otherRules.push_back(i);
+    }
+  }
+  m_indexed = true;
+}
+
+const InputFilter::RuleIndexList &InputFilter::findRules(const Event &event)
+{
+  static const RuleIndexList s_noRules;
+
+  if (!m_indexed) {
+    buildIndex();
+  }
+
+  const Event::Type type = event.getType();
+  if (type == m_events->forIPrimaryScreen().hotKeyDown() || type == m_events->forIPrimaryScreen().hotKeyUp()) {
+    auto info = static_cast<const IPlatformScreen::HotKeyInfo *>(event.getData());
+    auto found = m_hotKeyRules.find(info->m_id);
+    if (found != m_hotKeyRules.end()) {
+      return found->second;
+    }
+  } else if (type == m_events->forIPrimaryScreen().buttonDown() || type == m_events->forIPrimaryScreen().buttonUp()) {
+    auto info = static_cast<const IPlatformScreen::ButtonInfo *>(event.getData());
+    auto found = m_buttonRules.find(std::make_pair(info->m_button, info->m_mask & ~kButtonIgnoreMask));
+    if (found != m_buttonRules.end()) {
+      return found->second;
+    }
+  }
+  return s_noRules;
+}
+
 void InputFilter::handleEvent(const Event &event, void *)
 {
   // copy event and adjust target
@@ -948,14 +1081,25 @@ void InputFilter::handleEvent(const Event &event, void *)
       event.getType(), this, event.getData(), event.getFlags() | Event::kDontFreeData | Event::kDeliverImmediately
   );
 
-  // let each rule try to match the event until one does
-  for (RuleList::iterator rule = m_ruleList.begin(); rule != m_ruleList.end(); ++rule) {
-    if (rule->handleEvent(myEvent)) {
+  // let each rule that could match the event try to until one does.
+  // merging the indexed rules with the others keeps the rule list order.
+  const RuleIndexList &indexed = findRules(myEvent);
+  auto i = indexed.begin();
+  auto j = m_otherRules.begin();
+  while (i != indexed.end() || j != m_otherRules.end()) {
+    UInt32 index;
+    if (j == m_otherRules.end() || (i != indexed.end() && *i < *j)) {
+      index = *i++;
+    } else {
+      index = *j++;
+    }
+    if (m_ruleList[index].handleEvent(myEvent)) {
       // handled
       return;
     }
   }
 
-  // not handled so pass through
-  m_events->addEvent(myEvent);
+  // not handled so pass through, the event is already being delivered
+  // immediately so there's no need to go through the queue
+  m_events->dispatchEvent(myEvent);
 }
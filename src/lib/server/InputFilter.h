@@ -25,6 +25,7 @@
 #include "deskflow/key_types.h"
 #include "deskflow/mouse_types.h"
 #include "deskflow/protocol_types.h"
+#include "server/ScreenNames.h"
 
 class PrimaryClient;
 class Event;
@@ -69,6 +70,9 @@ public:
     KeyID getKey() const;
     KeyModifierMask getMask() const;
 
+    // get the hot key id, 0 if not enabled
+    UInt32 getId() const;
+
     // Condition overrides
     virtual Condition *clone() const;
     virtual String format() const;
@@ -119,6 +123,7 @@ public:
 
   private:
     String m_screen;
+    ScreenID m_id;
     IEventQueue *m_events;
   };
 
@@ -314,9 +319,11 @@ public:
     Rule();
     Rule(Condition *adopted);
     Rule(const Rule &);
+    Rule(Rule &&) noexcept;
     ~Rule();
 
     Rule &operator=(const Rule &);
+    Rule &operator=(Rule &&) noexcept;
 
     // replace the condition
     void setCondition(Condition *adopted);
@@ -371,11 +378,17 @@ public:
   virtual ~InputFilter();
 
 #ifdef TEST_ENV
-  InputFilter() : m_primaryClient(NULL)
+  InputFilter() : m_primaryClient(NULL), m_indexed(false)
   {
   }
 #endif
 
+  //! Replace the rules
+  /*!
+  Rules that are in both filters are kept rather than copied, so if
+  filtering is enabled only the removed rules are disabled and only the
+  new ones enabled.  Hot keys of unchanged rules stay registered.
+  */
   InputFilter &operator=(const InputFilter &);
 
   // add rule, adopting the condition and the actions
@@ -384,7 +397,7 @@ public:
   // remove a rule
   void removeFilterRule(UInt32 index);
 
-  // get rule by index
+  // get rule by index.  the rule may be changed.
   Rule &getRule(UInt32 index);
 
   // enable event filtering using the given primary client.  disable
@@ -403,6 +416,14 @@ public:
   bool operator!=(const InputFilter &) const;
 
 private:
+  typedef std::vector<UInt32> RuleIndexList;
+
+  // index the rules by what their conditions match
+  void buildIndex();
+
+  // get the indexed rules that could match an event, in order
+  const RuleIndexList &findRules(const Event &);
+
   // event handling
   void handleEvent(const Event &, void *);
 
@@ -410,4 +431,13 @@ private:
   RuleList m_ruleList;
   PrimaryClient *m_primaryClient;
   IEventQueue *m_events;
+
+  // indexes of the rules, by hot key id for keystroke conditions and by
+  // button and modifiers for mouse button conditions.  other conditions
+  // are tried for every event.  built on the first event after the rules
+  // or the primary client change.
+  bool m_indexed;
+  std::map<UInt32, RuleIndexList> m_hotKeyRules;
+  std::map<std::pair<ButtonID, KeyModifierMask>, RuleIndexList> m_buttonRules;
+  RuleIndexList m_otherRules;
 };
@@ -41,7 +41,7 @@ public:
   ~PrimaryClient();
 
 #ifdef TEST_ENV
-  PrimaryClient() : BaseClientProxy("")
+  explicit PrimaryClient(const String &name = "") : BaseClientProxy(name)
   {
   }
 #endif
@@ -157,6 +157,13 @@ public:
     return true;
   }
 
+  // only the primary screen's own clipboards have deferred formats and
+  // it's never sent those
+  bool requestsClipboardData() const override
+  {
+    return true;
+  }
+
 private:
   deskflow::Screen *m_screen;
   bool m_clipboardDirty[kClipboardEnd];
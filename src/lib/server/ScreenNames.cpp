@@ -0,0 +1,83 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "server/ScreenNames.h"
+
+#include "mt/Lock.h"
+#include "mt/Mutex.h"
+
+#include <deque>
+#include <map>
+
+namespace {
+
+// guards everything below, configurations are read on their own thread
+Mutex &getMutex()
+{
+  static Mutex s_mutex;
+  return s_mutex;
+}
+
+std::map<String, ScreenID, deskflow::string::CaselessCmp> s_ids;
+
+// indexed by id, a deque so references to names stay valid
+std::deque<String> s_names(1);
+
+} // namespace
+
+//
+// ScreenNames
+//
+
+const ScreenID ScreenNames::kNoScreen;
+
+ScreenID ScreenNames::intern(const String &name)
+{
+  if (name.empty()) {
+    return kNoScreen;
+  }
+
+  Lock lock(&getMutex());
+  auto index = s_ids.find(name);
+  if (index != s_ids.end()) {
+    return index->second;
+  }
+
+  ScreenID id = static_cast<ScreenID>(s_names.size());
+  s_names.push_back(name);
+  s_ids.insert(std::make_pair(name, id));
+  return id;
+}
+
+ScreenID ScreenNames::find(const String &name)
+{
+  Lock lock(&getMutex());
+  auto index = s_ids.find(name);
+  if (index == s_ids.end()) {
+    return kNoScreen;
+  }
+  return index->second;
+}
+
+const String &ScreenNames::get(ScreenID id)
+{
+  Lock lock(&getMutex());
+  if (id >= s_names.size()) {
+    return s_names[kNoScreen];
+  }
+  return s_names[id];
+}
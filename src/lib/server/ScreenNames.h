@@ -0,0 +1,71 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "base/String.h"
+#include "common/basic_types.h"
+
+//! Interned screen name
+/*!
+Identifies a screen without its name, so screens can be compared and
+looked up without allocating or comparing strings.
+*/
+typedef UInt32 ScreenID;
+
+//! Screen name pool
+/*!
+Maps screen names to ScreenIDs for the whole process.  Names that only
+differ in case have the same id, and a name keeps its id even if it's
+removed from the configuration, so ids from different configurations
+can be compared.  Names are only added, never removed, so only names
+from a configuration should be interned.
+*/
+class ScreenNames
+{
+public:
+  //! @name manipulators
+  //@{
+
+  //! Intern a name
+  /*!
+  Returns the id of \p name, adding it to the pool if needed.
+  */
+  static ScreenID intern(const String &name);
+
+  //@}
+  //! @name accessors
+  //@{
+
+  //! Find a name
+  /*!
+  Returns the id of \p name, or kNoScreen if it was never interned.
+  */
+  static ScreenID find(const String &name);
+
+  //! Get a name
+  /*!
+  Returns the name \p id was interned with, in the case it first had,
+  or the empty string for kNoScreen.  The reference stays valid.
+  */
+  static const String &get(ScreenID id);
+
+  //@}
+
+  //! The id of no screen
+  static const ScreenID kNoScreen = 0;
+};
@@ -23,6 +23,7 @@
 #include "base/Log.h"
 #include "base/TMethodEventJob.h"
 #include "base/TMethodJob.h"
+#include "base/Trace.h"
 #include "common/stdexcept.h"
 #include "deskflow/AppUtil.h"
 #include "deskflow/DropHelper.h"
@@ -48,6 +49,14 @@
 
 using namespace deskflow::server;
 
+namespace {
+
+// how long after a switch to send the clipboards, so that crossing back
+// and forth quickly doesn't read and send them each time
+const double kClipboardTransferDelay = 0.25;
+
+} // namespace
+
 //
 // Server
 //
@@ -60,6 +69,8 @@ Server::Server(
       m_primaryClient(primaryClient),
       m_active(primaryClient),
       m_seqNum(0),
+      m_x(0),
+      m_y(0),
       m_xDelta(0),
       m_yDelta(0),
       m_xDelta2(0),
@@ -71,6 +82,8 @@ Server::Server(
       m_switchScreen(NULL),
       m_switchWaitDelay(0.0),
       m_switchWaitTimer(NULL),
+      m_clipboardTransferTimer(NULL),
+      m_clipboardTransferFromPrimary(false),
       m_switchTwoTapDelay(0.0),
       m_switchTwoTapEngaged(false),
       m_switchTwoTapArmed(false),
@@ -88,28 +101,32 @@ Server::Server(
       m_ignoreFileTransfer(false),
       m_disableLockToScreen(false),
       m_enableClipboard(true),
+      m_enableMotionChannel(false),
       m_maximumClipboardSize(INT_MAX),
+      m_maxHandshakes(ClientListener::kDefaultMaxHandshakes),
       m_sendDragInfoThread(nullptr),
       m_waitDragInfoThread(true),
-      m_args(args)
+      m_clientListener(nullptr),
+      m_args(args),
+      m_heartbeatTicker(new HeartbeatTicker(events))
 {
   // must have a primary client and it must have a canonical name
   assert(m_primaryClient != NULL);
   assert(config.isScreen(primaryClient->getName()));
   assert(m_screen != NULL);
 
-  String primaryName = getName(primaryClient);
+  primaryClient->setId(config.getScreenId(primaryClient->getName()));
 
   // clear clipboards
   for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
     ClipboardInfo &clipboard = m_clipboards[id];
-    clipboard.m_clipboardOwner = primaryName;
+    clipboard.m_clipboardOwner = primaryClient->getId();
     clipboard.m_clipboardSeqNum = m_seqNum;
     if (clipboard.m_clipboard.open(0)) {
       clipboard.m_clipboard.empty();
       clipboard.m_clipboard.close();
     }
-    clipboard.m_clipboardData = clipboard.m_clipboard.marshall();
+    clipboard.m_clipboardGeneration = clipboard.m_clipboard.getGeneration();
   }
 
   // install event handlers
@@ -234,6 +251,7 @@ Server::~Server()
   } catch (std::exception &e) { // NOSONAR
     LOG((CLOG_ERR "failed to disconnect: %s", e.what()));
   }
+  stopClipboardTransfer();
 
   for (OldClients::iterator index = m_oldClients.begin(); index != m_oldClients.end(); ++index) {
     BaseClientProxy *client = index->first;
@@ -262,8 +280,27 @@ bool Server::setConfig(const ServerConfig &config)
   // configuration.
   closeClients(config);
 
-  // cut over
-  processOptions();
+  // note the current state, so that a reload only updates what changed.
+  // the first time, the configuration is already ours.
+  const bool initial = (&config == m_config);
+  std::map<BaseClientProxy *, OptionsList> oldOptions;
+  UInt32 oldSides = 0;
+  bool optionsChanged = true;
+  if (!initial) {
+    for (ClientList::const_iterator index = m_clients.begin(); index != m_clients.end(); ++index) {
+      getClientOptions(index->second, oldOptions[index->second]);
+    }
+    oldSides = getActivePrimarySides();
+
+    const Config::ScreenOptions *oldGlobal = m_config->getOptions("");
+    const Config::ScreenOptions *newGlobal = config.getOptions("");
+    optionsChanged = (oldGlobal == NULL || newGlobal == NULL || *oldGlobal != *newGlobal);
+  }
+
+  ServerConfig newConfig(config);
+  if (optionsChanged) {
+    processOptions(newConfig);
+  }
 
   // add ScrollLock as a hotkey to lock to the screen.  this was a
   // built-in feature in earlier releases and is now supported via
@@ -271,21 +308,46 @@ bool Server::setConfig(const ServerConfig &config)
   // registered ScrollLock for something else then that will win but
   // we will unfortunately generate a warning.  if the user has
   // configured a LockCursorToScreenAction then we don't add
-  // ScrollLock as a hotkey.
-  if (!m_disableLockToScreen && !m_config->hasLockToScreenAction()) {
+  // ScrollLock as a hotkey.  it's added before the cut over so that
+  // it stays registered when the configuration is reloaded.
+  if (!m_disableLockToScreen && !newConfig.hasLockToScreenAction()) {
     IPlatformScreen::KeyInfo *key = IPlatformScreen::KeyInfo::alloc(kKeyScrollLock, 0, 0, 0);
     InputFilter::Rule rule(new InputFilter::KeystrokeCondition(m_events, key));
     rule.adoptAction(new InputFilter::LockCursorToScreenAction(m_events), true);
-    m_inputFilter->addFilterRule(rule);
+    newConfig.getInputFilter()->addFilterRule(rule);
   }
 
+  // cut over.  only the filter rules that changed are replaced.
+  *m_config = newConfig;
+  m_keyTargets.clear();
+
   // tell primary screen about reconfiguration
-  m_primaryClient->reconfigure(getActivePrimarySides());
+  const UInt32 sides = getActivePrimarySides();
+  if (initial || sides != oldSides) {
+    m_primaryClient->reconfigure(sides);
+  }
 
-  // tell all (connected) clients about current options
+  // tell all (connected) clients about current options, if they changed.
+  // clients with the same options share one broadcast.
+  std::map<OptionsList, std::vector<BaseClientProxy *>> optionsGroups;
   for (ClientList::const_iterator index = m_clients.begin(); index != m_clients.end(); ++index) {
     BaseClientProxy *client = index->second;
-    sendOptions(client);
+    OptionsList options;
+    getClientOptions(client, options);
+    if (!initial) {
+      auto old = oldOptions.find(client);
+      if (old != oldOptions.end() && old->second == options) {
+        continue;
+      }
+    }
+    optionsGroups[options].push_back(client);
+  }
+  for (const auto &group : optionsGroups) {
+    ClientProxy::Broadcast broadcast;
+    for (BaseClientProxy *client : group.second) {
+      client->resetOptions();
+      client->setOptions(group.first);
+    }
   }
 
   return true;
@@ -302,11 +364,13 @@ void Server::adoptClient(BaseClientProxy *client)
   );
 
   // name must be in our configuration
-  if (!m_config->isScreen(client->getName())) {
+  const ScreenID id = m_config->getScreenId(client->getName());
+  if (id == ScreenNames::kNoScreen) {
     LOG((CLOG_WARN "unrecognised client name \"%s\", check server config", client->getName().c_str()));
     closeClient(client, kMsgEUnknown);
     return;
   }
+  client->setId(id);
 
   // add client to client list
   if (!addClient(client)) {
@@ -326,7 +390,7 @@ void Server::adoptClient(BaseClientProxy *client)
   }
 
   // send notification
-  Server::ScreenConnectedInfo *info = new Server::ScreenConnectedInfo(getName(client));
+  Server::ScreenConnectedInfo *info = new Server::ScreenConnectedInfo(client->getId(), getName(client));
   m_events->addEvent(Event(m_events->forServer().connected(), m_primaryClient->getEventTarget(), info));
 }
 
@@ -350,15 +414,15 @@ void Server::getClients(std::vector<String> &list) const
 {
   list.clear();
   for (ClientList::const_iterator index = m_clients.begin(); index != m_clients.end(); ++index) {
-    list.push_back(index->first);
+    list.push_back(getName(index->second));
   }
 }
 
-String Server::getName(const BaseClientProxy *client) const
+const String &Server::getName(const BaseClientProxy *client) const
 {
-  String name = m_config->getCanonicalName(client->getName());
+  const String &name = m_config->getScreenName(client->getId());
   if (name.empty()) {
-    name = client->getName();
+    return client->getName();
   }
   return name;
 }
@@ -457,13 +521,12 @@ void Server::switchScreen(BaseClientProxy *dst, SInt32 x, SInt32 y, bool forScre
     }
 
     // update the primary client's clipboards if we're leaving the
-    // primary screen.
-    if (m_active == m_primaryClient && m_enableClipboard) {
-      for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
-        ClipboardInfo &clipboard = m_clipboards[id];
-        if (clipboard.m_clipboardOwner == getName(m_primaryClient)) {
-          onClipboardChanged(m_primaryClient, id, clipboard.m_clipboardSeqNum);
-        }
+    // primary screen, unless we're going straight back to it.
+    if (m_enableClipboard) {
+      if (m_active == m_primaryClient) {
+        m_clipboardTransferFromPrimary = true;
+      } else if (dst == m_primaryClient) {
+        m_clipboardTransferFromPrimary = false;
       }
     }
 
@@ -488,15 +551,9 @@ void Server::switchScreen(BaseClientProxy *dst, SInt32 x, SInt32 y, bool forScre
     // enter new screen
     m_active->enter(x, y, m_seqNum, m_primaryClient->getToggleMask(), forScreensaver);
 
+    // send the clipboard data to new active screen
     if (m_enableClipboard) {
-      // send the clipboard data to new active screen
-      for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
-        // Hackity hackity hack
-        if (m_clipboards[id].m_clipboard.marshall().size() > (m_maximumClipboardSize * 1024)) {
-          continue;
-        }
-        m_active->setClipboard(id, &m_clipboards[id].m_clipboard);
-      }
+      startClipboardTransfer();
     }
 
     Server::SwitchToScreenInfo *info = Server::SwitchToScreenInfo::alloc(m_active->getName());
@@ -565,7 +622,7 @@ bool Server::hasAnyNeighbor(BaseClientProxy *client, EDirection dir) const
 {
   assert(client != NULL);
 
-  return m_config->hasNeighbor(getName(client), dir);
+  return m_config->hasNeighbor(client->getId(), dir);
 }
 
 BaseClientProxy *Server::getNeighbor(BaseClientProxy *src, EDirection dir, SInt32 &x, SInt32 &y) const
@@ -574,10 +631,10 @@ BaseClientProxy *Server::getNeighbor(BaseClientProxy *src, EDirection dir, SInt3
 
   assert(src != NULL);
 
-  // get source screen name
-  String srcName = getName(src);
-  assert(!srcName.empty());
-  LOG((CLOG_DEBUG2 "find neighbor on %s of \"%s\"", Config::dirName(dir), srcName.c_str()));
+  // get source screen
+  ScreenID srcId = src->getId();
+  assert(srcId != ScreenNames::kNoScreen);
+  LOG((CLOG_DEBUG2 "find neighbor on %s of \"%s\"", Config::dirName(dir), getName(src).c_str()));
 
   // convert position to fraction
   float t = mapToFraction(src, dir, x, y);
@@ -585,20 +642,22 @@ BaseClientProxy *Server::getNeighbor(BaseClientProxy *src, EDirection dir, SInt3
   // search for the closest neighbor that exists in direction dir
   float tTmp;
   for (;;) {
-    String dstName(m_config->getNeighbor(srcName, dir, t, &tTmp));
+    const ScreenID dstId = m_config->getNeighbor(srcId, dir, t, &tTmp);
+    const String &srcName = m_config->getScreenName(srcId);
 
     // if nothing in that direction then return NULL. if the
     // destination is the source then we can make no more
     // progress in this direction.  since we haven't found a
     // connected neighbor we return NULL.
-    if (dstName.empty()) {
+    if (dstId == ScreenNames::kNoScreen) {
       LOG((CLOG_DEBUG2 "no neighbor on %s of \"%s\"", Config::dirName(dir), srcName.c_str()));
       return NULL;
     }
 
     // look up neighbor cell.  if the screen is connected and
     // ready then we can stop.
-    ClientList::const_iterator index = m_clients.find(dstName);
+    const String &dstName = m_config->getScreenName(dstId);
+    ClientList::const_iterator index = m_clients.find(dstId);
     if (index != m_clients.end()) {
       LOG((CLOG_DEBUG2 "\"%s\" is on %s of \"%s\" at %f", dstName.c_str(), Config::dirName(dir), srcName.c_str(), t));
       mapToPixel(index->second, dir, tTmp, x, y);
@@ -607,7 +666,7 @@ BaseClientProxy *Server::getNeighbor(BaseClientProxy *src, EDirection dir, SInt3
 
     // skip over unconnected screen
     LOG((CLOG_DEBUG2 "ignored \"%s\" on %s of \"%s\"", dstName.c_str(), Config::dirName(dir), srcName.c_str()));
-    srcName = dstName;
+    srcId = dstId;
 
     // use position on skipped screen
     t = tTmp;
@@ -726,7 +785,7 @@ void Server::avoidJumpZone(BaseClientProxy *dst, EDirection dir, SInt32 &x, SInt
     return;
   }
 
-  const String dstName(getName(dst));
+  const ScreenID dstId = dst->getId();
   SInt32 dx, dy, dw, dh;
   dst->getShape(dx, dy, dw, dh);
   float t = mapToFraction(dst, dir, x, y);
@@ -737,22 +796,22 @@ void Server::avoidJumpZone(BaseClientProxy *dst, EDirection dir, SInt32 &x, SInt
   // don't need to move inwards because that side can't provoke a jump.
   switch (dir) {
   case kLeft:
-    if (!m_config->getNeighbor(dstName, kRight, t, NULL).empty() && x > dx + dw - 1 - z)
+    if (m_config->getNeighbor(dstId, kRight, t, NULL) != ScreenNames::kNoScreen && x > dx + dw - 1 - z)
       x = dx + dw - 1 - z;
     break;
 
   case kRight:
-    if (!m_config->getNeighbor(dstName, kLeft, t, NULL).empty() && x < dx + z)
+    if (m_config->getNeighbor(dstId, kLeft, t, NULL) != ScreenNames::kNoScreen && x < dx + z)
       x = dx + z;
     break;
 
   case kTop:
-    if (!m_config->getNeighbor(dstName, kBottom, t, NULL).empty() && y > dy + dh - 1 - z)
+    if (m_config->getNeighbor(dstId, kBottom, t, NULL) != ScreenNames::kNoScreen && y > dy + dh - 1 - z)
       y = dy + dh - 1 - z;
     break;
 
   case kBottom:
-    if (!m_config->getNeighbor(dstName, kTop, t, NULL).empty() && y < dy + z)
+    if (m_config->getNeighbor(dstId, kTop, t, NULL) != ScreenNames::kNoScreen && y < dy + z)
       y = dy + z;
     break;
 
@@ -811,7 +870,7 @@ bool Server::isSwitchOkay(
 
   // are we in a locked corner?  first check if screen has the option set
   // and, if not, check the global options.
-  const Config::ScreenOptions *options = m_config->getOptions(getName(m_active));
+  const Config::ScreenOptions *options = m_config->getOptions(m_active->getId());
   if (options == NULL || options->count(kOptionScreenSwitchCorners) == 0) {
     options = m_config->getOptions("");
   }
@@ -963,6 +1022,93 @@ bool Server::isSwitchWaitStarted() const
   return (m_switchWaitTimer != NULL);
 }
 
+void Server::startClipboardTransfer()
+{
+  stopClipboardTransfer();
+  m_clipboardTransferTimer = m_events->newOneShotTimer(kClipboardTransferDelay, NULL);
+  m_events->adoptHandler(
+      Event::kTimer, m_clipboardTransferTimer,
+      new TMethodEventJob<Server>(this, &Server::handleClipboardTransferTimeout)
+  );
+}
+
+void Server::stopClipboardTransfer()
+{
+  if (m_clipboardTransferTimer != NULL) {
+    m_events->removeHandler(Event::kTimer, m_clipboardTransferTimer);
+    m_events->deleteTimer(m_clipboardTransferTimer);
+    m_clipboardTransferTimer = NULL;
+  }
+}
+
+void Server::flushClipboardTransfer()
+{
+  if (m_clipboardTransferTimer == NULL) {
+    return;
+  }
+  stopClipboardTransfer();
+
+  // read the clipboards the primary owns.  any that changed are sent to
+  // the active screen here.
+  if (m_clipboardTransferFromPrimary) {
+    m_clipboardTransferFromPrimary = false;
+    for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+      ClipboardInfo &clipboard = m_clipboards[id];
+      if (clipboard.m_clipboardOwner == m_primaryClient->getId()) {
+        onClipboardChanged(m_primaryClient, id, clipboard.m_clipboardSeqNum);
+      }
+    }
+  }
+
+  // the active screen ignores clipboards it already has
+  for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+    sendClipboard(id);
+  }
+}
+
+void Server::sendClipboard(ClipboardID id)
+{
+  ClipboardInfo &clipboard = m_clipboards[id];
+
+  // formats that can't be read, e.g. over the size limit, stay deferred
+  if (!m_active->requestsClipboardData() && fetchClipboard(id, IClipboard::kAllFormats).getDeferredFormats() != 0) {
+    return;
+  }
+  if (clipboard.m_clipboard.getMarshalledSize() > (m_maximumClipboardSize * 1024)) {
+    return;
+  }
+  m_active->setClipboard(id, &clipboard.m_clipboard);
+}
+
+const Clipboard &Server::fetchClipboard(ClipboardID id, UInt32 formats)
+{
+  ClipboardInfo &clipboard = m_clipboards[id];
+  formats &= clipboard.m_clipboard.getDeferredFormats();
+  if (formats == 0) {
+    return clipboard.m_clipboard;
+  }
+
+  ClientList::const_iterator owner = m_clients.find(clipboard.m_clipboardOwner);
+  if (owner == m_clients.end()) {
+    return clipboard.m_clipboard;
+  }
+
+  // read only the requested formats, the others stay deferred
+  Clipboard fetched;
+  fetched.setDeferrableFormats(IClipboard::kAllFormats & ~formats);
+  owner->second->getClipboard(id, &fetched);
+  LOG((CLOG_DEBUG "read clipboard %d formats 0x%x from \"%s\"", id, formats, getName(owner->second).c_str()));
+
+  if (!clipboard.m_clipboard.resolve(fetched, formats, m_maximumClipboardSize * 1024)) {
+    LOG(
+        (CLOG_NOTE "not sending clipboard %d formats 0x%x because they're over the size limit "
+                   "(%i KB) configured by the server",
+         id, formats, m_maximumClipboardSize)
+    );
+  }
+  return clipboard.m_clipboard;
+}
+
 UInt32 Server::getCorner(BaseClientProxy *client, SInt32 x, SInt32 y, SInt32 size) const
 {
   assert(client != NULL);
@@ -1029,12 +1175,10 @@ void Server::stopRelativeMoves()
   }
 }
 
-void Server::sendOptions(BaseClientProxy *client) const
+void Server::getClientOptions(BaseClientProxy *client, OptionsList &optionsList) const
 {
-  OptionsList optionsList;
-
   // look up options for client
-  const Config::ScreenOptions *options = m_config->getOptions(getName(client));
+  const Config::ScreenOptions *options = m_config->getOptions(client->getId());
   if (options != NULL) {
     // convert options to a more convenient form for sending
     optionsList.reserve(2 * options->size());
@@ -1054,15 +1198,21 @@ void Server::sendOptions(BaseClientProxy *client) const
       optionsList.push_back(static_cast<UInt32>(index->second));
     }
   }
+}
+
+void Server::sendOptions(BaseClientProxy *client) const
+{
+  OptionsList optionsList;
+  getClientOptions(client, optionsList);
 
   // send the options
   client->resetOptions();
   client->setOptions(optionsList);
 }
 
-void Server::processOptions()
+void Server::processOptions(const ServerConfig &config)
 {
-  const Config::ScreenOptions *options = m_config->getOptions("");
+  const Config::ScreenOptions *options = config.getOptions("");
   if (options == NULL) {
     return;
   }
@@ -1070,6 +1220,8 @@ void Server::processOptions()
   m_switchNeedsShift = false;   // it seems if i don't add these
   m_switchNeedsControl = false; // lines, the 'reload config' option
   m_switchNeedsAlt = false;     // doesnt' work correct.
+  m_enableMotionChannel = false;
+  m_maxHandshakes = ClientListener::kDefaultMaxHandshakes;
 
   bool newRelativeMoves = m_relativeMoves;
   for (Config::ScreenOptions::const_iterator index = options->begin(); index != options->end(); ++index) {
@@ -1102,6 +1254,10 @@ void Server::processOptions()
       if (!m_enableClipboard) {
         LOG((CLOG_NOTE "clipboard sharing is disabled"));
       }
+    } else if (id == kOptionMotionChannel) {
+      m_enableMotionChannel = (value != 0);
+    } else if (id == kOptionMaxHandshakes) {
+      m_maxHandshakes = value;
     } else if (id == kOptionClipboardSharingSize) {
       if (value <= 0) {
         m_maximumClipboardSize = 0;
@@ -1116,6 +1272,10 @@ void Server::processOptions()
     stopRelativeMoves();
   }
   m_relativeMoves = newRelativeMoves;
+
+  if (m_clientListener != nullptr) {
+    m_clientListener->setMaxHandshakes(m_maxHandshakes);
+  }
 }
 
 void Server::handleShapeChanged(const Event &, void *vclient)
@@ -1173,9 +1333,9 @@ void Server::handleClipboardGrabbed(const Event &event, void *vclient)
   // mark screen as owning clipboard
   LOG(
       (CLOG_INFO "screen \"%s\" grabbed clipboard %d from \"%s\"", getName(grabber).c_str(), info->m_id,
-       clipboard.m_clipboardOwner.c_str())
+       ScreenNames::get(clipboard.m_clipboardOwner).c_str())
   );
-  clipboard.m_clipboardOwner = getName(grabber);
+  clipboard.m_clipboardOwner = grabber->getId();
   clipboard.m_clipboardSeqNum = info->m_sequenceNumber;
 
   // clear the clipboard data (since it's not known at this point)
@@ -1183,16 +1343,19 @@ void Server::handleClipboardGrabbed(const Event &event, void *vclient)
     clipboard.m_clipboard.empty();
     clipboard.m_clipboard.close();
   }
-  clipboard.m_clipboardData = clipboard.m_clipboard.marshall();
+  clipboard.m_clipboardGeneration = clipboard.m_clipboard.getGeneration();
 
   // tell all other screens to take ownership of clipboard.  tell the
   // grabber that it's clipboard isn't dirty.
-  for (ClientList::iterator index = m_clients.begin(); index != m_clients.end(); ++index) {
-    BaseClientProxy *client = index->second;
-    if (client == grabber) {
-      client->setClipboardDirty(info->m_id, false);
-    } else {
-      client->grabClipboard(info->m_id);
+  {
+    ClientProxy::Broadcast broadcast;
+    for (ClientList::iterator index = m_clients.begin(); index != m_clients.end(); ++index) {
+      BaseClientProxy *client = index->second;
+      if (client == grabber) {
+        client->setClipboardDirty(info->m_id, false);
+      } else {
+        client->grabClipboard(info->m_id);
+      }
     }
   }
 
@@ -1289,6 +1452,11 @@ void Server::handleSwitchWaitTimeout(const Event &, void *)
   switchScreen(m_switchScreen, m_switchWaitX, m_switchWaitY, false);
 }
 
+void Server::handleClipboardTransferTimeout(const Event &, void *)
+{
+  flushClipboardTransfer();
+}
+
 void Server::handleClientDisconnected(const Event &, void *vclient)
 {
   // client has disconnected.  it might be an old client or an
@@ -1315,7 +1483,7 @@ void Server::handleSwitchToScreenEvent(const Event &event, void *)
 {
   SwitchToScreenInfo *info = static_cast<SwitchToScreenInfo *>(event.getData());
 
-  ClientList::const_iterator index = m_clients.find(info->m_screen);
+  ClientList::const_iterator index = m_clients.find(m_config->getScreenId(info->m_screen));
   if (index == m_clients.end()) {
     LOG((CLOG_DEBUG1 "screen \"%s\" not active", info->m_screen));
   } else {
@@ -1422,6 +1590,31 @@ void Server::handleFileRecieveCompletedEvent(const Event &event, void *)
   onFileRecieveCompleted();
 }
 
+const Server::KeyTargets &Server::getKeyTargets(const char *screens)
+{
+  if (!screens && m_keyboardBroadcasting) {
+    screens = m_keyboardBroadcastingScreens.c_str();
+    if (IKeyState::KeyInfo::isDefault(screens)) {
+      screens = "*";
+    }
+  }
+  if (screens == NULL) {
+    screens = "";
+  }
+
+  auto index = m_keyTargets.find(screens);
+  if (index == m_keyTargets.end()) {
+    KeyTargets targets;
+    for (ClientList::const_iterator client = m_clients.begin(); client != m_clients.end(); ++client) {
+      if (IKeyState::KeyInfo::contains(screens, getName(client->second))) {
+        targets.push_back(client->second);
+      }
+    }
+    index = m_keyTargets.insert(std::make_pair(String(screens), targets)).first;
+  }
+  return index->second;
+}
+
 void Server::onClipboardChanged(BaseClientProxy *sender, ClipboardID id, UInt32 seqNum)
 {
   ClipboardInfo &clipboard = m_clipboards[id];
@@ -1438,8 +1631,7 @@ void Server::onClipboardChanged(BaseClientProxy *sender, ClipboardID id, UInt32
   // get data
   sender->getClipboard(id, &clipboard.m_clipboard);
 
-  String data = clipboard.m_clipboard.marshall();
-  if (data.size() > m_maximumClipboardSize * 1024) {
+  if (clipboard.m_clipboard.getMarshalledSize() > m_maximumClipboardSize * 1024) {
     LOG(
         (CLOG_NOTE "not updating clipboard because it's over the size limit "
                    "(%i KB) configured by the server",
@@ -1449,15 +1641,15 @@ void Server::onClipboardChanged(BaseClientProxy *sender, ClipboardID id, UInt32
   }
 
   // ignore if data hasn't changed
-  if (data == clipboard.m_clipboardData) {
-    LOG((CLOG_DEBUG "ignored screen \"%s\" update of clipboard %d (unchanged)", clipboard.m_clipboardOwner.c_str(), id)
-    );
+  const UInt32 generation = clipboard.m_clipboard.getGeneration();
+  if (generation == clipboard.m_clipboardGeneration) {
+    LOG((CLOG_DEBUG "ignored screen \"%s\" update of clipboard %d (unchanged)", getName(sender).c_str(), id));
     return;
   }
 
   // got new data
-  LOG((CLOG_INFO "screen \"%s\" updated clipboard %d", clipboard.m_clipboardOwner.c_str(), id));
-  clipboard.m_clipboardData = data;
+  LOG((CLOG_INFO "screen \"%s\" updated clipboard %d", getName(sender).c_str(), id));
+  clipboard.m_clipboardGeneration = generation;
 
   // tell all clients except the sender that the clipboard is dirty
   for (ClientList::const_iterator index = m_clients.begin(); index != m_clients.end(); ++index) {
@@ -1466,7 +1658,7 @@ void Server::onClipboardChanged(BaseClientProxy *sender, ClipboardID id, UInt32
   }
 
   // send the new clipboard to the active screen
-  m_active->setClipboard(id, &clipboard.m_clipboard);
+  sendClipboard(id);
 }
 
 void Server::onScreensaver(bool activated)
@@ -1513,6 +1705,7 @@ void Server::onScreensaver(bool activated)
   }
 
   // send message to all clients
+  ClientProxy::Broadcast broadcast;
   for (ClientList::const_iterator index = m_clients.begin(); index != m_clients.end(); ++index) {
     BaseClientProxy *client = index->second;
     client->screensaver(activated);
@@ -1524,20 +1717,16 @@ void Server::onKeyDown(KeyID id, KeyModifierMask mask, KeyButton button, const S
   LOG((CLOG_DEBUG1 "onKeyDown id=%d mask=0x%04x button=0x%04x lang=%s", id, mask, button, lang.c_str()));
   assert(m_active != NULL);
 
+  // a key may paste, so the active screen must have the clipboards first
+  flushClipboardTransfer();
+
   // relay
   if (!m_keyboardBroadcasting && IKeyState::KeyInfo::isDefault(screens)) {
     m_active->keyDown(id, mask, button, lang);
   } else {
-    if (!screens && m_keyboardBroadcasting) {
-      screens = m_keyboardBroadcastingScreens.c_str();
-      if (IKeyState::KeyInfo::isDefault(screens)) {
-        screens = "*";
-      }
-    }
-    for (ClientList::const_iterator index = m_clients.begin(); index != m_clients.end(); ++index) {
-      if (IKeyState::KeyInfo::contains(screens, index->first)) {
-        index->second->keyDown(id, mask, button, lang);
-      }
+    ClientProxy::Broadcast broadcast;
+    for (BaseClientProxy *client : getKeyTargets(screens)) {
+      client->keyDown(id, mask, button, lang);
     }
   }
 }
@@ -1551,16 +1740,9 @@ void Server::onKeyUp(KeyID id, KeyModifierMask mask, KeyButton button, const cha
   if (!m_keyboardBroadcasting && IKeyState::KeyInfo::isDefault(screens)) {
     m_active->keyUp(id, mask, button);
   } else {
-    if (!screens && m_keyboardBroadcasting) {
-      screens = m_keyboardBroadcastingScreens.c_str();
-      if (IKeyState::KeyInfo::isDefault(screens)) {
-        screens = "*";
-      }
-    }
-    for (ClientList::const_iterator index = m_clients.begin(); index != m_clients.end(); ++index) {
-      if (IKeyState::KeyInfo::contains(screens, index->first)) {
-        index->second->keyUp(id, mask, button);
-      }
+    ClientProxy::Broadcast broadcast;
+    for (BaseClientProxy *client : getKeyTargets(screens)) {
+      client->keyUp(id, mask, button);
     }
   }
 }
@@ -1582,6 +1764,9 @@ void Server::onMouseDown(ButtonID id)
   LOG((CLOG_DEBUG1 "onMouseDown id=%d", id));
   assert(m_active != NULL);
 
+  // so may a button
+  flushClipboardTransfer();
+
   // relay
   m_active->mouseDown(id);
 
@@ -1757,6 +1942,7 @@ void Server::sendDragInfo(BaseClientProxy *newScreen)
 
 void Server::onMouseMoveSecondary(SInt32 dx, SInt32 dy)
 {
+  TRACE(TraceEvent::kServerMouseMoveSecondary, dx, dy);
   LOG((CLOG_DEBUG2 "onMouseMoveSecondary initial %+d,%+d", dx, dy));
   const char *envVal = std::getenv("SYNERGY_MOUSE_ADJUSTMENT");
   if (envVal != nullptr) {
@@ -1971,8 +2157,7 @@ void Server::writeToDropDirThread(void *)
 
 bool Server::addClient(BaseClientProxy *client)
 {
-  String name = getName(client);
-  if (m_clients.count(name) != 0) {
+  if (m_clients.count(client->getId()) != 0) {
     return false;
   }
 
@@ -1992,7 +2177,8 @@ bool Server::addClient(BaseClientProxy *client)
 
   // add to list
   m_clientSet.insert(client);
-  m_clients.insert(std::make_pair(name, client));
+  m_clients.insert(std::make_pair(client->getId(), client));
+  m_keyTargets.clear();
 
   // initialize client data
   SInt32 x, y;
@@ -2019,7 +2205,8 @@ bool Server::removeClient(BaseClientProxy *client)
   m_events->removeHandler(m_events->forClipboard().clipboardChanged(), client->getEventTarget());
 
   // remove from list
-  m_clients.erase(getName(client));
+  m_clients.erase(client->getId());
+  m_keyTargets.clear();
   m_clientSet.erase(i);
 
   return true;
@@ -2068,7 +2255,7 @@ void Server::closeClients(const ServerConfig &config)
   typedef std::set<BaseClientProxy *> RemovedClients;
   RemovedClients removed;
   for (ClientList::iterator index = m_clients.begin(); index != m_clients.end(); ++index) {
-    if (!config.isCanonicalName(index->first)) {
+    if (!config.isCanonicalName(getName(index->second))) {
       removed.insert(index->second);
     }
   }
@@ -2152,9 +2339,15 @@ void Server::forceLeaveClient(BaseClientProxy *client)
 // Server::ClipboardInfo
 //
 
-Server::ClipboardInfo::ClipboardInfo() : m_clipboard(), m_clipboardData(), m_clipboardOwner(), m_clipboardSeqNum(0)
+Server::ClipboardInfo::ClipboardInfo()
+    : m_clipboard(),
+      m_clipboardGeneration(0),
+      m_clipboardOwner(ScreenNames::kNoScreen),
+      m_clipboardSeqNum(0)
 {
-  // do nothing
+  // text is read as soon as the clipboard changes.  other formats are
+  // only read when a client asks for them.
+  m_clipboard.setDeferrableFormats(IClipboard::kAllFormats & ~(1u << IClipboard::kText));
 }
 
 //
@@ -2220,6 +2413,27 @@ bool Server::isClientMode() const
   return m_args.m_config->isClientMode();
 }
 
+ServerMotionChannel *Server::getMotionChannel() const
+{
+  if (!m_enableMotionChannel || m_clientListener == nullptr) {
+    return nullptr;
+  }
+  return m_clientListener->getMotionChannel();
+}
+
+HeartbeatTicker *Server::getHeartbeatTicker() const
+{
+  return m_heartbeatTicker.get();
+}
+
+void Server::setListener(ClientListener *p)
+{
+  m_clientListener = p;
+  if (m_clientListener != nullptr) {
+    m_clientListener->setMaxHandshakes(m_maxHandshakes);
+  }
+}
+
 void Server::sendFileToClient(const char *filename)
 {
   if (m_sendFileThread != NULL) {
@@ -32,6 +32,7 @@
 #include "deskflow/key_types.h"
 #include "deskflow/mouse_types.h"
 #include "server/Config.h"
+#include "server/HeartbeatTicker.h"
 #include <memory>
 
 class BaseClientProxy;
@@ -44,6 +45,7 @@ class Screen;
 class IEventQueue;
 class Thread;
 class ClientListener;
+class ServerMotionChannel;
 
 //! Deskflow server
 /*!
@@ -96,11 +98,12 @@ public:
   class ScreenConnectedInfo
   {
   public:
-    ScreenConnectedInfo(String screen) : m_screen(screen)
+    ScreenConnectedInfo(ScreenID id, const String &screen) : m_id(id), m_screen(screen)
     {
     }
 
   public:
+    ScreenID m_id;
     String m_screen; // was char[1]
   };
 
@@ -183,10 +186,18 @@ public:
   void dragInfoReceived(UInt32 fileNum, String content);
 
   //! Store ClientListener pointer
-  void setListener(ClientListener *p)
-  {
-    m_clientListener = p;
-  }
+  /*!
+  Also gives the listener the options that apply to it.
+  */
+  void setListener(ClientListener *p);
+
+  //! Fetch clipboard formats
+  /*!
+  Reads the deferred formats in \p formats of clipboard \p id from
+  the screen that owns it and returns the clipboard.  Formats over the
+  maximum clipboard size stay deferred.
+  */
+  const Clipboard &fetchClipboard(ClipboardID id, UInt32 formats);
 
   //@}
   //! @name accessors
@@ -228,11 +239,28 @@ public:
   //! Returns true if it's client mode and server initiates connection
   bool isClientMode() const;
 
+  //! Get the motion channel
+  /*!
+  Returns the UDP motion channel to offer clients, or NULL if the
+  \c udpMotion option is off or the channel can't be opened.
+  */
+  ServerMotionChannel *getMotionChannel() const;
+
+  //! Get the heartbeat ticker
+  /*!
+  Returns the ticker that checks the heartbeats of the client proxies.
+  */
+  HeartbeatTicker *getHeartbeatTicker() const;
+
   //@}
 
 private:
   // get canonical name of client
-  String getName(const BaseClientProxy *) const;
+  const String &getName(const BaseClientProxy *) const;
+
+  // send a clipboard to the active screen, reading any deferred formats
+  // first if the active screen can't ask for them
+  void sendClipboard(ClipboardID id);
 
   // get the sides of the primary screen that have neighbors
   UInt32 getActivePrimarySides() const;
@@ -325,11 +353,24 @@ private:
   // stop relative mouse moves
   void stopRelativeMoves();
 
+  // send the clipboards to the active screen shortly, replacing any
+  // transfer that hasn't been sent yet
+  void startClipboardTransfer();
+
+  // cancel the pending clipboard transfer
+  void stopClipboardTransfer();
+
+  // send the pending clipboard transfer now, if there is one
+  void flushClipboardTransfer();
+
+  // get the screen options for \c client
+  void getClientOptions(BaseClientProxy *client, OptionsList &options) const;
+
   // send screen options to \c client
   void sendOptions(BaseClientProxy *client) const;
 
-  // process options from configuration
-  void processOptions();
+  // process the global options from \c config
+  void processOptions(const ServerConfig &config);
 
   // event handlers
   void handleShapeChanged(const Event &, void *);
@@ -346,6 +387,7 @@ private:
   void handleScreensaverActivatedEvent(const Event &, void *);
   void handleScreensaverDeactivatedEvent(const Event &, void *);
   void handleSwitchWaitTimeout(const Event &, void *);
+  void handleClipboardTransferTimeout(const Event &, void *);
   void handleClientDisconnected(const Event &, void *);
   void handleClientCloseTimeout(const Event &, void *);
   void handleSwitchToScreenEvent(const Event &, void *);
@@ -357,6 +399,11 @@ private:
   void handleFileChunkSendingEvent(const Event &, void *);
   void handleFileRecieveCompletedEvent(const Event &, void *);
 
+  // get the clients a key goes to when it's not just for the active
+  // screen.  the list is only built once for each screens list.
+  typedef std::vector<BaseClientProxy *> KeyTargets;
+  const KeyTargets &getKeyTargets(const char *screens);
+
   // event processing
   void onClipboardChanged(BaseClientProxy *sender, ClipboardID id, UInt32 seqNum);
   void onScreensaver(bool activated);
@@ -417,16 +464,16 @@ private:
 
   public:
     Clipboard m_clipboard;
-    String m_clipboardData;
-    String m_clipboardOwner;
+    UInt32 m_clipboardGeneration;
+    ScreenID m_clipboardOwner;
     UInt32 m_clipboardSeqNum;
   };
 
   // the primary screen client
   PrimaryClient *m_primaryClient;
 
-  // all clients (including the primary client) indexed by name
-  typedef std::map<String, BaseClientProxy *> ClientList;
+  // all clients (including the primary client) indexed by screen id
+  typedef std::map<ScreenID, BaseClientProxy *> ClientList;
   typedef std::set<BaseClientProxy *> ClientSet;
   ClientList m_clients;
   ClientSet m_clientSet;
@@ -475,6 +522,11 @@ private:
   EventQueueTimer *m_switchWaitTimer;
   SInt32 m_switchWaitX, m_switchWaitY;
 
+  // state for sending the clipboards after a switch.  the primary's
+  // clipboards are read when the transfer is sent, not when leaving it.
+  EventQueueTimer *m_clipboardTransferTimer;
+  bool m_clipboardTransferFromPrimary;
+
   // state for double-tap screen switching
   double m_switchTwoTapDelay;
   Stopwatch m_switchTwoTapTimer;
@@ -495,6 +547,10 @@ private:
   bool m_keyboardBroadcasting;
   String m_keyboardBroadcastingScreens;
 
+  // clients keys go to, for each screens list.  cleared when the clients
+  // or their names change.
+  std::map<String, KeyTargets, std::less<>> m_keyTargets;
+
   // screen locking (former scroll lock)
   bool m_lockedToScreen;
 
@@ -515,11 +571,16 @@ private:
   bool m_ignoreFileTransfer;
   bool m_disableLockToScreen;
   bool m_enableClipboard;
+  bool m_enableMotionChannel;
   size_t m_maximumClipboardSize;
+  int m_maxHandshakes;
 
   AutoThread m_sendDragInfoThread;
   bool m_waitDragInfoThread;
 
   ClientListener *m_clientListener;
   deskflow::ServerArgs m_args;
+
+  // checks the heartbeats of the client proxies
+  std::unique_ptr<HeartbeatTicker> m_heartbeatTicker;
 };
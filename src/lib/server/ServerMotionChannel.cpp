@@ -0,0 +1,207 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "server/ServerMotionChannel.h"
+
+#include "arch/Arch.h"
+#include "base/IEventQueue.h"
+#include "base/Log.h"
+#include "base/TMethodEventJob.h"
+#include "base/XBase.h"
+#include "deskflow/MotionDatagram.h"
+#include "net/DatagramSocket.h"
+#include "net/ISocketFactory.h"
+
+namespace {
+
+// datagrams read per event, so a flood can't starve the event queue
+const int kMaxDatagramsPerEvent = 64;
+
+// how many registration periods a channel is used for after the last
+// registration.  the extra half is for jitter, so a channel stops being
+// used as soon as one registration is missed.
+const double kRegistrationPeriods = 1.5;
+
+} // namespace
+
+//
+// ServerMotionChannel
+//
+
+ServerMotionChannel::ServerMotionChannel(
+    IEventQueue *events, ISocketFactory *socketFactory, const NetworkAddress &address, double rate
+)
+    : m_events(events),
+      m_socketFactory(socketFactory),
+      m_address(address),
+      m_rate(rate),
+      m_port(address.getPort()),
+      m_nextChannel(1)
+{
+  if (!ARCH->isAnyAddr(m_address.getAddress())) {
+    bindSocket(m_address);
+  }
+}
+
+ServerMotionChannel::~ServerMotionChannel()
+{
+  for (Sockets::iterator index = m_sockets.begin(); index != m_sockets.end(); ++index) {
+    m_events->removeHandler(m_events->forIStream().inputReady(), index->second->getEventTarget());
+    delete index->second;
+  }
+}
+
+UInt32 ServerMotionChannel::open(String &key, const NetworkAddress &local)
+{
+  DatagramSocket *socket = getSocket(local);
+  if (socket == nullptr) {
+    return 0;
+  }
+
+  key = MotionDatagram::newKey();
+  if (key.empty()) {
+    LOG((CLOG_WARN "failed to generate motion channel key"));
+    return 0;
+  }
+
+  UInt32 channel = m_nextChannel++;
+  if (m_nextChannel == 0) {
+    m_nextChannel = 1;
+  }
+  Peer &peer = m_peers[channel];
+  peer.m_key = key;
+  peer.m_socket = socket;
+  return channel;
+}
+
+void ServerMotionChannel::close(UInt32 channel)
+{
+  m_peers.erase(channel);
+}
+
+bool ServerMotionChannel::send(const MotionDatagram &motion)
+{
+  auto it = m_peers.find(motion.m_channel);
+  if (it == m_peers.end() || !it->second.m_address.isValid()) {
+    return false;
+  }
+
+  String datagram = motion.seal(it->second.m_key, true);
+  return !datagram.empty() && it->second.m_socket->writeTo(datagram, it->second.m_address);
+}
+
+bool ServerMotionChannel::isRegistered(UInt32 channel) const
+{
+  auto it = m_peers.find(channel);
+  return it != m_peers.end() && it->second.m_address.isValid() &&
+         ARCH->time() - it->second.m_registered < m_rate * kRegistrationPeriods;
+}
+
+DatagramSocket *ServerMotionChannel::getSocket(const NetworkAddress &local)
+{
+  // a socket bound to the wildcard address sends from whichever address
+  // the routing table picks, so bind to the one the client connected to
+  NetworkAddress address = m_address;
+  if (ARCH->isAnyAddr(m_address.getAddress())) {
+    if (!local.isValid()) {
+      return nullptr;
+    }
+    ArchNetAddress localAddress = ARCH->copyAddr(local.getAddress());
+    ARCH->setAddrPort(localAddress, m_port);
+    address = NetworkAddress(localAddress);
+  }
+
+  Sockets::iterator index = m_sockets.find(address.getHostname());
+  if (index != m_sockets.end()) {
+    return index->second;
+  }
+
+  try {
+    return bindSocket(address);
+  } catch (XBase &e) {
+    LOG((CLOG_WARN "cannot bind motion channel to %s: %s", address.getHostname().c_str(), e.what()));
+    return nullptr;
+  }
+}
+
+DatagramSocket *ServerMotionChannel::bindSocket(const NetworkAddress &address)
+{
+  DatagramSocket *socket = m_socketFactory->createDatagram(ARCH->getAddrFamily(address.getAddress()));
+  try {
+    socket->bind(address);
+  } catch (...) {
+    delete socket;
+    throw;
+  }
+
+  // a listen port of 0 picks any port, use the same one from now on
+  if (m_port == 0) {
+    m_port = socket->getLocalAddress().getPort();
+  }
+
+  m_sockets[address.getHostname()] = socket;
+  m_events->adoptHandler(
+      m_events->forIStream().inputReady(), socket->getEventTarget(),
+      new TMethodEventJob<ServerMotionChannel>(this, &ServerMotionChannel::handleDatagrams, socket)
+  );
+  LOG((CLOG_DEBUG "motion channel bound to %s port %d", address.getHostname().c_str(), m_port));
+  return socket;
+}
+
+void ServerMotionChannel::handleDatagrams(const Event &, void *vsocket)
+{
+  DatagramSocket *socket = static_cast<DatagramSocket *>(vsocket);
+  String datagram;
+  NetworkAddress sender;
+  for (int i = 0; i < kMaxDatagramsPerEvent; ++i) {
+    if (!socket->read(datagram, &sender)) {
+      return;
+    }
+
+    UInt32 channel;
+    if (!MotionDatagram::peekChannel(datagram, channel)) {
+      continue;
+    }
+    auto it = m_peers.find(channel);
+    if (it == m_peers.end()) {
+      continue;
+    }
+
+    // registrations must be newer than the last, so a replayed one can't
+    // redirect the channel
+    Peer &peer = it->second;
+    MotionDatagram registration;
+    if (!registration.open(datagram, peer.m_key, false) || registration.m_kind != MotionDatagram::kRegister ||
+        (peer.m_address.isValid() && registration.m_seq <= peer.m_seq)) {
+      LOG((CLOG_DEBUG2 "ignoring motion datagram for channel %d from %s", channel, sender.getHostname().c_str()));
+      continue;
+    }
+
+    if (!peer.m_address.isValid() || peer.m_address != sender) {
+      LOG(
+          (CLOG_DEBUG "motion channel %d registered from %s:%d", channel, sender.getHostname().c_str(),
+           sender.getPort())
+      );
+    }
+    peer.m_address = sender;
+    peer.m_seq = registration.m_seq;
+    peer.m_registered = ARCH->time();
+  }
+
+  // come back for the rest after other events have been handled
+  m_events->addEvent(Event(m_events->forIStream().inputReady(), socket->getEventTarget()));
+}
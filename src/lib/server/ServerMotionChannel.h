@@ -0,0 +1,129 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "base/String.h"
+#include "common/basic_types.h"
+#include "net/NetworkAddress.h"
+
+#include <map>
+
+class DatagramSocket;
+class Event;
+class IEventQueue;
+class ISocketFactory;
+class MotionDatagram;
+
+//! Server side of the UDP motion channel
+/*!
+Owns the UDP sockets that mouse motion is sent to clients on, on the
+same port as the listen socket.  Each client proxy opens a channel with
+its own key and offers it to its client, which then registers the
+address to send motion to.  A channel is only used while registrations
+keep arriving, so if UDP is blocked between the two, or stops working,
+the proxy sends motion over TCP.
+
+Clients only accept motion from the address they connected to.  When
+the server listens on the wildcard address, a host with several
+addresses could send from a different one, so a socket is bound to each
+address that clients connect to.
+*/
+class ServerMotionChannel
+{
+public:
+  /*!
+  \p address is the listen address.  Clients are expected to register
+  every \p rate seconds.  If \p address isn't the wildcard address then
+  a UDP socket is bound to it straight away and \c XSocket is thrown on
+  failure.
+  */
+  ServerMotionChannel(IEventQueue *events, ISocketFactory *socketFactory, const NetworkAddress &address, double rate);
+  ServerMotionChannel(ServerMotionChannel const &) = delete;
+  ServerMotionChannel(ServerMotionChannel &&) = delete;
+  ~ServerMotionChannel();
+
+  ServerMotionChannel &operator=(ServerMotionChannel const &) = delete;
+  ServerMotionChannel &operator=(ServerMotionChannel &&) = delete;
+
+  //! @name manipulators
+  //@{
+
+  //! Open a channel
+  /*!
+  Opens a channel for a client that connected to \p local.  Returns the
+  id of the channel and its key in \p key, or 0 if a key can't be
+  generated or a socket can't be bound.
+  */
+  UInt32 open(String &key, const NetworkAddress &local);
+
+  //! Close a channel
+  void close(UInt32 channel);
+
+  //! Send motion
+  /*!
+  Sends \p motion to the address registered for its channel.  Returns
+  false if the datagram couldn't be sent.
+  */
+  bool send(const MotionDatagram &motion);
+
+  //@}
+  //! @name accessors
+  //@{
+
+  //! Test if a channel can be used
+  /*!
+  Returns true if the client's last registration arrived within about
+  one registration period, so a single missed registration is enough
+  to fall back to TCP.
+  */
+  bool isRegistered(UInt32 channel) const;
+
+  //! Get the UDP port
+  int getPort() const
+  {
+    return m_port;
+  }
+
+  //@}
+
+private:
+  struct Peer
+  {
+    String m_key;
+    DatagramSocket *m_socket = nullptr;
+    NetworkAddress m_address;
+    UInt32 m_seq = 0;
+    double m_registered = 0.0;
+  };
+
+  typedef std::map<String, DatagramSocket *> Sockets;
+
+  DatagramSocket *getSocket(const NetworkAddress &local);
+  DatagramSocket *bindSocket(const NetworkAddress &address);
+  void handleDatagrams(const Event &, void *);
+
+private:
+  IEventQueue *m_events;
+  ISocketFactory *m_socketFactory;
+  NetworkAddress m_address;
+  double m_rate;
+  int m_port;
+  UInt32 m_nextChannel;
+  Sockets m_sockets;
+  std::map<UInt32, Peer> m_peers;
+};
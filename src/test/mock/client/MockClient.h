@@ -0,0 +1,38 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#define TEST_ENV
+
+#include "client/Client.h"
+
+#include <gmock/gmock.h>
+
+class MockClient : public Client
+{
+public:
+  MockClient() : Client()
+  {
+  }
+  MOCK_METHOD(void, getShape, (SInt32 &, SInt32 &, SInt32 &, SInt32 &), (const, override));
+  MOCK_METHOD(void, getCursorPos, (SInt32 &, SInt32 &), (const, override));
+  MOCK_METHOD(void, mouseMove, (SInt32, SInt32), (override));
+  MOCK_METHOD(void, mouseDown, (ButtonID), (override));
+  MOCK_METHOD(void, setOptions, (const OptionsList &), (override));
+  MOCK_METHOD(void, handshakeComplete, (), (override));
+};
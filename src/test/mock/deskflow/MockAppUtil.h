@@ -0,0 +1,36 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "deskflow/AppUtil.h"
+
+#include <gmock/gmock.h>
+
+class MockAppUtil : public AppUtil
+{
+public:
+  MockAppUtil()
+  {
+  }
+
+  MOCK_METHOD(int, run, (int, char **), (override));
+  MOCK_METHOD(void, startNode, (), (override));
+  MOCK_METHOD(std::vector<String>, getKeyboardLayoutList, (), (override));
+  MOCK_METHOD(String, getCurrentLanguageCode, (), (override));
+  MOCK_METHOD(void, showNotification, (const String &, const String &), (const, override));
+};
@@ -0,0 +1,53 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "net/IDataSocket.h"
+#include "net/NetworkAddress.h"
+
+#include <gmock/gmock.h>
+
+class MockDataSocket : public IDataSocket
+{
+public:
+  MockDataSocket() : IDataSocket(NULL)
+  {
+  }
+  ~MockDataSocket() override
+  {
+    destroyed();
+  }
+  MOCK_METHOD(void, destroyed, ());
+  MOCK_METHOD(void, connect, (const NetworkAddress &), (override));
+  MOCK_METHOD(NetworkAddress, getLocalAddress, (), (const, override));
+  MOCK_METHOD(void, bind, (const NetworkAddress &), (override));
+  MOCK_METHOD(void, close, (), (override));
+  MOCK_METHOD(UInt32, read, (void *, UInt32), (override));
+  MOCK_METHOD(void, write, (const void *, UInt32), (override));
+  MOCK_METHOD(void, flush, (), (override));
+  MOCK_METHOD(void, shutdownInput, (), (override));
+  MOCK_METHOD(void, shutdownOutput, (), (override));
+  MOCK_METHOD(bool, isReady, (), (const, override));
+  MOCK_METHOD(bool, isFatal, (), (const, override));
+  MOCK_METHOD(UInt32, getSize, (), (const, override));
+
+  void *getEventTarget() const override
+  {
+    return const_cast<MockDataSocket *>(this);
+  }
+};
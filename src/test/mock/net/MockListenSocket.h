@@ -0,0 +1,36 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "net/IListenSocket.h"
+#include "net/NetworkAddress.h"
+
+#include <gmock/gmock.h>
+
+class MockListenSocket : public IListenSocket
+{
+public:
+  MOCK_METHOD(IDataSocket *, accept, (String *), (override));
+  MOCK_METHOD(void, bind, (const NetworkAddress &), (override));
+  MOCK_METHOD(void, close, (), (override));
+
+  void *getEventTarget() const override
+  {
+    return const_cast<MockListenSocket *>(this);
+  }
+};
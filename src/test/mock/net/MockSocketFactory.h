@@ -0,0 +1,30 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "net/ISocketFactory.h"
+
+#include <gmock/gmock.h>
+
+class MockSocketFactory : public ISocketFactory
+{
+public:
+  MOCK_METHOD(IDataSocket *, create, (bool, IArchNetwork::EAddressFamily), (const, override));
+  MOCK_METHOD(IListenSocket *, createListen, (bool, IArchNetwork::EAddressFamily), (const, override));
+  MOCK_METHOD(DatagramSocket *, createDatagram, (IArchNetwork::EAddressFamily), (const, override));
+};
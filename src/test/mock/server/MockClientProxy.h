@@ -0,0 +1,56 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2013-2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#define TEST_ENV
+
+#include "base/String.h"
+#include "server/ClientProxy.h"
+
+#include <gmock/gmock.h>
+
+class MockClientProxy : public ClientProxy
+{
+public:
+  MockClientProxy(const String &name, deskflow::IStream *adoptedStream) : ClientProxy(name, adoptedStream)
+  {
+  }
+  MOCK_METHOD(bool, getClipboard, (ClipboardID, IClipboard *), (const, override));
+  MOCK_METHOD(void, getShape, (SInt32 &, SInt32 &, SInt32 &, SInt32 &), (const, override));
+  MOCK_METHOD(void, getCursorPos, (SInt32 &, SInt32 &), (const, override));
+  MOCK_METHOD(void, enter, (SInt32, SInt32, UInt32, KeyModifierMask, bool), (override));
+  MOCK_METHOD(bool, leave, (), (override));
+  MOCK_METHOD(void, setClipboard, (ClipboardID, const IClipboard *), (override));
+  MOCK_METHOD(void, grabClipboard, (ClipboardID), (override));
+  MOCK_METHOD(void, setClipboardDirty, (ClipboardID, bool), (override));
+  MOCK_METHOD(void, keyDown, (KeyID, KeyModifierMask, KeyButton, const String &), (override));
+  MOCK_METHOD(void, keyRepeat, (KeyID, KeyModifierMask, SInt32, KeyButton, const String &), (override));
+  MOCK_METHOD(void, keyUp, (KeyID, KeyModifierMask, KeyButton), (override));
+  MOCK_METHOD(void, mouseDown, (ButtonID), (override));
+  MOCK_METHOD(void, mouseUp, (ButtonID), (override));
+  MOCK_METHOD(void, mouseMove, (SInt32, SInt32), (override));
+  MOCK_METHOD(void, mouseRelativeMove, (SInt32, SInt32), (override));
+  MOCK_METHOD(void, mouseWheel, (SInt32, SInt32), (override));
+  MOCK_METHOD(void, screensaver, (bool), (override));
+  MOCK_METHOD(void, resetOptions, (), (override));
+  MOCK_METHOD(void, setOptions, (const OptionsList &), (override));
+  MOCK_METHOD(void, sendDragInfo, (UInt32, const char *, size_t), (override));
+  MOCK_METHOD(void, fileChunkSending, (UInt8, char *, size_t), (override));
+  MOCK_METHOD(String, getSecureInputApp, (), (const, override));
+  MOCK_METHOD(void, secureInputNotification, (const String &), (const, override));
+};
@@ -27,8 +27,15 @@
 class MockPrimaryClient : public PrimaryClient
 {
 public:
+  explicit MockPrimaryClient(const String &name = "") : PrimaryClient(name)
+  {
+  }
   MOCK_METHOD(void *, getEventTarget, (), (const, override));
   MOCK_METHOD(void, getCursorPos, (SInt32 &, SInt32 &), (const, override));
+  MOCK_METHOD(void, getShape, (SInt32 &, SInt32 &, SInt32 &, SInt32 &), (const, override));
+  MOCK_METHOD(bool, getClipboard, (ClipboardID, IClipboard *), (const, override));
+  MOCK_METHOD(void, enter, (SInt32, SInt32, UInt32, KeyModifierMask, bool), (override));
+  MOCK_METHOD(bool, leave, (), (override));
   MOCK_METHOD(void, setJumpCursorPos, (SInt32, SInt32), (const));
   MOCK_METHOD(void, reconfigure, (UInt32), (override));
   MOCK_METHOD(void, resetOptions, (), (override));
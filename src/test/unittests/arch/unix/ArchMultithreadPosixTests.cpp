@@ -0,0 +1,108 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "arch/Arch.h"
+
+#include <atomic>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+struct WaitState
+{
+  ArchMutex m_mutex = ARCH->newMutex();
+  ArchCond m_cond = ARCH->newCondVar();
+  std::atomic<int> m_wakeups{0};
+
+  ~WaitState()
+  {
+    ARCH->closeCondVar(m_cond);
+    ARCH->closeMutex(m_mutex);
+  }
+};
+
+void *waitForever(void *data)
+{
+  auto state = static_cast<WaitState *>(data);
+  ArchMutexLock lock(state->m_mutex);
+  for (;;) {
+    ARCH->waitCondVar(state->m_cond, state->m_mutex, -1.0);
+    ++state->m_wakeups;
+  }
+  return nullptr;
+}
+
+void *getCurrentThread(void *)
+{
+  return ARCH->newCurrentThread();
+}
+
+} // namespace
+
+TEST(ArchMultithreadPosixTests, waitCondVar_noTimeout_noWakeupsUntilCancelled)
+{
+  WaitState state;
+  ArchThread thread = ARCH->newThread(&waitForever, &state);
+
+  ARCH->sleep(0.3);
+  ARCH->cancelThread(thread);
+
+  EXPECT_TRUE(ARCH->wait(thread, 1.0));
+  EXPECT_EQ(0, state.m_wakeups);
+  ARCH->closeThread(thread);
+}
+
+TEST(ArchMultithreadPosixTests, cancelThread_callerOwnsMutex_waiterCancelled)
+{
+  WaitState state;
+  ArchThread thread = ARCH->newThread(&waitForever, &state);
+  ARCH->sleep(0.05);
+
+  {
+    ArchMutexLock lock(state.m_mutex);
+    ARCH->cancelThread(thread);
+  }
+
+  EXPECT_TRUE(ARCH->wait(thread, 1.0));
+  ARCH->closeThread(thread);
+}
+
+TEST(ArchMultithreadPosixTests, cancelThread_waitStarting_waiterCancelled)
+{
+  // cancel while the thread is on its way into the wait
+  for (int i = 0; i < 20; ++i) {
+    WaitState state;
+    ArchThread thread = ARCH->newThread(&waitForever, &state);
+    ARCH->cancelThread(thread);
+
+    EXPECT_TRUE(ARCH->wait(thread, 1.0));
+    ARCH->closeThread(thread);
+  }
+}
+
+TEST(ArchMultithreadPosixTests, newCurrentThread_newThread_sameAsCreatedThread)
+{
+  ArchThread thread = ARCH->newThread(&getCurrentThread, nullptr);
+  ASSERT_TRUE(ARCH->wait(thread, 1.0));
+
+  auto current = static_cast<ArchThread>(ARCH->getResultOfThread(thread));
+
+  EXPECT_TRUE(ARCH->isSameThread(thread, current));
+  ARCH->closeThread(current);
+  ARCH->closeThread(thread);
+}
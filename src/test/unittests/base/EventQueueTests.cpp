@@ -0,0 +1,73 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/EventQueue.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+// returns the timer of the next timer event, or NULL if there is none
+EventQueueTimer *getTimerEvent(EventQueue &events, double timeout)
+{
+  Event event;
+  if (!events.getEvent(event, timeout) || event.getType() != Event::kTimer) {
+    return NULL;
+  }
+  return static_cast<IEventQueue::TimerEvent *>(event.getData())->m_timer;
+}
+
+} // namespace
+
+TEST(EventQueueTests, deleteTimer_middleOfMany_othersExpireInOrder)
+{
+  EventQueue events;
+  std::vector<EventQueueTimer *> timers;
+  for (int i = 0; i < 8; ++i) {
+    timers.push_back(events.newOneShotTimer(0.01 * (8 - i), NULL));
+  }
+
+  events.deleteTimer(timers[3]);
+  events.deleteTimer(timers[6]);
+
+  for (int i = 7; i >= 0; --i) {
+    if (i == 3 || i == 6) {
+      continue;
+    }
+    EXPECT_EQ(timers[i], getTimerEvent(events, 1.0));
+  }
+  EXPECT_EQ(nullptr, getTimerEvent(events, 0.1));
+  for (int i = 0; i < 8; ++i) {
+    if (i != 3 && i != 6) {
+      events.deleteTimer(timers[i]);
+    }
+  }
+}
+
+TEST(EventQueueTests, newTimer_expiredBeforeOtherTimer_rescheduled)
+{
+  EventQueue events;
+  EventQueueTimer *repeating = events.newTimer(0.01, NULL);
+  EventQueueTimer *oneShot = events.newOneShotTimer(10.0, NULL);
+
+  EXPECT_EQ(repeating, getTimerEvent(events, 1.0));
+  EXPECT_EQ(repeating, getTimerEvent(events, 1.0));
+  EXPECT_EQ(repeating, getTimerEvent(events, 1.0));
+
+  events.deleteTimer(repeating);
+  events.deleteTimer(oneShot);
+}
@@ -0,0 +1,127 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/log_outputters.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#if SYSAPI_UNIX
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <gtest/gtest.h>
+
+namespace {
+
+const std::string kTestLogFile = "tmp/test/file_log_outputter.log";
+
+std::string readFile(const std::string &filename)
+{
+  std::ifstream file(filename);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+} // namespace
+
+TEST(FileLogOutputterTests, write_thenFlush_linesInFile)
+{
+  remove(kTestLogFile.c_str());
+  FileLogOutputter outputter(kTestLogFile.c_str());
+  outputter.startWriter();
+
+  outputter.write(kINFO, "line 1");
+  outputter.write(kDEBUG, "line 2");
+  outputter.flush();
+
+  EXPECT_EQ("line 1\nline 2\n", readFile(kTestLogFile));
+}
+
+TEST(FileLogOutputterTests, write_thenClose_linesInFile)
+{
+  remove(kTestLogFile.c_str());
+  FileLogOutputter outputter(kTestLogFile.c_str());
+  outputter.startWriter();
+
+  outputter.write(kINFO, "line 1");
+  outputter.close();
+
+  EXPECT_EQ("line 1\n", readFile(kTestLogFile));
+}
+
+TEST(FileLogOutputterTests, write_errorLevel_flushedImmediately)
+{
+  remove(kTestLogFile.c_str());
+  FileLogOutputter outputter(kTestLogFile.c_str());
+  outputter.startWriter();
+
+  outputter.write(kERROR, "error line");
+
+  EXPECT_EQ("error line\n", readFile(kTestLogFile));
+}
+
+TEST(FileLogOutputterTests, write_afterClose_writtenSynchronously)
+{
+  remove(kTestLogFile.c_str());
+  FileLogOutputter outputter(kTestLogFile.c_str());
+  outputter.startWriter();
+  outputter.close();
+
+  outputter.write(kINFO, "line 1");
+
+  EXPECT_EQ("line 1\n", readFile(kTestLogFile));
+}
+
+TEST(FileLogOutputterTests, write_writerNotStarted_writtenSynchronously)
+{
+  remove(kTestLogFile.c_str());
+  FileLogOutputter outputter(kTestLogFile.c_str());
+
+  outputter.write(kINFO, "line 1");
+
+  EXPECT_EQ("line 1\n", readFile(kTestLogFile));
+}
+
+#if SYSAPI_UNIX
+
+TEST(FileLogOutputterTests, write_writerStartedAfterFork_linesInFile)
+{
+  remove(kTestLogFile.c_str());
+  FileLogOutputter outputter(kTestLogFile.c_str());
+  outputter.write(kINFO, "before fork");
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    // as a daemon would, and without running the parent's atexit handlers
+    outputter.startWriter();
+    outputter.write(kINFO, "after fork");
+    outputter.close();
+    _exit(0);
+  }
+  ASSERT_GT(pid, 0);
+  int status = 0;
+  waitpid(pid, &status, 0);
+
+  EXPECT_TRUE(WIFEXITED(status));
+  EXPECT_EQ("before fork\nafter fork\n", readFile(kTestLogFile));
+}
+
+#endif
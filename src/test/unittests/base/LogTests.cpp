@@ -1,9 +1,13 @@
+#include "base/ILogOutputter.h"
 #include "base/Log.h"
 
 #include "gmock/gmock-matchers.h"
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <string>
+#include <vector>
+
 #define LEVEL_PRINT "%z\057"
 #define LEVEL_ERR "%z\061"
 #define LEVEL_INFO "%z\064"
@@ -15,6 +19,40 @@ using testing::internal::CaptureStdout;
 using testing::internal::GetCapturedStderr;
 using testing::internal::GetCapturedStdout;
 
+namespace {
+
+// logs to another log before recording each message it's given
+class NestingOutputter : public ILogOutputter
+{
+public:
+  explicit NestingOutputter(Log *nested) : m_nested(nested)
+  {
+  }
+
+  void open(const char *) override
+  {
+  }
+  void close() override
+  {
+  }
+  void show(bool) override
+  {
+  }
+  bool write(ELevel, const char *message) override
+  {
+    m_nested->print(nullptr, 0, LEVEL_PRINT "nested message");
+    m_messages.push_back(message);
+    return true;
+  }
+
+  std::vector<std::string> m_messages;
+
+private:
+  Log *m_nested;
+};
+
+} // namespace
+
 TEST(LogTests, print_withErrorLevel_outputIsValid)
 {
   CaptureStderr();
@@ -95,3 +133,30 @@ TEST(LogTests, print_errorWithFileAndLine_outputIsValid)
 
   EXPECT_THAT(GetCapturedStderr(), EndsWith("ERROR: test message\n\ttest file:123\n"));
 }
+
+TEST(LogTests, print_shortAfterLongMessage_outputIsValid)
+{
+  CaptureStdout();
+  Log log(false);
+
+  auto longString = std::string(10000, 'a');
+  log.print("test file", 123, LEVEL_INFO "%s", longString.c_str());
+  log.print("test file", 456, LEVEL_INFO "short message");
+
+  EXPECT_THAT(GetCapturedStdout(), EndsWith("INFO: short message\n\ttest file:456\n"));
+}
+
+TEST(LogTests, print_outputterLogsWhileWriting_messageNotOverwritten)
+{
+  CaptureStdout();
+  Log nested(false);
+  Log log(false);
+  auto outputter = new NestingOutputter(&nested);
+  log.insert(outputter);
+
+  log.print(nullptr, 0, LEVEL_PRINT "outer message");
+
+  GetCapturedStdout();
+  ASSERT_EQ(1, outputter->m_messages.size());
+  EXPECT_EQ("outer message", outputter->m_messages[0]);
+}
@@ -0,0 +1,141 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/Trace.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using testing::HasSubstr;
+
+namespace {
+
+const std::size_t kTestRecordsPerThread = 4;
+
+} // namespace
+
+class TraceTests : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_traceFile = (std::filesystem::temp_directory_path() / "deskflow-trace-tests.bin").string();
+  }
+
+  void TearDown() override
+  {
+    // tracing and its crash handlers are process wide
+    Trace::disable();
+    std::filesystem::remove(m_traceFile);
+  }
+
+  std::vector<TraceRecord> readTraceFile() const
+  {
+    std::vector<TraceRecord> records;
+    std::ifstream file(m_traceFile, std::ios::binary);
+    EXPECT_TRUE(Trace::read(file, records));
+    return records;
+  }
+
+  std::string m_traceFile;
+};
+
+TEST_F(TraceTests, record_moreThanCapacity_newestRecordsDumped)
+{
+  Trace::enable(m_traceFile, kTestRecordsPerThread);
+
+  for (int i = 0; i < 6; i++) {
+    TRACE(TraceEvent::kFakeMouseMove, i, i * 2);
+  }
+  ASSERT_TRUE(Trace::dump());
+
+  auto records = readTraceFile();
+  ASSERT_EQ(kTestRecordsPerThread, records.size());
+  for (std::size_t i = 0; i < records.size(); i++) {
+    EXPECT_EQ(static_cast<std::uint16_t>(TraceEvent::kFakeMouseMove), records[i].m_event);
+    EXPECT_EQ(static_cast<std::int32_t>(i + 2), records[i].m_args[0]);
+    EXPECT_EQ(static_cast<std::int32_t>((i + 2) * 2), records[i].m_args[1]);
+  }
+}
+
+TEST_F(TraceTests, disable_afterRecording_nothingRecordedOrDumped)
+{
+  Trace::enable(m_traceFile, kTestRecordsPerThread);
+  TRACE(TraceEvent::kFakeMouseMove, 1, 2);
+
+  Trace::disable();
+  TRACE(TraceEvent::kFakeMouseMove, 3, 4);
+
+  EXPECT_FALSE(Trace::isEnabled());
+  EXPECT_FALSE(Trace::dump());
+  Trace::enable(m_traceFile, kTestRecordsPerThread);
+  ASSERT_TRUE(Trace::dump());
+  EXPECT_TRUE(readTraceFile().empty());
+}
+
+TEST_F(TraceTests, trace_ifWithoutBraces_elseBindsToIf)
+{
+  bool trace = false;
+  bool traced = true;
+
+  if (trace)
+    TRACE(TraceEvent::kFakeMouseMove, 1, 2);
+  else
+    traced = false;
+
+  EXPECT_FALSE(traced);
+}
+
+TEST_F(TraceTests, writeText_record_eventNameAndArgs)
+{
+  TraceRecord record = {};
+  record.m_event = static_cast<std::uint16_t>(TraceEvent::kClientProxyMouseMove);
+  record.m_args[0] = 10;
+  record.m_args[1] = 20;
+  std::stringstream stream;
+
+  Trace::writeText(stream, {record});
+
+  EXPECT_THAT(stream.str(), HasSubstr("client-proxy-mouse-move 10 20 0 0\n"));
+}
+
+TEST_F(TraceTests, writeJson_record_eventNameAndArgs)
+{
+  TraceRecord record = {};
+  record.m_time = 123;
+  record.m_event = static_cast<std::uint16_t>(TraceEvent::kSocketWrite);
+  record.m_args[0] = 5;
+  std::stringstream stream;
+
+  Trace::writeJson(stream, {record});
+
+  EXPECT_EQ(
+      "[\n  {\"time\": 123, \"thread\": 0, \"event\": \"socket-write\", \"args\": [5, 0, 0, 0]}\n]\n", stream.str()
+  );
+}
+
+TEST_F(TraceTests, read_notTraceFile_returnsFalse)
+{
+  std::stringstream stream("not a trace file, but long enough for a header");
+  std::vector<TraceRecord> records;
+
+  EXPECT_FALSE(Trace::read(stream, records));
+}
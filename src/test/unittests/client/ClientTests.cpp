@@ -0,0 +1,201 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test/mock/deskflow/MockScreen.h"
+#include "test/mock/net/MockDataSocket.h"
+#include "test/mock/net/MockSocketFactory.h"
+
+#include "arch/Arch.h"
+#include "base/EventQueue.h"
+#include "base/Stopwatch.h"
+#include "client/Client.h"
+#include "mt/Thread.h"
+#include "net/NetworkAddress.h"
+
+#include <algorithm>
+#include <memory>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using testing::_;
+using testing::ElementsAre;
+using testing::Invoke;
+using testing::NiceMock;
+
+namespace {
+
+const int kPort = 24800;
+
+} // namespace
+
+// a client whose sockets never reach the network, so the test decides
+// which connection attempts succeed or fail
+class ClientConnectTests : public ::testing::Test
+{
+protected:
+  ClientConnectTests()
+  {
+    auto socketFactory = new NiceMock<MockSocketFactory>();
+    ON_CALL(*socketFactory, create(_, _)).WillByDefault(Invoke([this](bool, IArchNetwork::EAddressFamily) {
+      auto socket = new NiceMock<MockDataSocket>();
+      ON_CALL(*socket, connect(_)).WillByDefault(Invoke([this](const NetworkAddress &address) {
+        m_connected.push_back(ARCH->addrToString(address.getAddress()));
+      }));
+      ON_CALL(*socket, destroyed()).WillByDefault(Invoke([this, socket] {
+        m_sockets.erase(std::find(m_sockets.begin(), m_sockets.end(), socket));
+      }));
+      m_sockets.push_back(socket);
+      return socket;
+    }));
+
+    m_client.reset(new Client(&m_events, "stub", NetworkAddress("127.0.0.1", kPort), socketFactory, &m_screen, m_args));
+
+    // hold no events until the loop starts, like the apps do
+    m_events.addEvent(Event(Event::kQuit));
+    m_events.loop();
+  }
+
+  // starts resolving the server's hostname and returns the lookup's id
+  UInt32 connect()
+  {
+    m_client->connect();
+    return m_client->m_resolveId;
+  }
+
+  // delivers the result of lookup \p id as if it resolved to \p hosts
+  void resolved(UInt32 id, const std::vector<String> &hosts)
+  {
+    auto result = new Client::ResolveResult(id);
+    for (const auto &host : hosts) {
+      auto addresses = NetworkAddress(host, kPort).resolveAll();
+      result->m_addresses.insert(result->m_addresses.end(), addresses.begin(), addresses.end());
+    }
+
+    Event event(m_events.forClient().resolved(), m_client.get(), result);
+    m_client->handleResolved(event, NULL);
+    Event::deleteData(event);
+  }
+
+  size_t connectAttempts() const
+  {
+    return m_client->m_connectAttempts.size();
+  }
+
+  String connectedAddress() const
+  {
+    return ARCH->addrToString(m_client->m_connectedAddress.getAddress());
+  }
+
+  void connectionFailed(MockDataSocket *socket)
+  {
+    auto info = new IDataSocket::ConnectionFailedInfo("Connection refused");
+    m_events.addEvent(
+        Event(m_events.forIDataSocket().connectionFailed(), socket->getEventTarget(), info, Event::kDontFreeData)
+    );
+  }
+
+  void connected(MockDataSocket *socket)
+  {
+    m_events.addEvent(Event(m_events.forIDataSocket().connected(), socket->getEventTarget()));
+  }
+
+  // dispatches events until \p done returns true or \p timeout has passed
+  template <typename Done> void dispatchUntil(Done done, double timeout = 1.0)
+  {
+    Stopwatch stopwatch;
+    while (!done() && stopwatch.getTime() < timeout) {
+      Event event;
+      if (m_events.getEvent(event, 0.01)) {
+        m_events.dispatchEvent(event);
+        Event::deleteData(event);
+      }
+    }
+  }
+
+  EventQueue m_events;
+  NiceMock<MockScreen> m_screen;
+  deskflow::ClientArgs m_args;
+  std::vector<MockDataSocket *> m_sockets;
+  std::vector<String> m_connected;
+  std::unique_ptr<Client> m_client;
+};
+
+TEST_F(ClientConnectTests, handleResolved_mixedFamilies_triedAlternately)
+{
+  resolved(connect(), {"10.0.0.1", "10.0.0.2", "fd00::1", "fd00::2"});
+
+  // fail every attempt straight away so the next one starts
+  for (size_t attempts = 1; !m_sockets.empty(); ++attempts) {
+    ASSERT_EQ(attempts, m_connected.size());
+    connectionFailed(m_sockets.back());
+    dispatchUntil([this, attempts] { return m_connected.size() > attempts || m_sockets.empty(); });
+  }
+
+  EXPECT_THAT(m_connected, ElementsAre("10.0.0.1", "fd00::1", "10.0.0.2", "fd00::2"));
+}
+
+TEST_F(ClientConnectTests, handleResolved_firstAttemptSlow_nextAddressRaced)
+{
+  resolved(connect(), {"10.0.0.1", "10.0.0.2"});
+  EXPECT_EQ(1, m_sockets.size());
+
+  dispatchUntil([this] { return m_sockets.size() == 2; });
+
+  EXPECT_THAT(m_connected, ElementsAre("10.0.0.1", "10.0.0.2"));
+  EXPECT_EQ(2, connectAttempts());
+}
+
+TEST_F(ClientConnectTests, handleConnected_racingAttempts_othersAbandoned)
+{
+  resolved(connect(), {"10.0.0.1", "10.0.0.2", "10.0.0.3"});
+  dispatchUntil([this] { return m_sockets.size() == 3; });
+  MockDataSocket *winner = m_sockets[1];
+
+  connected(winner);
+  dispatchUntil([this] { return m_sockets.size() == 1; });
+
+  ASSERT_EQ(1, m_sockets.size());
+  EXPECT_EQ(winner, m_sockets.front());
+  EXPECT_EQ("10.0.0.2", connectedAddress());
+  EXPECT_EQ(0, connectAttempts());
+}
+
+TEST_F(ClientConnectTests, handleConnectionFailed_lastAttempt_noneLeft)
+{
+  resolved(connect(), {"10.0.0.1"});
+  ASSERT_EQ(1, m_sockets.size());
+
+  connectionFailed(m_sockets.front());
+  dispatchUntil([this] { return m_sockets.empty(); });
+
+  EXPECT_TRUE(m_sockets.empty());
+  EXPECT_EQ(0, connectAttempts());
+}
+
+TEST_F(ClientConnectTests, handleResolved_staleLookup_discarded)
+{
+  const UInt32 stale = connect();
+  m_client->disconnect(NULL);
+  const UInt32 current = connect();
+
+  resolved(stale, {"10.0.0.1"});
+  EXPECT_TRUE(m_connected.empty());
+
+  resolved(current, {"10.0.0.2"});
+  EXPECT_THAT(m_connected, ElementsAre("10.0.0.2"));
+}
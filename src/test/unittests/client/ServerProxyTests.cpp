@@ -0,0 +1,160 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test/mock/client/MockClient.h"
+#include "test/mock/deskflow/MockAppUtil.h"
+#include "test/mock/io/MockStream.h"
+
+#include "base/EventQueue.h"
+#include "client/ServerProxy.h"
+#include "deskflow/MotionDatagram.h"
+#include "deskflow/ProtocolUtil.h"
+#include "deskflow/protocol_types.h"
+#include "mt/Thread.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using testing::_;
+using testing::DoAll;
+using testing::InSequence;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+using testing::SetArgReferee;
+
+namespace {
+
+typedef std::vector<UInt8> Bytes;
+
+// a client that has just said hello back to the server
+class ServerProxyHandshakeTests : public ::testing::Test
+{
+protected:
+  ServerProxyHandshakeTests()
+  {
+    ON_CALL(m_stream, getEventTarget()).WillByDefault(Return(&m_stream));
+    ON_CALL(m_stream, write(_, _)).WillByDefault(Invoke([this](const void *data, UInt32 size) {
+      const UInt8 *bytes = static_cast<const UInt8 *>(data);
+      m_written.insert(m_written.end(), bytes, bytes + size);
+    }));
+    ON_CALL(m_stream, read(_, _)).WillByDefault(Invoke([this](void *data, UInt32 size) {
+      size = std::min(size, static_cast<UInt32>(m_input.size()));
+      if (data != NULL) {
+        memcpy(data, m_input.data(), size);
+      }
+      m_input.erase(m_input.begin(), m_input.begin() + size);
+      return size;
+    }));
+    ON_CALL(m_stream, getSize()).WillByDefault(Invoke([this] { return static_cast<UInt32>(m_input.size()); }));
+    ON_CALL(m_stream, isReady()).WillByDefault(Invoke([this] { return !m_input.empty(); }));
+
+    ON_CALL(m_client, getShape(_, _, _, _))
+        .WillByDefault(DoAll(SetArgReferee<0>(0), SetArgReferee<1>(0), SetArgReferee<2>(1920), SetArgReferee<3>(1080)));
+    ON_CALL(m_client, getCursorPos(_, _)).WillByDefault(DoAll(SetArgReferee<0>(960), SetArgReferee<1>(540)));
+    ProtocolUtil::formatf(m_info, kMsgDInfo, 0, 0, 1920, 1080, 0, 960, 540);
+  }
+
+  EventQueue m_events;
+  NiceMock<MockAppUtil> m_appUtil;
+  NiceMock<MockClient> m_client;
+  NiceMock<MockStream> m_stream;
+  Bytes m_written;
+  Bytes m_input;
+  Bytes m_info;
+};
+
+// a client that has finished the handshake and has a motion channel
+class ServerProxyMotionTests : public ServerProxyHandshakeTests
+{
+protected:
+  ServerProxyMotionTests() : m_proxy(&m_client, &m_stream, &m_events)
+  {
+    std::vector<UInt32> options;
+    ProtocolUtil::formatf(m_input, kMsgDSetOptions, &options);
+    m_proxy.handleDataForTest();
+  }
+
+  void fence(UInt32 seq, SInt32 x, SInt32 y)
+  {
+    ProtocolUtil::formatf(m_input, kMsgDMotionFence, seq, MotionDatagram::kAbsolute, x, y);
+  }
+
+  ServerProxy m_proxy;
+};
+
+} // namespace
+
+TEST_F(ServerProxyHandshakeTests, setProtocolVersion_server1_11_infoSent)
+{
+  ServerProxy proxy(&m_client, &m_stream, &m_events);
+
+  proxy.setProtocolVersion(1, 11);
+
+  EXPECT_EQ(m_info, m_written);
+}
+
+TEST_F(ServerProxyHandshakeTests, setProtocolVersion_server1_10_infoNotSent)
+{
+  ServerProxy proxy(&m_client, &m_stream, &m_events);
+
+  proxy.setProtocolVersion(1, 10);
+
+  EXPECT_TRUE(m_written.empty());
+}
+
+TEST_F(ServerProxyHandshakeTests, queryInfo_server1_10_infoSent)
+{
+  ServerProxy proxy(&m_client, &m_stream, &m_events);
+  proxy.setProtocolVersion(1, 10);
+  ProtocolUtil::formatf(m_input, kMsgQInfo);
+
+  proxy.handleDataForTest();
+
+  EXPECT_TRUE(m_input.empty());
+  EXPECT_EQ(m_info, m_written);
+}
+
+TEST_F(ServerProxyMotionTests, onMotion_sentAfterFence_heldUntilFenceRead)
+{
+  InSequence sequence;
+  EXPECT_CALL(m_client, mouseMove(10, 10));
+  EXPECT_CALL(m_client, mouseDown(kButtonLeft));
+  EXPECT_CALL(m_client, mouseMove(20, 20));
+  m_proxy.onMotion(MotionDatagram(1, 1, MotionDatagram::kAbsolute, 10, 10, 0));
+
+  // the datagram sent after the mouse down arrives before it
+  m_proxy.onMotion(MotionDatagram(1, 2, MotionDatagram::kAbsolute, 20, 20, 2));
+  fence(1, 10, 10);
+  ProtocolUtil::formatf(m_input, kMsgDMouseDown, static_cast<UInt8>(kButtonLeft));
+  fence(1, 10, 10);
+  m_proxy.handleDataForTest();
+
+  EXPECT_TRUE(m_input.empty());
+}
+
+TEST_F(ServerProxyMotionTests, onMotion_fenceAlreadyRead_applied)
+{
+  fence(0, 0, 0);
+  m_proxy.handleDataForTest();
+  EXPECT_CALL(m_client, mouseMove(20, 20));
+
+  m_proxy.onMotion(MotionDatagram(1, 1, MotionDatagram::kAbsolute, 20, 20, 1));
+}
@@ -0,0 +1,105 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "deskflow/Chunk.h"
+#include "deskflow/FileChunk.h"
+#include "deskflow/protocol_types.h"
+#include "test/mock/io/MockStream.h"
+
+#include <random>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using ::testing::_;
+using ::testing::Invoke;
+
+TEST(ChunkTests, compress_repetitiveText_decompressesToSameData)
+{
+  String data;
+  for (int i = 0; i < 1000; i++) {
+    data += "synergy rocks! ";
+  }
+  String compressed;
+  String decompressed;
+
+  ASSERT_TRUE(Chunk::compress(data, compressed));
+  ASSERT_TRUE(Chunk::decompress(compressed, decompressed));
+
+  EXPECT_LT(compressed.size(), data.size());
+  EXPECT_EQ(data, decompressed);
+}
+
+TEST(ChunkTests, compress_randomData_returnsFalse)
+{
+  std::mt19937 random(1);
+  String data(64 * 1024, '\0');
+  for (auto &c : data) {
+    c = static_cast<char>(random());
+  }
+  String compressed;
+
+  EXPECT_FALSE(Chunk::compress(data, compressed));
+}
+
+TEST(ChunkTests, compress_smallData_returnsFalse)
+{
+  String compressed;
+
+  EXPECT_FALSE(Chunk::compress("aaaaaaaaaaaaaaaa", compressed));
+}
+
+TEST(ChunkTests, decompress_truncatedData_returnsFalse)
+{
+  String data(4096, 'a');
+  String compressed;
+  String decompressed;
+  ASSERT_TRUE(Chunk::compress(data, compressed));
+
+  compressed.resize(compressed.size() / 2);
+
+  EXPECT_FALSE(Chunk::decompress(compressed, decompressed));
+}
+
+TEST(ChunkTests, fileChunkSend_otherTransferIncompressible_chunkCompressed)
+{
+  std::mt19937 random(1);
+  String noise(64 * 1024, '\0');
+  for (auto &c : noise) {
+    c = static_cast<char>(random());
+  }
+  String text(64 * 1024, 'a');
+  MockStream stream;
+  std::vector<UInt8> marks;
+  ON_CALL(stream, write(_, _)).WillByDefault(Invoke([&marks](const void *buffer, UInt32) {
+    // message code, then the mark
+    marks.push_back(static_cast<const UInt8 *>(buffer)[4]);
+  }));
+  EXPECT_CALL(stream, write(_, _)).Times(2);
+  FileChunk::Compression first;
+  FileChunk::Compression second;
+
+  FileChunk::send(&stream, kDataChunk, &noise[0], noise.size(), &first);
+  FileChunk::send(&stream, kDataChunk, &text[0], text.size(), &second);
+
+  ASSERT_EQ(2, marks.size());
+  EXPECT_EQ(kDataChunk, marks[0]);
+  EXPECT_TRUE(first.m_incompressible);
+  EXPECT_EQ(kDataChunkCompressed, marks[1]);
+  EXPECT_FALSE(second.m_incompressible);
+}
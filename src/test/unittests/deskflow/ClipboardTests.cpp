@@ -225,6 +225,22 @@ TEST(ClipboardTests, marshall_withTextSize285_sizeCharsValid)
   EXPECT_EQ(29, actual[11]); // 285 - 256 = 29
 }
 
+TEST(ClipboardTests, marshall_textChangedAfterMarshall_newSizeMarshalled)
+{
+  Clipboard clipboard;
+  clipboard.open(0);
+  clipboard.add(IClipboard::kText, "synergy rocks!");
+  clipboard.close();
+  clipboard.marshall();
+  clipboard.open(0);
+  clipboard.add(IClipboard::kText, "synergy");
+  clipboard.close();
+
+  String actual = clipboard.marshall();
+
+  EXPECT_EQ(7, (int)actual[11]);
+}
+
 TEST(ClipboardTests, marshall_withHtmlAdded_typeCharIsHtml)
 {
   Clipboard clipboard;
@@ -402,3 +418,268 @@ TEST(ClipboardTests, copy_withSingleText_clipboardsAreEqual)
   String actual = clipboard2.get(Clipboard::kText);
   EXPECT_EQ("synergy rocks!", actual);
 }
+
+TEST(ClipboardTests, getMarshalledSize_withTextAndHtml_sizeMatchesMarshall)
+{
+  Clipboard clipboard;
+  clipboard.open(0);
+  clipboard.add(IClipboard::kText, "synergy rocks!");
+  clipboard.add(IClipboard::kHTML, "html sucks");
+  clipboard.close();
+
+  size_t actual = clipboard.getMarshalledSize();
+
+  EXPECT_EQ(clipboard.marshall().size(), actual);
+}
+
+TEST(ClipboardTests, getDigest_sameData_digestsAreEqual)
+{
+  Clipboard clipboard1;
+  clipboard1.open(0);
+  clipboard1.add(IClipboard::kText, "synergy rocks!");
+  clipboard1.close();
+
+  Clipboard clipboard2;
+  Clipboard::copy(&clipboard2, &clipboard1);
+
+  EXPECT_EQ(clipboard1.getDigest(), clipboard2.getDigest());
+}
+
+TEST(ClipboardTests, getDigest_dataReplaced_digestChanged)
+{
+  Clipboard clipboard;
+  clipboard.open(0);
+  clipboard.add(IClipboard::kText, "synergy rocks!");
+  auto before = clipboard.getDigest();
+
+  clipboard.add(IClipboard::kText, "synergy rocks?");
+
+  EXPECT_NE(before, clipboard.getDigest());
+}
+
+TEST(ClipboardTests, getDigest_sameDataOtherFormat_digestChanged)
+{
+  Clipboard clipboard1;
+  clipboard1.open(0);
+  clipboard1.add(IClipboard::kText, "synergy rocks!");
+
+  Clipboard clipboard2;
+  clipboard2.open(0);
+  clipboard2.add(IClipboard::kHTML, "synergy rocks!");
+
+  EXPECT_NE(clipboard1.getDigest(), clipboard2.getDigest());
+}
+
+TEST(ClipboardTests, getGeneration_sameDataCopiedAgain_generationKept)
+{
+  Clipboard source;
+  source.open(0);
+  source.add(IClipboard::kText, "synergy rocks!");
+  source.close();
+  Clipboard clipboard;
+  Clipboard::copy(&clipboard, &source);
+  auto before = clipboard.getGeneration();
+
+  Clipboard::copy(&clipboard, &source);
+
+  EXPECT_EQ(before, clipboard.getGeneration());
+}
+
+TEST(ClipboardTests, getGeneration_dataChanged_generationChanged)
+{
+  Clipboard clipboard;
+  clipboard.open(0);
+  clipboard.add(IClipboard::kText, "synergy rocks!");
+  clipboard.close();
+  auto before = clipboard.getGeneration();
+
+  clipboard.open(0);
+  clipboard.empty();
+  clipboard.add(IClipboard::kText, "synergy rocks?");
+  clipboard.close();
+
+  EXPECT_NE(before, clipboard.getGeneration());
+}
+
+TEST(ClipboardTests, getGeneration_formatRemoved_generationChangedAndSizeUpdated)
+{
+  Clipboard clipboard;
+  clipboard.open(0);
+  clipboard.add(IClipboard::kText, "synergy rocks!");
+  clipboard.add(IClipboard::kHTML, "html sucks");
+  clipboard.close();
+  auto before = clipboard.getGeneration();
+
+  clipboard.open(0);
+  clipboard.empty();
+  clipboard.add(IClipboard::kText, "synergy rocks!");
+  clipboard.close();
+
+  EXPECT_NE(before, clipboard.getGeneration());
+  EXPECT_EQ(clipboard.marshall().size(), clipboard.getMarshalledSize());
+}
+
+TEST(ClipboardTests, marshall_textFormatOnly_htmlNotUnmarshalled)
+{
+  Clipboard clipboard1;
+  clipboard1.open(0);
+  clipboard1.add(IClipboard::kText, "synergy rocks!");
+  clipboard1.add(IClipboard::kHTML, "html sucks");
+  clipboard1.close();
+  String data = clipboard1.marshall(1u << IClipboard::kText);
+
+  Clipboard clipboard2;
+  clipboard2.unmarshall(data, 0);
+
+  clipboard2.open(0);
+  EXPECT_EQ("synergy rocks!", clipboard2.get(IClipboard::kText));
+  EXPECT_FALSE(clipboard2.has(IClipboard::kHTML));
+}
+
+TEST(ClipboardTests, getFormatInfo_withTextAndHtml_sizesAndHashesMatch)
+{
+  Clipboard clipboard;
+  clipboard.open(0);
+  clipboard.add(IClipboard::kText, "synergy rocks!");
+  clipboard.add(IClipboard::kHTML, "html sucks");
+  clipboard.close();
+
+  auto formats = clipboard.getFormatInfo();
+
+  ASSERT_EQ(2, formats.size());
+  EXPECT_EQ(IClipboard::kText, formats[0].m_format);
+  EXPECT_EQ(14, formats[0].m_size);
+  EXPECT_EQ(clipboard.getHash(IClipboard::kText), formats[0].m_hash);
+  EXPECT_EQ(IClipboard::kHTML, formats[1].m_format);
+  EXPECT_EQ(10, formats[1].m_size);
+  EXPECT_NE(formats[0].m_hash, formats[1].m_hash);
+}
+
+TEST(ClipboardTests, copy_sourceDefersFormat_formatDeferredAndNotMarshalled)
+{
+  Clipboard source;
+  source.setDeferrableFormats(IClipboard::kAllFormats);
+  source.open(0);
+  source.empty();
+  source.add(IClipboard::kText, "synergy rocks!");
+  source.addDeferred(IClipboard::kHTML, 1);
+  source.close();
+  Clipboard clipboard;
+  clipboard.setDeferrableFormats(1u << IClipboard::kHTML);
+
+  Clipboard::copy(&clipboard, &source);
+
+  clipboard.open(0);
+  EXPECT_TRUE(clipboard.has(IClipboard::kHTML));
+  EXPECT_TRUE(clipboard.isDeferred(IClipboard::kHTML));
+  EXPECT_FALSE(clipboard.isDeferred(IClipboard::kText));
+  clipboard.close();
+  EXPECT_EQ(1u << IClipboard::kHTML, clipboard.getDeferredFormats());
+  EXPECT_EQ(clipboard.marshall().size(), clipboard.getMarshalledSize());
+  EXPECT_EQ(clipboard.marshall(), clipboard.marshall(1u << IClipboard::kText));
+}
+
+TEST(ClipboardTests, getGeneration_deferredAgainWithSameTime_generationKept)
+{
+  Clipboard clipboard;
+  clipboard.setDeferrableFormats(IClipboard::kAllFormats);
+  clipboard.open(0);
+  clipboard.addDeferred(IClipboard::kBitmap, 1);
+  clipboard.close();
+  auto before = clipboard.getGeneration();
+
+  clipboard.open(0);
+  clipboard.empty();
+  clipboard.addDeferred(IClipboard::kBitmap, 1);
+  clipboard.close();
+
+  EXPECT_EQ(before, clipboard.getGeneration());
+}
+
+TEST(ClipboardTests, getGeneration_deferredWithNewTime_generationChanged)
+{
+  Clipboard clipboard;
+  clipboard.setDeferrableFormats(IClipboard::kAllFormats);
+  clipboard.open(0);
+  clipboard.addDeferred(IClipboard::kBitmap, 1);
+  clipboard.close();
+  auto before = clipboard.getGeneration();
+
+  clipboard.open(0);
+  clipboard.empty();
+  clipboard.addDeferred(IClipboard::kBitmap, 2);
+  clipboard.close();
+
+  EXPECT_NE(before, clipboard.getGeneration());
+}
+
+TEST(ClipboardTests, addDeferred_formatNotDeferrable_returnsFalse)
+{
+  Clipboard clipboard;
+  clipboard.setDeferrableFormats(1u << IClipboard::kBitmap);
+  clipboard.open(0);
+
+  EXPECT_FALSE(clipboard.addDeferred(IClipboard::kText, 1));
+  EXPECT_FALSE(clipboard.has(IClipboard::kText));
+  clipboard.close();
+}
+
+TEST(ClipboardTests, resolve_sourceHasData_formatFilledAndGenerationKept)
+{
+  Clipboard clipboard;
+  clipboard.setDeferrableFormats(IClipboard::kAllFormats);
+  clipboard.open(0);
+  clipboard.add(IClipboard::kText, "synergy rocks!");
+  clipboard.addDeferred(IClipboard::kHTML, 1);
+  clipboard.addDeferred(IClipboard::kBitmap, 1);
+  clipboard.close();
+  auto before = clipboard.getGeneration();
+  Clipboard source;
+  source.open(0);
+  source.add(IClipboard::kHTML, "html sucks");
+  source.close();
+
+  EXPECT_TRUE(clipboard.resolve(source));
+
+  EXPECT_EQ(before, clipboard.getGeneration());
+  EXPECT_EQ(0, clipboard.getDeferredFormats());
+  clipboard.open(0);
+  EXPECT_EQ("html sucks", clipboard.get(IClipboard::kHTML));
+  EXPECT_FALSE(clipboard.has(IClipboard::kBitmap));
+  clipboard.close();
+  EXPECT_EQ(clipboard.marshall().size(), clipboard.getMarshalledSize());
+}
+
+TEST(ClipboardTests, resolve_overMaxSize_formatStillDeferred)
+{
+  Clipboard clipboard;
+  clipboard.setDeferrableFormats(IClipboard::kAllFormats);
+  clipboard.open(0);
+  clipboard.addDeferred(IClipboard::kHTML, 1);
+  clipboard.close();
+  Clipboard source;
+  source.open(0);
+  source.add(IClipboard::kHTML, "html sucks");
+  source.close();
+
+  EXPECT_FALSE(clipboard.resolve(source, IClipboard::kAllFormats, 10));
+
+  EXPECT_EQ(1u << IClipboard::kHTML, clipboard.getDeferredFormats());
+  EXPECT_EQ(4, clipboard.getMarshalledSize());
+}
+
+TEST(ClipboardTests, getFormatInfo_deferredFormat_sizeUnknown)
+{
+  Clipboard clipboard;
+  clipboard.setDeferrableFormats(IClipboard::kAllFormats);
+  clipboard.open(0);
+  clipboard.addDeferred(IClipboard::kBitmap, 1);
+  clipboard.close();
+
+  auto formats = clipboard.getFormatInfo();
+
+  ASSERT_EQ(1, formats.size());
+  EXPECT_EQ(IClipboard::kBitmap, formats[0].m_format);
+  EXPECT_EQ(ClipboardFormatInfo::kUnknownSize, formats[0].m_size);
+  EXPECT_EQ(0, formats[0].m_hash);
+}
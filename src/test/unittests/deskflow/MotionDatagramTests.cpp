@@ -0,0 +1,82 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "deskflow/MotionDatagram.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+const String kKey(MotionDatagram::kKeySize, 'k');
+
+} // namespace
+
+TEST(MotionDatagramTests, open_sealed_sameMotion)
+{
+  MotionDatagram sent(7, 42, MotionDatagram::kRelative, -100000, 200, 3);
+  MotionDatagram received;
+
+  ASSERT_TRUE(received.open(sent.seal(kKey, true), kKey, true));
+
+  EXPECT_EQ(7, received.m_channel);
+  EXPECT_EQ(42, received.m_seq);
+  EXPECT_EQ(MotionDatagram::kRelative, received.m_kind);
+  EXPECT_EQ(-100000, received.m_x);
+  EXPECT_EQ(200, received.m_y);
+  EXPECT_EQ(3, received.m_fence);
+}
+
+TEST(MotionDatagramTests, open_wrongKey_returnsFalse)
+{
+  String datagram = MotionDatagram(1, 1, MotionDatagram::kAbsolute, 10, 20).seal(kKey, true);
+  MotionDatagram received;
+
+  EXPECT_FALSE(received.open(datagram, String(MotionDatagram::kKeySize, 'x'), true));
+}
+
+TEST(MotionDatagramTests, open_otherDirection_returnsFalse)
+{
+  String datagram = MotionDatagram(1, 1, MotionDatagram::kRegister).seal(kKey, false);
+  MotionDatagram received;
+
+  EXPECT_FALSE(received.open(datagram, kKey, true));
+}
+
+TEST(MotionDatagramTests, open_tamperedHeader_returnsFalse)
+{
+  String datagram = MotionDatagram(1, 1, MotionDatagram::kAbsolute, 10, 20).seal(kKey, true);
+  datagram[9] ^= 1;
+  MotionDatagram received;
+
+  EXPECT_FALSE(received.open(datagram, kKey, true));
+}
+
+TEST(MotionDatagramTests, peekChannel_sealed_returnsChannel)
+{
+  String datagram = MotionDatagram(0x01020304, 1, MotionDatagram::kRegister).seal(kKey, false);
+  UInt32 channel = 0;
+
+  ASSERT_TRUE(MotionDatagram::peekChannel(datagram, channel));
+  EXPECT_EQ(0x01020304, channel);
+}
+
+TEST(MotionDatagramTests, peekChannel_notMotion_returnsFalse)
+{
+  UInt32 channel = 0;
+
+  EXPECT_FALSE(MotionDatagram::peekChannel("not a motion datagram", channel));
+}
@@ -24,6 +24,8 @@
 #include "ipc/IpcLogOutputter.h"
 #include "mt/Thread.h"
 
+#include <vector>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -172,3 +174,73 @@ using namespace deskflow;
 // }
 
 #endif // WINAPI_MSWINDOWS
+
+namespace {
+
+// captures the log lines sent, since the message matcher above doesn't build.
+void captureLogLines(MockIpcServer &server, std::vector<String> &lines)
+{
+  ON_CALL(server, hasClients(testing::_)).WillByDefault(testing::Return(true));
+  ON_CALL(server, send(testing::_, testing::_))
+      .WillByDefault(testing::Invoke([&lines](const IpcMessage &message, IpcClientType) {
+        lines.push_back(static_cast<const IpcLogLineMessage &>(message).logLine());
+      }));
+}
+
+} // namespace
+
+TEST(IpcLogOutputterTests, sendBuffer_overBufferMaxSize_oldestLinesDropped)
+{
+  testing::NiceMock<MockIpcServer> server;
+  std::vector<String> sent;
+  captureLogLines(server, sent);
+  IpcLogOutputter outputter(server, IpcClientType::GUI, false);
+  outputter.bufferMaxSize(2);
+
+  outputter.write(kNOTE, "mock 1");
+  outputter.write(kNOTE, "mock 2");
+  outputter.write(kNOTE, "mock 3");
+  outputter.sendBuffer();
+
+  ASSERT_EQ(1, sent.size());
+  EXPECT_EQ("mock 2\nmock 3\n", sent[0]);
+}
+
+TEST(IpcLogOutputterTests, sendBuffer_manyLines_sentInChunks)
+{
+  testing::NiceMock<MockIpcServer> server;
+  std::vector<String> sent;
+  captureLogLines(server, sent);
+  IpcLogOutputter outputter(server, IpcClientType::GUI, false);
+
+  for (int i = 0; i < 150; i++) {
+    outputter.write(kNOTE, "mock");
+  }
+  outputter.sendBuffer();
+  outputter.sendBuffer();
+  outputter.sendBuffer();
+
+  ASSERT_EQ(2, sent.size());
+  EXPECT_EQ(100 * 5, sent[0].size());
+  EXPECT_EQ(50 * 5, sent[1].size());
+}
+
+TEST(IpcLogOutputterTests, sendBuffer_linesWrapRing_linesIntact)
+{
+  testing::NiceMock<MockIpcServer> server;
+  std::vector<String> sent;
+  captureLogLines(server, sent);
+  IpcLogOutputter outputter(server, IpcClientType::GUI, false);
+  const String longLine(300 * 1024, 'x');
+
+  // the second long line doesn't fit after the first, so it wraps.
+  outputter.write(kNOTE, longLine.c_str());
+  outputter.sendBuffer();
+  outputter.write(kNOTE, longLine.c_str());
+  outputter.write(kNOTE, "mock 1");
+  outputter.sendBuffer();
+
+  ASSERT_EQ(2, sent.size());
+  EXPECT_EQ(longLine + "\n", sent[0]);
+  EXPECT_EQ(longLine + "\nmock 1\n", sent[1]);
+}
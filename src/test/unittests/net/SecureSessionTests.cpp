@@ -0,0 +1,195 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "net/SecureSession.h"
+
+#include <openssl/ec.h>
+#include <openssl/evp.h>
+#include <openssl/x509.h>
+
+#include <gtest/gtest.h>
+
+// does handshakes between a client and server context over a bio pair,
+// like two secure sockets in the same process would.
+class SecureSessionTests : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_key = newKey();
+    ASSERT_NE(nullptr, m_key);
+    m_cert = newCert(m_key);
+    ASSERT_NE(nullptr, m_cert);
+
+    m_serverContext = SSL_CTX_new(TLS_server_method());
+    ASSERT_EQ(1, SSL_CTX_use_certificate(m_serverContext, m_cert));
+    ASSERT_EQ(1, SSL_CTX_use_PrivateKey(m_serverContext, m_key));
+    SecureSession::setupServerContext(m_serverContext);
+
+    m_clientContext = SSL_CTX_new(TLS_client_method());
+    SecureSession::setupClientContext(m_clientContext);
+  }
+
+  void TearDown() override
+  {
+    SecureSession::cleanup();
+    SSL_CTX_free(m_clientContext);
+    SSL_CTX_free(m_serverContext);
+    X509_free(m_cert);
+    EVP_PKEY_free(m_key);
+  }
+
+  // returns 1 if the session was resumed, 0 if not and -1 on failure
+  int connect(const String *peer)
+  {
+    SSL *client = SSL_new(m_clientContext);
+    SSL *server = SSL_new(m_serverContext);
+    BIO *clientBio = NULL;
+    BIO *serverBio = NULL;
+    BIO_new_bio_pair(&clientBio, 0, &serverBio, 0);
+    SSL_set_bio(client, clientBio, clientBio);
+    SSL_set_bio(server, serverBio, serverBio);
+    SSL_set_connect_state(client);
+    SSL_set_accept_state(server);
+
+    SecureSession::resume(client, peer);
+
+    int result = -1;
+    bool clientDone = false;
+    bool serverDone = false;
+    for (int i = 0; i < 100 && !(clientDone && serverDone); ++i) {
+      clientDone = clientDone || SSL_do_handshake(client) == 1;
+      serverDone = serverDone || SSL_do_handshake(server) == 1;
+    }
+
+    if (clientDone && serverDone) {
+      // tls 1.3 tickets come after the handshake, reading picks them up
+      char buffer[1];
+      SSL_read(client, buffer, sizeof(buffer));
+      result = SSL_session_reused(client) ? 1 : 0;
+    }
+
+    SSL_free(server);
+    SSL_free(client);
+    return result;
+  }
+
+private:
+  static EVP_PKEY *newKey()
+  {
+    EVP_PKEY *key = NULL;
+    EVP_PKEY_CTX *context = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, NULL);
+    if (context != NULL && EVP_PKEY_keygen_init(context) > 0 &&
+        EVP_PKEY_CTX_set_ec_paramgen_curve_nid(context, NID_X9_62_prime256v1) > 0) {
+      EVP_PKEY_keygen(context, &key);
+    }
+    EVP_PKEY_CTX_free(context);
+    return key;
+  }
+
+  static X509 *newCert(EVP_PKEY *key)
+  {
+    X509 *cert = X509_new();
+    ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+    X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+    X509_gmtime_adj(X509_getm_notAfter(cert), 60 * 60);
+    X509_set_pubkey(cert, key);
+
+    X509_NAME *name = X509_get_subject_name(cert);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, (const unsigned char *)"deskflow", -1, -1, 0);
+    X509_set_issuer_name(cert, name);
+
+    if (X509_sign(cert, key, EVP_sha256()) <= 0) {
+      X509_free(cert);
+      return NULL;
+    }
+    return cert;
+  }
+
+  EVP_PKEY *m_key = NULL;
+  X509 *m_cert = NULL;
+  SSL_CTX *m_serverContext = NULL;
+  SSL_CTX *m_clientContext = NULL;
+};
+
+TEST_F(SecureSessionTests, connect_firstConnect_fullHandshake)
+{
+  String peer("server:24800");
+
+  EXPECT_EQ(0, connect(&peer));
+}
+
+TEST_F(SecureSessionTests, connect_reconnect_resumed)
+{
+  String peer("server:24800");
+  ASSERT_EQ(0, connect(&peer));
+
+  EXPECT_EQ(1, connect(&peer));
+  EXPECT_EQ(1, connect(&peer));
+}
+
+TEST_F(SecureSessionTests, connect_otherPeer_fullHandshake)
+{
+  String peer("server:24800");
+  String other("other:24800");
+  ASSERT_EQ(0, connect(&peer));
+
+  EXPECT_EQ(0, connect(&other));
+}
+
+TEST_F(SecureSessionTests, forget_verifyFailed_fullHandshake)
+{
+  String peer("server:24800");
+  ASSERT_EQ(0, connect(&peer));
+
+  SecureSession::forget(peer);
+
+  EXPECT_EQ(0, connect(&peer));
+  EXPECT_EQ(1, connect(&peer));
+}
+
+TEST_F(SecureSessionTests, rotateTicketKey_previousKey_resumed)
+{
+  String peer("server:24800");
+  ASSERT_EQ(0, connect(&peer));
+
+  SecureSession::rotateTicketKey();
+
+  EXPECT_EQ(1, connect(&peer));
+}
+
+TEST_F(SecureSessionTests, rotateTicketKey_expiredKey_fullHandshake)
+{
+  String peer("server:24800");
+  ASSERT_EQ(0, connect(&peer));
+
+  SecureSession::rotateTicketKey();
+  SecureSession::rotateTicketKey();
+
+  EXPECT_EQ(0, connect(&peer));
+  EXPECT_EQ(1, connect(&peer));
+}
+
+TEST_F(SecureSessionTests, cleanup_storedSession_fullHandshake)
+{
+  String peer("server:24800");
+  ASSERT_EQ(0, connect(&peer));
+
+  SecureSession::cleanup();
+
+  EXPECT_EQ(0, connect(&peer));
+}
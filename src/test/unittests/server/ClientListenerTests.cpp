@@ -0,0 +1,175 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test/mock/net/MockDataSocket.h"
+#include "test/mock/net/MockListenSocket.h"
+#include "test/mock/net/MockSocketFactory.h"
+
+#include "base/EventQueue.h"
+#include "base/Stopwatch.h"
+#include "net/NetworkAddress.h"
+#include "server/ClientListener.h"
+
+#include <deque>
+#include <utility>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+namespace {
+
+// a listener with tls on, so connections stay in the handshake until
+// the test says otherwise
+class ClientListenerTests : public ::testing::Test
+{
+protected:
+  ClientListenerTests()
+  {
+    m_listen = new NiceMock<MockListenSocket>();
+    ON_CALL(*m_listen, accept(_)).WillByDefault(Invoke(this, &ClientListenerTests::accept));
+
+    auto socketFactory = new NiceMock<MockSocketFactory>();
+    ON_CALL(*socketFactory, createListen(_, _)).WillByDefault(Return(m_listen));
+
+    NetworkAddress address("127.0.0.1", 0);
+    address.resolve();
+    m_listener.reset(new ClientListener(address, socketFactory, &m_events, true));
+
+    // hold no events until the loop starts, like the apps do
+    m_events.addEvent(Event(Event::kQuit));
+    m_events.loop();
+  }
+
+  ~ClientListenerTests() override
+  {
+    m_listener.reset();
+    for (auto &connection : m_backlog) {
+      delete connection.first;
+    }
+  }
+
+  // queues a connection from \p address and returns its socket
+  MockDataSocket *connect(const String &address)
+  {
+    auto socket = new NiceMock<MockDataSocket>();
+    ON_CALL(*socket, destroyed()).WillByDefault(Invoke([this] { ++m_destroyed; }));
+    m_backlog.push_back(std::make_pair(socket, address));
+    return socket;
+  }
+
+  void connecting()
+  {
+    m_events.addEvent(Event(m_events.forIListenSocket().connecting(), m_listen->getEventTarget()));
+    dispatchUntil([] { return false; }, 0.05);
+  }
+
+  // dispatches events until \p done returns true or \p timeout has passed
+  template <typename Done> void dispatchUntil(Done done, double timeout = 1.0)
+  {
+    Stopwatch stopwatch;
+    while (!done() && stopwatch.getTime() < timeout) {
+      Event event;
+      if (m_events.getEvent(event, 0.01)) {
+        m_events.dispatchEvent(event);
+        Event::deleteData(event);
+      }
+    }
+  }
+
+  IDataSocket *accept(String *address)
+  {
+    if (m_backlog.empty()) {
+      return NULL;
+    }
+    IDataSocket *socket = m_backlog.front().first;
+    if (address != NULL) {
+      *address = m_backlog.front().second;
+    }
+    m_backlog.pop_front();
+    return socket;
+  }
+
+  EventQueue m_events;
+  NiceMock<MockListenSocket> *m_listen = NULL;
+  std::unique_ptr<ClientListener> m_listener;
+  std::deque<std::pair<MockDataSocket *, String>> m_backlog;
+  int m_destroyed = 0;
+};
+
+} // namespace
+
+TEST_F(ClientListenerTests, acceptClients_atLimit_restStayInBacklog)
+{
+  m_listener->setMaxHandshakes(2);
+  connect("10.0.0.1");
+  connect("10.0.0.2");
+  connect("10.0.0.3");
+
+  connecting();
+
+  EXPECT_EQ(1, m_backlog.size());
+  EXPECT_EQ(0, m_destroyed);
+}
+
+TEST_F(ClientListenerTests, acceptClients_tooManyFromAddress_dropped)
+{
+  for (int i = 0; i < 5; ++i) {
+    connect("10.0.0.1");
+  }
+  connect("10.0.0.2");
+
+  connecting();
+
+  EXPECT_TRUE(m_backlog.empty());
+  EXPECT_EQ(1, m_destroyed);
+}
+
+TEST_F(ClientListenerTests, handleHandshakeFailed_disconnected_slotFreed)
+{
+  m_listener->setMaxHandshakes(1);
+  MockDataSocket *failed = connect("10.0.0.1");
+  connect("10.0.0.2");
+  connecting();
+  ASSERT_EQ(1, m_backlog.size());
+
+  m_events.addEvent(Event(m_events.forISocket().disconnected(), failed->getEventTarget()));
+  dispatchUntil([this] { return m_backlog.empty(); });
+
+  EXPECT_TRUE(m_backlog.empty());
+  EXPECT_EQ(1, m_destroyed);
+}
+
+TEST_F(ClientListenerTests, expireHandshakes_timedOut_slotFreed)
+{
+  m_listener->setMaxHandshakes(1);
+  m_listener->setHandshakeTimeout(0.05);
+  connect("10.0.0.1");
+  connect("10.0.0.2");
+  connecting();
+  ASSERT_EQ(1, m_backlog.size());
+
+  // the retry timer picks up the expired handshake
+  dispatchUntil([this] { return m_backlog.empty(); }, 3.0);
+
+  EXPECT_TRUE(m_backlog.empty());
+  EXPECT_EQ(1, m_destroyed);
+}
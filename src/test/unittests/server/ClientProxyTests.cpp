@@ -0,0 +1,505 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test/mock/deskflow/MockAppUtil.h"
+#include "test/mock/io/MockStream.h"
+#include "test/mock/server/MockServer.h"
+
+#include "arch/Arch.h"
+#include "base/EventQueue.h"
+#include "base/Stopwatch.h"
+#include "deskflow/Clipboard.h"
+#include "deskflow/ProtocolUtil.h"
+#include "deskflow/option_types.h"
+#include "deskflow/protocol_types.h"
+#include "mt/Thread.h"
+#include "server/ClientProxy1_0.h"
+#include "server/ClientProxy1_1.h"
+#include "server/ClientProxy1_11.h"
+#include "server/ClientProxy1_3.h"
+#include "server/ClientProxy1_6.h"
+#include "server/ClientProxyUnknown.h"
+#include "server/HeartbeatTicker.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+namespace {
+
+typedef std::vector<UInt8> Bytes;
+
+NiceMock<MockStream> *newStream(Bytes &written)
+{
+  auto stream = new NiceMock<MockStream>();
+  ON_CALL(*stream, getEventTarget()).WillByDefault(Return(stream));
+  ON_CALL(*stream, write(_, _)).WillByDefault(Invoke([&written](const void *data, UInt32 size) {
+    const UInt8 *bytes = static_cast<const UInt8 *>(data);
+    written.insert(written.end(), bytes, bytes + size);
+  }));
+  return stream;
+}
+
+// makes \p stream read from the front of \p input
+void setInput(NiceMock<MockStream> *stream, Bytes &input)
+{
+  ON_CALL(*stream, read(_, _)).WillByDefault(Invoke([&input](void *data, UInt32 size) {
+    size = std::min(size, static_cast<UInt32>(input.size()));
+    if (data != NULL) {
+      memcpy(data, input.data(), size);
+    }
+    input.erase(input.begin(), input.begin() + size);
+    return size;
+  }));
+  ON_CALL(*stream, getSize()).WillByDefault(Invoke([&input] { return static_cast<UInt32>(input.size()); }));
+  ON_CALL(*stream, isReady()).WillByDefault(Invoke([&input] { return !input.empty(); }));
+}
+
+void addInfo(Bytes &input)
+{
+  ProtocolUtil::formatf(input, kMsgDInfo, 0, 0, 1920, 1080, 0, 960, 540);
+}
+
+void addHelloBack(Bytes &input, int minor)
+{
+  const String name = "client";
+  ProtocolUtil::formatf(input, kMsgHelloBack, 1, minor, &name);
+}
+
+Bytes message(const char *code)
+{
+  Bytes bytes;
+  ProtocolUtil::formatf(bytes, code);
+  return bytes;
+}
+
+void setText(Clipboard &clipboard, const String &text)
+{
+  clipboard.open(0);
+  clipboard.empty();
+  clipboard.add(IClipboard::kText, text);
+  clipboard.close();
+}
+
+// a clipboard that counts how often it's opened, e.g. to be copied
+class CountingClipboard : public Clipboard
+{
+public:
+  bool open(Time time) const override
+  {
+    ++m_opened;
+    return Clipboard::open(time);
+  }
+
+  mutable int m_opened = 0;
+};
+
+OptionsList heartbeatOptions(UInt32 milliseconds)
+{
+  OptionsList options;
+  options.push_back(kOptionHeartbeat);
+  options.push_back(milliseconds);
+  return options;
+}
+
+// lets tests check a proxy's heartbeat directly
+class HeartbeatProxy : public ClientProxy1_3
+{
+public:
+  using ClientProxy1_3::ClientProxy1_3;
+  using ClientProxy1_3::heartbeat;
+};
+
+// dispatches events until \p done returns true or \p timeout has passed
+template <typename Done> void dispatchUntil(EventQueue &events, Done done, double timeout = 1.0)
+{
+  Stopwatch stopwatch;
+  while (!done() && stopwatch.getTime() < timeout) {
+    Event event;
+    if (events.getEvent(event, 0.01)) {
+      events.dispatchEvent(event);
+      Event::deleteData(event);
+    }
+  }
+}
+
+// a server that's reading from a client which has just connected
+class ClientProxyHandshakeTests : public ::testing::Test
+{
+protected:
+  ClientProxyHandshakeTests() : m_stream(newStream(m_written))
+  {
+    setInput(m_stream, m_input);
+
+    // hold no events until the loop starts, like the server does
+    m_events.addEvent(Event(Event::kQuit));
+    m_events.loop();
+  }
+
+  void inputReady()
+  {
+    m_events.addEvent(Event(m_events.forIStream().inputReady(), m_stream));
+  }
+
+  EventQueue m_events;
+  NiceMock<MockAppUtil> m_appUtil;
+  MockServer m_server;
+  Bytes m_written;
+  Bytes m_input;
+  NiceMock<MockStream> *m_stream;
+};
+
+} // namespace
+
+TEST(ClientProxyTests, keyDown_broadcastToDifferentVersions_eachGetsItsFormat)
+{
+  EventQueue events;
+  Bytes written1, written2, written3;
+  ClientProxy1_1 proxy1("one", newStream(written1), &events);
+  ClientProxy1_1 proxy2("two", newStream(written2), &events);
+  ClientProxy1_0 proxy3("three", newStream(written3), &events);
+  const String lang = "en";
+  Bytes expected1, expected3;
+  ProtocolUtil::formatf(expected1, kMsgDKeyDown, 'a', 0, 38);
+  ProtocolUtil::formatf(expected3, kMsgDKeyDown1_0, 'a', 0);
+
+  {
+    ClientProxy::Broadcast broadcast;
+    proxy1.keyDown('a', 0, 38, lang);
+    proxy2.keyDown('a', 0, 38, lang);
+    proxy3.keyDown('a', 0, 38, lang);
+  }
+
+  EXPECT_EQ(expected1, written1);
+  EXPECT_EQ(expected1, written2);
+  EXPECT_EQ(expected3, written3);
+}
+
+TEST(ClientProxyTests, keyUp_afterBroadcast_formattedWithNewArguments)
+{
+  EventQueue events;
+  Bytes written;
+  ClientProxy1_1 proxy("one", newStream(written), &events);
+  {
+    ClientProxy::Broadcast broadcast;
+    proxy.keyUp('a', 0, 38);
+  }
+  written.clear();
+  Bytes expected;
+  ProtocolUtil::formatf(expected, kMsgDKeyUp, 'b', 0, 56);
+
+  proxy.keyUp('b', 0, 56);
+
+  EXPECT_EQ(expected, written);
+}
+
+TEST(ClientProxyTests, keyUp_broadcastWithDifferentArguments_asserts)
+{
+  EventQueue events;
+  Bytes written;
+  ClientProxy1_1 proxy("one", newStream(written), &events);
+  ClientProxy::Broadcast broadcast;
+  proxy.keyUp('a', 0, 38);
+
+  EXPECT_DEBUG_DEATH(proxy.keyUp('b', 0, 56), "formatted == \\*message");
+}
+
+TEST(ClientProxyTests, setOptions_broadcast_sameBytesForEachClient)
+{
+  EventQueue events;
+  Bytes written1, written2;
+  ClientProxy1_0 proxy1("one", newStream(written1), &events);
+  ClientProxy1_0 proxy2("two", newStream(written2), &events);
+  OptionsList options;
+  options.push_back(kOptionHalfDuplexCapsLock);
+  options.push_back(1);
+  Bytes expected;
+  ProtocolUtil::formatf(expected, kMsgDSetOptions, &options);
+
+  {
+    ClientProxy::Broadcast broadcast;
+    proxy1.setOptions(options);
+    proxy2.setOptions(options);
+  }
+
+  EXPECT_EQ(expected, written1);
+  EXPECT_EQ(expected, written2);
+}
+
+TEST(ClientProxyTests, setClipboard_broadcast_sameBytesForEachClient)
+{
+  EventQueue events;
+  MockServer server;
+  Bytes written1, written2;
+  ClientProxy1_6 proxy1("one", newStream(written1), &server, &events);
+  ClientProxy1_6 proxy2("two", newStream(written2), &server, &events);
+  Clipboard clipboard;
+  setText(clipboard, "clipboard");
+  events.addEvent(Event(Event::kQuit));
+  events.loop();
+
+  {
+    ClientProxy::Broadcast broadcast;
+    proxy1.setClipboard(kClipboardClipboard, &clipboard);
+    proxy2.setClipboard(kClipboardClipboard, &clipboard);
+  }
+  dispatchUntil(events, [] { return false; }, 0.05);
+
+  EXPECT_FALSE(written1.empty());
+  EXPECT_EQ(written1, written2);
+}
+
+TEST(ClientProxyTests, setClipboard_changedAfterBroadcast_newDataSent)
+{
+  EventQueue events;
+  MockServer server;
+  Bytes written1, written2;
+  ClientProxy1_6 proxy1("one", newStream(written1), &server, &events);
+  ClientProxy1_6 proxy2("two", newStream(written2), &server, &events);
+  Clipboard clipboard;
+  setText(clipboard, "clipboard");
+  events.addEvent(Event(Event::kQuit));
+  events.loop();
+  {
+    ClientProxy::Broadcast broadcast;
+    proxy1.setClipboard(kClipboardClipboard, &clipboard);
+  }
+  setText(clipboard, "changed");
+
+  proxy2.setClipboard(kClipboardClipboard, &clipboard);
+  dispatchUntil(events, [] { return false; }, 0.05);
+
+  const String text(written2.begin(), written2.end());
+  EXPECT_NE(String::npos, text.find("changed"));
+  EXPECT_EQ(String::npos, text.find("clipboard"));
+}
+
+TEST(ClientProxyTests, setClipboard_sourceUnchanged_notCopied)
+{
+  EventQueue events;
+  MockServer server;
+  Bytes written;
+  ClientProxy1_6 proxy("one", newStream(written), &server, &events);
+  CountingClipboard clipboard;
+  setText(clipboard, "clipboard");
+  events.addEvent(Event(Event::kQuit));
+  events.loop();
+  proxy.setClipboard(kClipboardClipboard, &clipboard);
+  dispatchUntil(events, [] { return false; }, 0.05);
+  written.clear();
+  const int opened = clipboard.m_opened;
+
+  proxy.setClipboardDirty(kClipboardClipboard, true);
+  proxy.setClipboard(kClipboardClipboard, &clipboard);
+  dispatchUntil(events, [] { return false; }, 0.05);
+
+  EXPECT_EQ(opened, clipboard.m_opened);
+  EXPECT_TRUE(written.empty());
+}
+
+TEST(ClientProxyTests, setClipboard_grabbedSinceSent_sentAgain)
+{
+  EventQueue events;
+  MockServer server;
+  Bytes written;
+  ClientProxy1_6 proxy("one", newStream(written), &server, &events);
+  Clipboard clipboard;
+  setText(clipboard, "clipboard");
+  events.addEvent(Event(Event::kQuit));
+  events.loop();
+  proxy.setClipboard(kClipboardClipboard, &clipboard);
+  dispatchUntil(events, [] { return false; }, 0.05);
+  proxy.grabClipboard(kClipboardClipboard);
+  written.clear();
+
+  proxy.setClipboard(kClipboardClipboard, &clipboard);
+  dispatchUntil(events, [] { return false; }, 0.05);
+
+  const String text(written.begin(), written.end());
+  EXPECT_NE(String::npos, text.find("clipboard"));
+}
+
+TEST(ClientProxyTests, heartbeat_twoClients_keepAliveSentToBoth)
+{
+  EventQueue events;
+  HeartbeatTicker ticker(&events);
+  Bytes written1, written2;
+  ClientProxy1_3 proxy1("one", newStream(written1), &events);
+  ClientProxy1_3 proxy2("two", newStream(written2), &events);
+  proxy1.setHeartbeatTicker(&ticker);
+  proxy2.setHeartbeatTicker(&ticker);
+  proxy1.setOptions(heartbeatOptions(20));
+  proxy2.setOptions(heartbeatOptions(20));
+  written1.clear();
+  written2.clear();
+  Bytes expected;
+  ProtocolUtil::formatf(expected, kMsgCKeepAlive);
+
+  dispatchUntil(events, [&] { return !written1.empty() && !written2.empty(); });
+
+  ASSERT_LE(expected.size(), written1.size());
+  ASSERT_LE(expected.size(), written2.size());
+  EXPECT_EQ(expected, Bytes(written1.begin(), written1.begin() + expected.size()));
+  EXPECT_EQ(expected, Bytes(written2.begin(), written2.begin() + expected.size()));
+}
+
+TEST(ClientProxyTests, heartbeat_nothingReceived_disconnected)
+{
+  EventQueue events;
+  Bytes written;
+  bool closed = false;
+  auto stream = newStream(written);
+  ON_CALL(*stream, close()).WillByDefault(Invoke([&closed] { closed = true; }));
+  HeartbeatTicker ticker(&events);
+  ClientProxy1_3 proxy("one", stream, &events);
+  proxy.setHeartbeatTicker(&ticker);
+  proxy.setOptions(heartbeatOptions(20));
+
+  dispatchUntil(events, [&] { return closed; });
+
+  EXPECT_TRUE(closed);
+}
+
+TEST(ClientProxyTests, heartbeat_deadClient_noKeepAliveSent)
+{
+  EventQueue events;
+  Bytes written;
+  bool closed = false;
+  auto stream = newStream(written);
+  ON_CALL(*stream, close()).WillByDefault(Invoke([&closed] { closed = true; }));
+  HeartbeatProxy proxy("one", stream, &events);
+  proxy.setOptions(heartbeatOptions(20));
+  written.clear();
+
+  EXPECT_FALSE(proxy.heartbeat(ARCH->time() + 1.0));
+
+  EXPECT_TRUE(closed);
+  EXPECT_TRUE(written.empty());
+}
+
+TEST(ClientProxyTests, heartbeat_tickerDestroyed_notChecked)
+{
+  EventQueue events;
+  Bytes written;
+  bool closed = false;
+  auto stream = newStream(written);
+  ON_CALL(*stream, close()).WillByDefault(Invoke([&closed] { closed = true; }));
+  ClientProxy1_3 proxy("one", stream, &events);
+  {
+    HeartbeatTicker ticker(&events);
+    proxy.setHeartbeatTicker(&ticker);
+    proxy.setOptions(heartbeatOptions(20));
+  }
+
+  dispatchUntil(events, [&] { return closed; }, 0.2);
+
+  EXPECT_FALSE(closed);
+}
+
+
+TEST_F(ClientProxyHandshakeTests, helloBack_client1_10_infoQueriedAndAcked)
+{
+  ClientProxyUnknown unknown(m_stream, 30.0, &m_server, &m_events);
+  std::unique_ptr<ClientProxy> proxy;
+  m_written.clear();
+
+  addHelloBack(m_input, 10);
+  inputReady();
+  dispatchUntil(m_events, [&] { return !m_written.empty(); });
+
+  EXPECT_EQ(message(kMsgQInfo), m_written);
+  m_written.clear();
+
+  addInfo(m_input);
+  inputReady();
+  dispatchUntil(m_events, [&] {
+    proxy.reset(unknown.orphanClientProxy());
+    return proxy != NULL;
+  });
+
+  ASSERT_NE(nullptr, proxy);
+  EXPECT_EQ(message(kMsgCInfoAck), m_written);
+}
+
+TEST_F(ClientProxyHandshakeTests, helloBack_client1_11WithInfo_readyWithoutQuery)
+{
+  ClientProxyUnknown unknown(m_stream, 30.0, &m_server, &m_events);
+  std::unique_ptr<ClientProxy> proxy;
+  m_written.clear();
+
+  addHelloBack(m_input, 11);
+  addInfo(m_input);
+  inputReady();
+  dispatchUntil(m_events, [&] {
+    proxy.reset(unknown.orphanClientProxy());
+    return proxy != NULL;
+  });
+
+  ASSERT_NE(nullptr, proxy);
+  EXPECT_TRUE(m_input.empty());
+  EXPECT_TRUE(m_written.empty());
+}
+
+TEST_F(ClientProxyHandshakeTests, proxy1_11_infoAlreadyBuffered_infoRead)
+{
+  addInfo(m_input);
+
+  ClientProxy1_11 proxy("client", m_stream, &m_server, &m_events);
+  dispatchUntil(m_events, [&] { return m_input.empty(); });
+
+  EXPECT_TRUE(m_input.empty());
+}
+
+TEST_F(ClientProxyHandshakeTests, resetOptions_proxy1_11_infoAckSentWithOptions)
+{
+  ClientProxy1_11 proxy("client", m_stream, &m_server, &m_events);
+  addInfo(m_input);
+  inputReady();
+  dispatchUntil(m_events, [&] { return m_input.empty(); });
+  ASSERT_TRUE(m_written.empty());
+  Bytes expected = message(kMsgCInfoAck);
+  Bytes reset = message(kMsgCResetOptions);
+  expected.insert(expected.end(), reset.begin(), reset.end());
+
+  proxy.resetOptions();
+
+  EXPECT_EQ(expected, m_written);
+}
+
+TEST_F(ClientProxyHandshakeTests, info_proxy1_11AfterOptions_ackedStraightAway)
+{
+  ClientProxy1_11 proxy("client", m_stream, &m_server, &m_events);
+  addInfo(m_input);
+  inputReady();
+  dispatchUntil(m_events, [&] { return m_input.empty(); });
+  proxy.resetOptions();
+  m_written.clear();
+
+  addInfo(m_input);
+  inputReady();
+  dispatchUntil(m_events, [&] { return !m_written.empty(); });
+
+  EXPECT_EQ(message(kMsgCInfoAck), m_written);
+}
@@ -0,0 +1,122 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test/mock/server/MockPrimaryClient.h"
+
+#include "base/EventQueue.h"
+#include "base/FunctionEventJob.h"
+#include "server/InputFilter.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using testing::_;
+using testing::NiceMock;
+using testing::Return;
+
+namespace {
+
+InputFilter::Rule makeKeystrokeRule(IEventQueue *events, KeyID key)
+{
+  InputFilter::Rule rule(new InputFilter::KeystrokeCondition(events, key, 0));
+  rule.adoptAction(new InputFilter::LockCursorToScreenAction(events), true);
+  return rule;
+}
+
+void countEvent(const Event &, void *count)
+{
+  ++*static_cast<int *>(count);
+}
+
+} // namespace
+
+TEST(InputFilterTests, assign_oneRuleReplaced_onlyReplacedHotKeyUpdated)
+{
+  EventQueue events;
+  NiceMock<MockPrimaryClient> primary;
+  ON_CALL(primary, registerHotKey('a', _)).WillByDefault(Return(1));
+  ON_CALL(primary, registerHotKey('b', _)).WillByDefault(Return(2));
+  ON_CALL(primary, registerHotKey('c', _)).WillByDefault(Return(3));
+  InputFilter filter(&events);
+  filter.addFilterRule(makeKeystrokeRule(&events, 'a'));
+  filter.addFilterRule(makeKeystrokeRule(&events, 'b'));
+  filter.setPrimaryClient(&primary);
+  InputFilter reloaded(&events);
+  reloaded.addFilterRule(makeKeystrokeRule(&events, 'a'));
+  reloaded.addFilterRule(makeKeystrokeRule(&events, 'c'));
+
+  EXPECT_CALL(primary, registerHotKey('a', _)).Times(0);
+  EXPECT_CALL(primary, registerHotKey('c', _)).Times(1);
+  EXPECT_CALL(primary, unregisterHotKey(1)).Times(0);
+  EXPECT_CALL(primary, unregisterHotKey(2)).Times(1);
+
+  filter = reloaded;
+
+  EXPECT_EQ(2, filter.getNumRules());
+  EXPECT_EQ(reloaded.format(""), filter.format(""));
+  testing::Mock::VerifyAndClearExpectations(&primary);
+  filter.setPrimaryClient(NULL);
+}
+
+TEST(InputFilterTests, handleEvent_hotKeyOfSecondRule_secondRuleActivated)
+{
+  EventQueue events;
+  NiceMock<MockPrimaryClient> primary;
+  ON_CALL(primary, getEventTarget()).WillByDefault(Return(&primary));
+  ON_CALL(primary, registerHotKey('a', _)).WillByDefault(Return(1));
+  ON_CALL(primary, registerHotKey('b', _)).WillByDefault(Return(2));
+  InputFilter filter(&events);
+  filter.addFilterRule(makeKeystrokeRule(&events, 'a'));
+  filter.addFilterRule(makeKeystrokeRule(&events, 'b'));
+  filter.setPrimaryClient(&primary);
+  int activated = 0;
+  int passedThrough = 0;
+  events.adoptHandler(events.forServer().lockCursorToScreen(), &filter, new FunctionEventJob(&countEvent, &activated));
+  events.adoptHandler(
+      events.forIPrimaryScreen().hotKeyDown(), &filter, new FunctionEventJob(&countEvent, &passedThrough)
+  );
+  Event event(events.forIPrimaryScreen().hotKeyDown(), &primary, IPlatformScreen::HotKeyInfo::alloc(2));
+
+  events.dispatchEvent(event);
+
+  EXPECT_EQ(1, activated);
+  EXPECT_EQ(0, passedThrough);
+  Event::deleteData(event);
+  filter.setPrimaryClient(NULL);
+}
+
+TEST(InputFilterTests, handleEvent_unknownHotKey_passedThroughImmediately)
+{
+  EventQueue events;
+  NiceMock<MockPrimaryClient> primary;
+  ON_CALL(primary, getEventTarget()).WillByDefault(Return(&primary));
+  ON_CALL(primary, registerHotKey('a', _)).WillByDefault(Return(1));
+  InputFilter filter(&events);
+  filter.addFilterRule(makeKeystrokeRule(&events, 'a'));
+  filter.setPrimaryClient(&primary);
+  int passedThrough = 0;
+  events.adoptHandler(
+      events.forIPrimaryScreen().hotKeyDown(), &filter, new FunctionEventJob(&countEvent, &passedThrough)
+  );
+  Event event(events.forIPrimaryScreen().hotKeyDown(), &primary, IPlatformScreen::HotKeyInfo::alloc(7));
+
+  events.dispatchEvent(event);
+
+  EXPECT_EQ(1, passedThrough);
+  Event::deleteData(event);
+  filter.setPrimaryClient(NULL);
+}
@@ -0,0 +1,92 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "server/Config.h"
+#include "server/ScreenNames.h"
+
+#include <gtest/gtest.h>
+
+using deskflow::server::Config;
+
+TEST(ScreenNamesTests, intern_differentCase_sameIdAndFirstName)
+{
+  ScreenID id = ScreenNames::intern("ScreenNamesTests-Case");
+
+  EXPECT_EQ(id, ScreenNames::intern("screennamestests-case"));
+  EXPECT_EQ(id, ScreenNames::find("SCREENNAMESTESTS-CASE"));
+  EXPECT_EQ("ScreenNamesTests-Case", ScreenNames::get(id));
+}
+
+TEST(ScreenNamesTests, find_neverInterned_noScreen)
+{
+  EXPECT_EQ(ScreenNames::kNoScreen, ScreenNames::find("ScreenNamesTests-Unknown"));
+  EXPECT_EQ("", ScreenNames::get(ScreenNames::kNoScreen));
+}
+
+TEST(ScreenNamesTests, getScreenId_alias_canonicalId)
+{
+  Config config(nullptr);
+  config.addScreen("server");
+  config.addAlias("server", "server.local");
+
+  ScreenID id = config.getScreenId("server.local");
+
+  EXPECT_EQ(config.getScreenId("server"), id);
+  EXPECT_EQ("server", config.getScreenName(id));
+}
+
+TEST(ScreenNamesTests, getNeighbor_linkToAlias_canonicalIdAndPosition)
+{
+  Config config(nullptr);
+  config.addScreen("server");
+  config.addScreen("laptop");
+  config.addAlias("laptop", "laptop.local");
+  config.connect("server", kRight, 0.0f, 1.0f, "laptop.local", 0.0f, 0.5f);
+  float position = 0.0f;
+
+  ScreenID neighbor = config.getNeighbor(config.getScreenId("server"), kRight, 0.5f, &position);
+
+  EXPECT_EQ(config.getScreenId("laptop"), neighbor);
+  EXPECT_FLOAT_EQ(0.25f, position);
+  EXPECT_EQ(ScreenNames::kNoScreen, config.getNeighbor(neighbor, kLeft, 0.5f, NULL));
+}
+
+TEST(ScreenNamesTests, getScreenName_copiedConfigAfterRemove_noName)
+{
+  Config config(nullptr);
+  config.addScreen("server");
+  config.addScreen("laptop");
+  ScreenID id = config.getScreenId("laptop");
+  Config copy(config);
+  ASSERT_EQ("laptop", copy.getScreenName(id));
+
+  copy.removeScreen("laptop");
+
+  EXPECT_EQ("", copy.getScreenName(id));
+  EXPECT_EQ("laptop", config.getScreenName(id));
+}
+
+TEST(ScreenNamesTests, getScreenId_sameNameInOtherConfig_sameId)
+{
+  Config config(nullptr);
+  config.addScreen("laptop");
+  Config reloaded(nullptr);
+  reloaded.addScreen("LAPTOP");
+
+  EXPECT_EQ(config.getScreenId("laptop"), reloaded.getScreenId("laptop"));
+  EXPECT_EQ("LAPTOP", reloaded.getScreenName(reloaded.getScreenId("laptop")));
+}
@@ -0,0 +1,173 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * Copyright (C) 2025 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test/mock/client/MockClient.h"
+#include "test/mock/deskflow/MockAppUtil.h"
+#include "test/mock/io/MockStream.h"
+
+#include "arch/Arch.h"
+#include "base/EventQueue.h"
+#include "base/Stopwatch.h"
+#include "client/ClientMotionChannel.h"
+#include "client/ServerProxy.h"
+#include "deskflow/MotionDatagram.h"
+#include "mt/Thread.h"
+#include "net/NetworkAddress.h"
+#include "net/SocketMultiplexer.h"
+#include "net/TCPSocketFactory.h"
+#include "server/ServerMotionChannel.h"
+
+#include <memory>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+namespace {
+
+// registrations are this far apart, so the tests don't wait long
+const double kRate = 0.05;
+
+NetworkAddress loopback(int port)
+{
+  NetworkAddress address("127.0.0.1", port);
+  address.resolve();
+  return address;
+}
+
+// a motion channel between a server and a client over loopback
+class ServerMotionChannelTests : public ::testing::Test
+{
+protected:
+  ServerMotionChannelTests()
+      : m_socketFactory(&m_events, &m_multiplexer),
+        m_serverProxy(&m_client, &m_stream, &m_events)
+  {
+    ON_CALL(m_stream, getEventTarget()).WillByDefault(Return(&m_stream));
+
+    // hold no events until the loop starts, like the apps do
+    m_events.addEvent(Event(Event::kQuit));
+    m_events.loop();
+  }
+
+  void connect(const ServerMotionChannel &server, UInt32 channel, const String &key)
+  {
+    m_clientChannel.reset(new ClientMotionChannel(
+        &m_events, &m_socketFactory, loopback(server.getPort()), channel, key, &m_serverProxy, kRate
+    ));
+  }
+
+  // dispatches events until \p done returns true or \p timeout has passed
+  template <typename Done> void dispatchUntil(Done done, double timeout = 1.0)
+  {
+    Stopwatch stopwatch;
+    while (!done() && stopwatch.getTime() < timeout) {
+      Event event;
+      if (m_events.getEvent(event, 0.01)) {
+        m_events.dispatchEvent(event);
+        Event::deleteData(event);
+      }
+    }
+  }
+
+  EventQueue m_events;
+  SocketMultiplexer m_multiplexer;
+  TCPSocketFactory m_socketFactory;
+  NiceMock<MockAppUtil> m_appUtil;
+  NiceMock<MockClient> m_client;
+  NiceMock<MockStream> m_stream;
+  ServerProxy m_serverProxy;
+  std::unique_ptr<ClientMotionChannel> m_clientChannel;
+};
+
+} // namespace
+
+TEST_F(ServerMotionChannelTests, open_clientRegisters_channelUsed)
+{
+  ServerMotionChannel server(&m_events, &m_socketFactory, loopback(0), kRate);
+  String key;
+  UInt32 channel = server.open(key, NetworkAddress());
+  ASSERT_NE(0, channel);
+  EXPECT_FALSE(server.isRegistered(channel));
+
+  connect(server, channel, key);
+  dispatchUntil([&] { return server.isRegistered(channel); });
+
+  EXPECT_TRUE(server.isRegistered(channel));
+}
+
+TEST_F(ServerMotionChannelTests, send_registered_clientMoves)
+{
+  ServerMotionChannel server(&m_events, &m_socketFactory, loopback(0), kRate);
+  String key;
+  UInt32 channel = server.open(key, NetworkAddress());
+  connect(server, channel, key);
+  dispatchUntil([&] { return server.isRegistered(channel); });
+  bool moved = false;
+  EXPECT_CALL(m_client, mouseMove(10, 20)).WillOnce(Invoke([&moved](SInt32, SInt32) { moved = true; }));
+
+  EXPECT_TRUE(server.send(MotionDatagram(channel, 1, MotionDatagram::kAbsolute, 10, 20)));
+  dispatchUntil([&] { return moved; });
+
+  EXPECT_TRUE(moved);
+}
+
+TEST_F(ServerMotionChannelTests, isRegistered_registrationMissed_tcpUsed)
+{
+  ServerMotionChannel server(&m_events, &m_socketFactory, loopback(0), kRate);
+  String key;
+  UInt32 channel = server.open(key, NetworkAddress());
+  connect(server, channel, key);
+  dispatchUntil([&] { return server.isRegistered(channel); });
+  ASSERT_TRUE(server.isRegistered(channel));
+
+  m_clientChannel.reset();
+  dispatchUntil([] { return false; }, kRate * 2);
+
+  EXPECT_FALSE(server.isRegistered(channel));
+}
+
+TEST_F(ServerMotionChannelTests, open_wildcardWithoutLocalAddress_notOpened)
+{
+  NetworkAddress any(ARCH->newAnyAddr(IArchNetwork::kINET));
+  ServerMotionChannel server(&m_events, &m_socketFactory, any, kRate);
+  String key;
+
+  EXPECT_EQ(0, server.open(key, NetworkAddress()));
+}
+
+TEST_F(ServerMotionChannelTests, send_wildcard_sentFromLocalAddress)
+{
+  NetworkAddress any(ARCH->newAnyAddr(IArchNetwork::kINET));
+  ServerMotionChannel server(&m_events, &m_socketFactory, any, kRate);
+  String key;
+  UInt32 channel = server.open(key, loopback(24800));
+  ASSERT_NE(0, channel);
+  connect(server, channel, key);
+  dispatchUntil([&] { return server.isRegistered(channel); });
+  bool moved = false;
+  EXPECT_CALL(m_client, mouseMove(10, 20)).WillOnce(Invoke([&moved](SInt32, SInt32) { moved = true; }));
+
+  // the client's socket only accepts datagrams from the address it sent to
+  server.send(MotionDatagram(channel, 1, MotionDatagram::kAbsolute, 10, 20));
+  dispatchUntil([&] { return moved; });
+
+  EXPECT_TRUE(moved);
+}
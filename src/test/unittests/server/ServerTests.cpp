@@ -1,7 +1,32 @@
+#include "test/mock/deskflow/MockAppUtil.h"
+#include "test/mock/deskflow/MockScreen.h"
+#include "test/mock/io/MockStream.h"
+#include "test/mock/server/MockClientProxy.h"
+#include "test/mock/server/MockPrimaryClient.h"
+
+#include "base/EventQueue.h"
+#include "base/Stopwatch.h"
+#include "deskflow/IKeyState.h"
+#include "deskflow/IPrimaryScreen.h"
+#include "deskflow/ServerArgs.h"
 #include "lib/server/Server.h"
+#include "mt/Thread.h"
+#include "server/Config.h"
+
+#include <memory>
+#include <vector>
 
+#include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+using testing::_;
+using testing::AtLeast;
+using testing::Contains;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+using testing::Sequence;
+
 TEST(ServerTests, SwitchToScreenInfo_alloc_screen)
 {
   auto info = Server::SwitchToScreenInfo::alloc("test");
@@ -16,3 +41,182 @@ TEST(ServerTests, KeyboardBroadcastInfo_alloc_stateAndSceens)
   EXPECT_EQ(info->m_state, Server::KeyboardBroadcastInfo::State::kOn);
   EXPECT_STREQ(info->m_screens, "test");
 }
+
+namespace {
+
+void getShape(SInt32 &x, SInt32 &y, SInt32 &width, SInt32 &height)
+{
+  x = 0;
+  y = 0;
+  width = 1920;
+  height = 1080;
+}
+
+void getCursorPos(SInt32 &x, SInt32 &y)
+{
+  x = 960;
+  y = 540;
+}
+
+bool getClipboard(ClipboardID, IClipboard *clipboard)
+{
+  clipboard->open(0);
+  clipboard->empty();
+  clipboard->add(IClipboard::kText, "clipboard");
+  clipboard->close();
+  return true;
+}
+
+// a server whose primary screen owns the clipboards and has a client
+class ServerClipboardTransferTests : public ::testing::Test
+{
+protected:
+  ServerClipboardTransferTests() : m_config(&m_events), m_primary("primary")
+  {
+    m_config.addScreen("primary");
+    m_config.addScreen("client");
+
+    ON_CALL(m_primary, getEventTarget()).WillByDefault(Return(&m_primary));
+    ON_CALL(m_primary, getShape(_, _, _, _)).WillByDefault(Invoke(getShape));
+    ON_CALL(m_primary, getCursorPos(_, _)).WillByDefault(Invoke(getCursorPos));
+    ON_CALL(m_primary, getClipboard(_, _)).WillByDefault(Invoke(getClipboard));
+    ON_CALL(m_primary, leave()).WillByDefault(Return(true));
+
+    // the server deletes the client and its stream
+    m_client = new NiceMock<MockClientProxy>("client", new NiceMock<MockStream>());
+    ON_CALL(*m_client, getShape(_, _, _, _)).WillByDefault(Invoke(getShape));
+    ON_CALL(*m_client, getCursorPos(_, _)).WillByDefault(Invoke(getCursorPos));
+    ON_CALL(*m_client, leave()).WillByDefault(Return(true));
+    ON_CALL(*m_client, setClipboard(_, _)).WillByDefault(Invoke([this](ClipboardID id, const IClipboard *) {
+      m_sent.push_back(id);
+    }));
+
+    // hold no events until the loop starts, like the server does
+    m_events.addEvent(Event(Event::kQuit));
+    m_events.loop();
+
+    m_server.reset(new Server(m_config, &m_primary, &m_screen, &m_events, m_args));
+    m_server->adoptClient(m_client);
+  }
+
+  ~ServerClipboardTransferTests() override
+  {
+    // a client that's closed while active makes the server read the
+    // primary screen, which these tests don't have
+    if (m_onClient) {
+      switchTo("primary");
+    }
+  }
+
+  void switchTo(const char *screen)
+  {
+    m_switched = false;
+    m_onClient = (String(screen) == "client");
+    addEvent(m_events.forServer().switchToScreen(), Server::SwitchToScreenInfo::alloc(screen));
+    dispatchUntil([this] { return m_switched; });
+  }
+
+  void addEvent(Event::Type type, void *data)
+  {
+    m_events.addEvent(Event(type, m_config.getInputFilter(), data));
+  }
+
+  // dispatches events for less time than the transfer delay
+  void dispatchPending()
+  {
+    dispatchUntil([] { return false; }, 0.05);
+  }
+
+  // dispatches events until \p done returns true or \p timeout has passed
+  template <typename Done> void dispatchUntil(Done done, double timeout = 1.0)
+  {
+    Stopwatch stopwatch;
+    while (!done() && stopwatch.getTime() < timeout) {
+      Event event;
+      if (m_events.getEvent(event, 0.01)) {
+        m_switched = m_switched || event.getType() == m_events.forServer().screenSwitched();
+        m_events.dispatchEvent(event);
+        Event::deleteData(event);
+      }
+    }
+  }
+
+  EventQueue m_events;
+  NiceMock<MockAppUtil> m_appUtil;
+  deskflow::server::Config m_config;
+  NiceMock<MockScreen> m_screen;
+  NiceMock<MockPrimaryClient> m_primary;
+  deskflow::ServerArgs m_args;
+  NiceMock<MockClientProxy> *m_client;
+  std::unique_ptr<Server> m_server;
+  std::vector<ClipboardID> m_sent;
+  bool m_switched = false;
+  bool m_onClient = false;
+};
+
+} // namespace
+
+TEST_F(ServerClipboardTransferTests, switchScreen_enter_clipboardsDeferred)
+{
+  EXPECT_CALL(*m_client, enter(_, _, _, _, false));
+
+  switchTo("client");
+
+  EXPECT_TRUE(m_sent.empty());
+}
+
+TEST_F(ServerClipboardTransferTests, switchScreen_timerExpired_clipboardsSent)
+{
+  switchTo("client");
+  Stopwatch stopwatch;
+
+  dispatchUntil([this] { return !m_sent.empty(); });
+
+  EXPECT_GE(stopwatch.getTime(), 0.2);
+  EXPECT_THAT(m_sent, Contains(kClipboardClipboard));
+  EXPECT_THAT(m_sent, Contains(kClipboardSelection));
+}
+
+TEST_F(ServerClipboardTransferTests, switchScreen_backBeforeTimer_nothingSent)
+{
+  switchTo("client");
+  switchTo("primary");
+
+  dispatchUntil([] { return false; }, 0.5);
+
+  EXPECT_TRUE(m_sent.empty());
+}
+
+TEST_F(ServerClipboardTransferTests, keyDown_transferPending_clipboardsSentFirst)
+{
+  switchTo("client");
+  Sequence sequence;
+  EXPECT_CALL(*m_client, setClipboard(_, _)).Times(AtLeast(1)).InSequence(sequence);
+  EXPECT_CALL(*m_client, keyDown(_, _, _, _)).InSequence(sequence);
+
+  addEvent(m_events.forIKeyState().keyDown(), IKeyState::KeyInfo::alloc('v', 0, 0x2f, 1));
+  dispatchPending();
+}
+
+TEST_F(ServerClipboardTransferTests, mouseDown_transferPending_clipboardsSentFirst)
+{
+  switchTo("client");
+  Sequence sequence;
+  EXPECT_CALL(*m_client, setClipboard(_, _)).Times(AtLeast(1)).InSequence(sequence);
+  EXPECT_CALL(*m_client, mouseDown(kButtonLeft)).InSequence(sequence);
+
+  addEvent(m_events.forIPrimaryScreen().buttonDown(), IPrimaryScreen::ButtonInfo::alloc(kButtonLeft, 0));
+  dispatchPending();
+}
+
+TEST_F(ServerClipboardTransferTests, keyDown_transferSent_notSentAgain)
+{
+  switchTo("client");
+  dispatchUntil([this] { return !m_sent.empty(); });
+  m_sent.clear();
+
+  addEvent(m_events.forIKeyState().keyDown(), IKeyState::KeyInfo::alloc('v', 0, 0x2f, 1));
+  dispatchPending();
+
+  EXPECT_TRUE(m_sent.empty());
+}